@@ -97,6 +97,8 @@ struct Args
     bool help{false};
     int useDLACore{-1};
     std::vector<std::string> dataDirs;
+    std::string exportTimes; //!< File to export timings to, see BenchmarkResults. Empty to disable.
+    std::string engineCache; //!< Directory of cached engines, see EngineCache. Empty to disable.
 };
 
 //!
@@ -117,6 +119,8 @@ inline bool parseArgs(Args& args, int argc, char* argv[])
             {"int8", no_argument, 0, 'i'},
             {"fp16", no_argument, 0, 'f'},
             {"useDLACore", required_argument, 0, 'u'},
+            {"exportTimes", required_argument, 0, 'e'},
+            {"engineCache", required_argument, 0, 'c'},
             {nullptr, 0, nullptr, 0}};
         int option_index = 0;
         arg = getopt_long(argc, argv, "hd:iu", long_options, &option_index);
@@ -147,6 +151,14 @@ inline bool parseArgs(Args& args, int argc, char* argv[])
             if (optarg)
                 args.useDLACore = std::stoi(optarg);
             break;
+        case 'e':
+            if (optarg)
+                args.exportTimes = optarg;
+            break;
+        case 'c':
+            if (optarg)
+                args.engineCache = optarg;
+            break;
         default:
             return false;
         }
@@ -0,0 +1,178 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_BATCH_SWEEP_H
+#define TENSORRT_BATCH_SWEEP_H
+
+#include "jsonUtils.h"
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \brief Result of benchmarking one batch size.
+//!
+struct BatchSweepPoint
+{
+    int batchSize{0};
+    double imagesPerSecond{0};
+    double p50Ms{0};           //!< Median latency of one batch.
+    double p99Ms{0};           //!< 99th percentile latency of one batch.
+    bool paretoOptimal{false}; //!< No other point is at least as good in throughput and p99 and strictly better in one.
+};
+
+//!
+//! \brief Set BatchSweepPoint::paretoOptimal on the points that are not dominated by another point.
+//!
+//! \details A point is dominated when another one is at least as good in both throughput and p99 latency and
+//!          strictly better in one of them. Among identical points, all are kept.
+//!
+inline void markParetoFrontier(std::vector<BatchSweepPoint>& points)
+{
+    for (auto& p : points)
+    {
+        p.paretoOptimal = true;
+        for (const auto& q : points)
+        {
+            bool noWorse = q.imagesPerSecond >= p.imagesPerSecond && q.p99Ms <= p.p99Ms;
+            bool better = q.imagesPerSecond > p.imagesPerSecond || q.p99Ms < p.p99Ms;
+            if (noWorse && better)
+            {
+                p.paretoOptimal = false;
+                break;
+            }
+        }
+    }
+}
+
+//!
+//! \class BatchSweep
+//! \brief Benchmarks a list of batch sizes with the same callback and computes the throughput/latency frontier.
+//!
+class BatchSweep
+{
+public:
+    //!
+    //! \brief Benchmark batchSize and fill in throughput and latencies. Returns false to abort the sweep.
+    //!
+    using Benchmark = std::function<bool(int batchSize, BatchSweepPoint& point)>;
+
+    explicit BatchSweep(const std::vector<int>& batchSizes)
+        : mBatchSizes(batchSizes)
+    {
+    }
+
+    //!
+    //! \brief Run benchmark for every batch size in order, then mark the Pareto frontier.
+    //!
+    //! \return false if a benchmark failed; the points measured until then are kept.
+    //!
+    bool run(const Benchmark& benchmark)
+    {
+        mPoints.clear();
+        for (int batchSize : mBatchSizes)
+        {
+            BatchSweepPoint point;
+            if (!benchmark(batchSize, point))
+            {
+                markParetoFrontier(mPoints);
+                return false;
+            }
+            point.batchSize = batchSize;
+            mPoints.push_back(point);
+        }
+        markParetoFrontier(mPoints);
+        return true;
+    }
+
+    const std::vector<BatchSweepPoint>& getPoints() const { return mPoints; }
+
+    //!
+    //! \brief Print one row per batch size, with Pareto-optimal rows marked by '*'.
+    //!
+    void writeTable(std::ostream& out) const
+    {
+        out << std::setw(8) << "batch" << std::setw(14) << "images/s" << std::setw(12) << "p50 ms" << std::setw(12)
+            << "p99 ms" << std::setw(8) << "pareto" << std::endl;
+        for (const auto& p : mPoints)
+        {
+            out << std::setw(8) << p.batchSize << std::setw(14) << p.imagesPerSecond << std::setw(12) << p.p50Ms
+                << std::setw(12) << p.p99Ms << std::setw(8) << (p.paretoOptimal ? "*" : "") << std::endl;
+        }
+    }
+
+    void writeJson(std::ostream& out) const
+    {
+        out << "[";
+        for (size_t i = 0; i < mPoints.size(); i++)
+        {
+            const BatchSweepPoint& p = mPoints[i];
+            out << (i ? ",\n" : "\n") << "{\"batch\":" << p.batchSize << ",\"imagesPerSecond\":";
+            jsonNumber(out, p.imagesPerSecond);
+            out << ",\"p50Ms\":";
+            jsonNumber(out, p.p50Ms);
+            out << ",\"p99Ms\":";
+            jsonNumber(out, p.p99Ms);
+            out << ",\"paretoOptimal\":" << (p.paretoOptimal ? "true" : "false") << "}";
+        }
+        out << "\n]\n";
+    }
+
+private:
+    std::vector<int> mBatchSizes;
+    std::vector<BatchSweepPoint> mPoints;
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_BATCH_SWEEP_H
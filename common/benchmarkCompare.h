@@ -0,0 +1,524 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_BENCHMARK_COMPARE_H
+#define TENSORRT_BENCHMARK_COMPARE_H
+
+#include "jsonUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \brief One metric of a result file written by BenchmarkResults.
+//!
+struct MetricSamples
+{
+    std::string unit;
+    std::vector<double> samples;
+};
+
+//! Metrics by name.
+using MetricMap = std::map<std::string, MetricSamples>;
+
+namespace detail
+{
+
+//! Parse the JSON string literal starting at s[pos], which must be a '"'; pos is left after the closing quote.
+inline bool parseJsonString(const std::string& s, size_t& pos, std::string& value)
+{
+    if (pos >= s.size() || s[pos] != '"')
+        return false;
+    value.clear();
+    for (++pos; pos < s.size(); ++pos)
+    {
+        char c = s[pos];
+        if (c == '"')
+        {
+            ++pos;
+            return true;
+        }
+        if (c != '\\')
+        {
+            value += c;
+            continue;
+        }
+        if (++pos == s.size())
+            return false;
+        switch (s[pos])
+        {
+        case 'n': value += '\n'; break;
+        case 'r': value += '\r'; break;
+        case 't': value += '\t'; break;
+        case 'u':
+            // Only control characters are escaped this way by jsonString.
+            if (pos + 4 >= s.size())
+                return false;
+            value += static_cast<char>(std::strtol(s.substr(pos + 1, 4).c_str(), nullptr, 16));
+            pos += 4;
+            break;
+        default: value += s[pos];
+        }
+    }
+    return false;
+}
+
+//! Returns the position just after "key": in a JSON object line, or npos.
+inline size_t findJsonKey(const std::string& line, const std::string& key)
+{
+    const std::string quoted = jsonString(key);
+    size_t pos = line.find(quoted);
+    if (pos == std::string::npos)
+        return pos;
+    pos = line.find_first_not_of(" \t", pos + quoted.size());
+    if (pos == std::string::npos || line[pos] != ':')
+        return std::string::npos;
+    pos = line.find_first_not_of(" \t", pos + 1);
+    return pos == std::string::npos ? line.size() : pos;
+}
+
+//! Split one CSV line into fields, honouring double quotes.
+inline std::vector<std::string> splitCsv(const std::string& line)
+{
+    std::vector<std::string> fields(1);
+    bool quoted{false};
+    for (size_t i = 0; i < line.size(); i++)
+    {
+        char c = line[i];
+        if (quoted && c == '"' && i + 1 < line.size() && line[i + 1] == '"')
+        {
+            fields.back() += '"';
+            ++i;
+        }
+        else if (c == '"')
+            quoted = !quoted;
+        else if (c == ',' && !quoted)
+            fields.emplace_back();
+        else if (c != '\r' || quoted)
+            fields.back() += c;
+    }
+    return fields;
+}
+
+} // namespace detail
+
+//!
+//! \brief Load the metrics of a BenchmarkResults file, in JSON Lines or CSV format depending on its first line.
+//!
+//! \return false with a description in error if the file cannot be read or holds no metrics.
+//!
+inline bool loadBenchmarkResults(const std::string& fileName, MetricMap& metrics, std::string& error)
+{
+    metrics.clear();
+    std::ifstream in(fileName);
+    if (!in)
+    {
+        error = "cannot open " + fileName;
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(in, line))
+    {
+        error = fileName + " is empty";
+        return false;
+    }
+
+    const bool isCsv = line.compare(0, 10, "benchmark,") == 0;
+    int lineNumber{1};
+    do
+    {
+        if (isCsv)
+        {
+            if (lineNumber == 1 || line.empty())
+                continue;
+            // benchmark,metric,unit,engineHash,index,value[,parameters...]
+            std::vector<std::string> fields = detail::splitCsv(line);
+            if (fields.size() < 6)
+            {
+                error = fileName + ":" + std::to_string(lineNumber) + ": expected at least 6 fields";
+                return false;
+            }
+            MetricSamples& m = metrics[fields[1]];
+            m.unit = fields[2];
+            m.samples.push_back(std::strtod(fields[5].c_str(), nullptr));
+            continue;
+        }
+
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+        std::string name, unit;
+        size_t namePos = detail::findJsonKey(line, "metric");
+        size_t unitPos = detail::findJsonKey(line, "unit");
+        size_t samplesPos = detail::findJsonKey(line, "samples");
+        if (namePos == std::string::npos || unitPos == std::string::npos || samplesPos == std::string::npos
+            || !detail::parseJsonString(line, namePos, name) || !detail::parseJsonString(line, unitPos, unit)
+            || samplesPos >= line.size() || line[samplesPos] != '[')
+        {
+            error = fileName + ":" + std::to_string(lineNumber) + ": not a benchmark result";
+            return false;
+        }
+        MetricSamples& m = metrics[name];
+        m.unit = unit;
+        const size_t end = line.find(']', samplesPos);
+        std::istringstream values(line.substr(samplesPos + 1, end - samplesPos - 1));
+        std::string value;
+        while (std::getline(values, value, ','))
+        {
+            // Non-finite samples are written as null and carry no information.
+            if (value.find("null") == std::string::npos && value.find_first_of("0123456789") != std::string::npos)
+                m.samples.push_back(std::strtod(value.c_str(), nullptr));
+        }
+    } while (++lineNumber, std::getline(in, line));
+
+    if (metrics.empty())
+    {
+        error = fileName + " holds no metrics";
+        return false;
+    }
+    return true;
+}
+
+//!
+//! \brief Returns the q-quantile (0 <= q <= 1) of v by linear interpolation between closest ranks. Reorders v.
+//!
+inline double quantile(std::vector<double>& v, double q)
+{
+    if (v.empty())
+        return 0.0;
+    const double rank = q * (v.size() - 1);
+    const size_t lo = static_cast<size_t>(std::floor(rank));
+    std::nth_element(v.begin(), v.begin() + lo, v.end());
+    const double low = v[lo];
+    if (lo + 1 >= v.size())
+        return low;
+    const double high = *std::min_element(v.begin() + lo + 1, v.end());
+    return low + (rank - lo) * (high - low);
+}
+
+//!
+//! \brief Two-sided p-value of the Mann-Whitney U test that a and b come from the same distribution.
+//!
+//! \details Uses the normal approximation with tie correction, which is accurate for about 10 samples per side
+//!          and more. Returns 1 if either side is empty or all values are tied.
+//!
+inline double mannWhitneyP(const std::vector<double>& a, const std::vector<double>& b)
+{
+    const double n1 = static_cast<double>(a.size());
+    const double n2 = static_cast<double>(b.size());
+    if (a.empty() || b.empty())
+        return 1.0;
+
+    std::vector<std::pair<double, int>> all;
+    all.reserve(a.size() + b.size());
+    for (double v : a)
+        all.emplace_back(v, 0);
+    for (double v : b)
+        all.emplace_back(v, 1);
+    std::sort(all.begin(), all.end());
+
+    double rankSumA{0}, tieTerm{0};
+    for (size_t i = 0; i < all.size();)
+    {
+        size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first)
+            ++j;
+        const double t = static_cast<double>(j - i);
+        const double midRank = (i + 1 + j) / 2.0;
+        for (size_t k = i; k < j; k++)
+        {
+            if (all[k].second == 0)
+                rankSumA += midRank;
+        }
+        tieTerm += t * t * t - t;
+        i = j;
+    }
+
+    const double n = n1 + n2;
+    const double u = rankSumA - n1 * (n1 + 1) / 2;
+    const double variance = n1 * n2 / 12.0 * ((n + 1) - tieTerm / (n * (n - 1)));
+    if (variance <= 0)
+        return 1.0;
+    const double z = (std::abs(u - n1 * n2 / 2) - 0.5) / std::sqrt(variance);
+    return std::min(1.0, std::erfc(std::max(z, 0.0) / std::sqrt(2.0)));
+}
+
+//!
+//! \brief Bootstrap confidence interval of the relative change stat(candidate) / stat(baseline) - 1.
+//!
+//! \param stat Quantile compared, e.g. 0.5 for the median; a negative value compares the means.
+//! \param confidence Two-sided confidence level, e.g. 0.95.
+//!
+inline void bootstrapRelativeChange(const std::vector<double>& baseline, const std::vector<double>& candidate, double stat,
+                                    int resamples, double confidence, double& low, double& high)
+{
+    // A fixed seed makes repeated comparisons of the same files give the same verdict.
+    std::mt19937_64 rng(0x5eed);
+    auto statistic = [stat](std::vector<double>& v) {
+        if (stat < 0)
+        {
+            double sum{0};
+            for (double x : v)
+                sum += x;
+            return sum / v.size();
+        }
+        return quantile(v, stat);
+    };
+
+    std::vector<double> changes;
+    changes.reserve(resamples);
+    std::vector<double> a(baseline.size()), b(candidate.size());
+    std::uniform_int_distribution<size_t> pickA(0, baseline.size() - 1), pickB(0, candidate.size() - 1);
+    for (int r = 0; r < resamples; r++)
+    {
+        for (auto& x : a)
+            x = baseline[pickA(rng)];
+        for (auto& x : b)
+            x = candidate[pickB(rng)];
+        const double base = statistic(a);
+        if (base != 0)
+            changes.push_back(statistic(b) / base - 1);
+    }
+    const double tail = (1 - confidence) / 2;
+    low = quantile(changes, tail);
+    high = quantile(changes, 1 - tail);
+}
+
+//!
+//! \brief Comparison of one statistic of a metric between a baseline and a candidate run.
+//!
+struct MetricComparison
+{
+    enum class Verdict
+    {
+        kUNCHANGED,
+        kIMPROVED,
+        kREGRESSED,
+    };
+
+    std::string metric;
+    std::string statistic; //!< "p50", "p99" or "mean" of the samples, or "value" for single-valued metrics
+    std::string unit;
+    bool higherIsBetter{false};
+    size_t baselineCount{0};
+    size_t candidateCount{0};
+    double baseline{0};
+    double candidate{0};
+    double change{0};      //!< Relative change, candidate / baseline - 1
+    bool hasInterval{false};
+    double changeLow{0};   //!< Bootstrap confidence interval of change, if hasInterval
+    double changeHigh{0};
+    double pValue{1};      //!< Mann-Whitney p-value of the whole sample distributions, if hasInterval
+    Verdict verdict{Verdict::kUNCHANGED};
+};
+
+//!
+//! \brief Settings of compareBenchmarkResults.
+//!
+struct CompareOptions
+{
+    double threshold{0.05};  //!< Smallest relative change that counts as a regression or improvement
+    double confidence{0.95}; //!< Confidence level of the bootstrap intervals
+    int resamples{2000};     //!< Bootstrap resamples per statistic
+};
+
+//!
+//! \brief Compare the latency and throughput metrics present in both result sets.
+//!
+//! \details Metrics in ms are compared by their p50 and p99, metrics in a unit per second by their mean. A change
+//!          counts as a regression or improvement when it exceeds the threshold and, for metrics with at least two
+//!          samples per run, when the whole bootstrap confidence interval lies beyond zero. Single-valued metrics
+//!          such as the summaries written for multi-stream runs have no interval; only their .p50 and .p99 values and
+//!          throughputs are compared, against the threshold alone.
+//!
+inline std::vector<MetricComparison> compareBenchmarkResults(const MetricMap& baseline, const MetricMap& candidate,
+                                                             const CompareOptions& options)
+{
+    auto endsWith = [](const std::string& s, const std::string& suffix) {
+        return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+
+    std::vector<MetricComparison> comparisons;
+    for (const auto& base : baseline)
+    {
+        auto cand = candidate.find(base.first);
+        if (cand == candidate.end() || base.second.samples.empty() || cand->second.samples.empty())
+            continue;
+
+        const std::string& unit = base.second.unit;
+        const bool isRate = endsWith(unit, "/s");
+        if (!isRate && unit != "ms")
+            continue;
+
+        std::vector<double> a = base.second.samples;
+        std::vector<double> b = cand->second.samples;
+        const bool sampled = a.size() > 1 && b.size() > 1;
+        if (!sampled && !isRate && !endsWith(base.first, ".p50") && !endsWith(base.first, ".p99"))
+            continue;
+
+        std::vector<std::pair<std::string, double>> statistics;
+        if (!sampled)
+            statistics.emplace_back("value", -1.0);
+        else if (isRate)
+            statistics.emplace_back("mean", -1.0);
+        else
+        {
+            statistics.emplace_back("p50", 0.5);
+            statistics.emplace_back("p99", 0.99);
+        }
+
+        const double pValue = sampled ? mannWhitneyP(a, b) : 1.0;
+        for (const auto& s : statistics)
+        {
+            MetricComparison c;
+            c.metric = base.first;
+            c.statistic = s.first;
+            c.unit = unit;
+            c.higherIsBetter = isRate;
+            c.baselineCount = a.size();
+            c.candidateCount = b.size();
+            if (s.second < 0)
+            {
+                double sumA{0}, sumB{0};
+                for (double x : a)
+                    sumA += x;
+                for (double x : b)
+                    sumB += x;
+                c.baseline = sumA / a.size();
+                c.candidate = sumB / b.size();
+            }
+            else
+            {
+                c.baseline = quantile(a, s.second);
+                c.candidate = quantile(b, s.second);
+            }
+            c.change = c.baseline != 0 ? c.candidate / c.baseline - 1 : 0.0;
+
+            const double worse = isRate ? -c.change : c.change;
+            bool significant = std::abs(c.change) > options.threshold;
+            if (sampled)
+            {
+                c.hasInterval = true;
+                c.pValue = pValue;
+                bootstrapRelativeChange(a, b, s.second, options.resamples, options.confidence, c.changeLow, c.changeHigh);
+                significant = significant && (c.changeLow > 0 || c.changeHigh < 0);
+            }
+            if (significant)
+                c.verdict = worse > 0 ? MetricComparison::Verdict::kREGRESSED : MetricComparison::Verdict::kIMPROVED;
+            comparisons.push_back(c);
+        }
+    }
+    return comparisons;
+}
+
+//!
+//! \brief Returns how many of comparisons have the given verdict; trtcompare fails when any regressed.
+//!
+inline int countVerdicts(const std::vector<MetricComparison>& comparisons, MetricComparison::Verdict verdict)
+{
+    return static_cast<int>(std::count_if(comparisons.begin(), comparisons.end(),
+        [verdict](const MetricComparison& c) { return c.verdict == verdict; }));
+}
+
+inline const char* verdictName(MetricComparison::Verdict verdict)
+{
+    switch (verdict)
+    {
+    case MetricComparison::Verdict::kUNCHANGED: return "";
+    case MetricComparison::Verdict::kIMPROVED: return "improved";
+    case MetricComparison::Verdict::kREGRESSED: return "REGRESSED";
+    }
+    return "";
+}
+
+//!
+//! \brief Print one row per comparison: values, relative change with its confidence interval, p-value and verdict.
+//!
+inline void writeComparisonTable(std::ostream& out, const std::vector<MetricComparison>& comparisons)
+{
+    auto oldFlags = out.flags();
+    auto oldPrecision = out.precision();
+    out << std::left << std::setw(36) << "metric" << std::right << std::setw(7) << "stat" << std::setw(14) << "baseline"
+        << std::setw(14) << "candidate" << std::setw(10) << "change" << std::setw(22) << "interval" << std::setw(10)
+        << "p" << "  verdict" << std::endl;
+    for (const auto& c : comparisons)
+    {
+        std::ostringstream change, interval;
+        change << std::fixed << std::setprecision(2) << std::showpos << c.change * 100 << "%";
+        if (c.hasInterval)
+            interval << std::fixed << std::setprecision(2) << std::showpos << "[" << c.changeLow * 100 << "%, "
+                     << c.changeHigh * 100 << "%]";
+        out << std::left << std::setw(36) << c.metric << std::right << std::setw(7) << c.statistic << std::setw(14)
+            << std::setprecision(6) << c.baseline << std::setw(14) << c.candidate << std::setw(10) << change.str()
+            << std::setw(22) << interval.str() << std::setw(10);
+        if (c.hasInterval)
+            out << std::setprecision(3) << c.pValue;
+        else
+            out << "";
+        out << "  " << verdictName(c.verdict) << std::endl;
+    }
+    out.flags(oldFlags);
+    out.precision(oldPrecision);
+}
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_BENCHMARK_COMPARE_H
@@ -0,0 +1,290 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_BENCHMARK_RESULTS_H
+#define TENSORRT_BENCHMARK_RESULTS_H
+
+#include "jsonUtils.h"
+#include "latencyHistogram.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \class BenchmarkResults
+//! \brief Collects timing metrics in structured form so they can be exported instead of scraped from logs.
+//!
+//! \details Each metric has a name, a unit and one sample per iteration, and is tagged with the engine hash that
+//!          was current when it was created. Build and run parameters apply to the whole result set.
+//!          Results are written either as JSON Lines (one object per metric) or as CSV (one row per sample).
+//!
+class BenchmarkResults
+{
+public:
+    enum class Format
+    {
+        kJSON_LINES,
+        kCSV
+    };
+
+    struct Metric
+    {
+        std::string name;
+        std::string unit;
+        std::string engineHash;
+        std::vector<double> samples;
+    };
+
+    explicit BenchmarkResults(const std::string& benchmarkName)
+        : mBenchmarkName(benchmarkName)
+    {
+    }
+
+    //!
+    //! \brief Record a build or run parameter. Setting the same name again overwrites the value.
+    //!
+    void setParameter(const std::string& name, const std::string& value)
+    {
+        for (auto& p : mParameters)
+        {
+            if (p.first == name)
+            {
+                p.second = value;
+                return;
+            }
+        }
+        mParameters.emplace_back(name, value);
+    }
+
+    template <typename T>
+    void setParameter(const std::string& name, const T& value)
+    {
+        std::ostringstream ss;
+        ss << std::boolalpha << value;
+        setParameter(name, ss.str());
+    }
+
+    //!
+    //! \brief Set the hash of the engine that metrics created from now on were measured with.
+    //!
+    void setEngineHash(const std::string& engineHash) { mEngineHash = engineHash; }
+
+    //!
+    //! \brief Prepend prefix to the names of the metrics added from now on, e.g. to keep the runs of a sweep apart.
+    //!
+    void setMetricPrefix(const std::string& prefix) { mMetricPrefix = prefix; }
+
+    //!
+    //! \brief Append one sample to the metric name, creating it with the given unit if needed.
+    //!
+    void addSample(const std::string& name, const std::string& unit, double value)
+    {
+        getMetric(name, unit).samples.push_back(value);
+    }
+
+    //!
+    //! \brief Record the summary statistics of a histogram as metrics name.min, name.mean, ... name.max.
+    //!
+    void addSummary(const std::string& name, const LatencyHistogram& h)
+    {
+        addSample(name + ".count", "samples", static_cast<double>(h.count()));
+        addSample(name + ".min", "ms", h.min());
+        addSample(name + ".mean", "ms", h.mean());
+        addSample(name + ".stddev", "ms", h.stddev());
+        addSample(name + ".p50", "ms", h.percentile(50));
+        addSample(name + ".p90", "ms", h.percentile(90));
+        addSample(name + ".p95", "ms", h.percentile(95));
+        addSample(name + ".p99", "ms", h.percentile(99));
+        addSample(name + ".p99.9", "ms", h.percentile(99.9));
+        addSample(name + ".max", "ms", h.max());
+    }
+
+    const std::vector<Metric>& getMetrics() const { return mMetrics; }
+
+    //!
+    //! \brief Returns kCSV for file names ending in .csv and kJSON_LINES otherwise.
+    //!
+    static Format formatFromFileName(const std::string& fileName)
+    {
+        const std::string ext = ".csv";
+        bool isCsv = fileName.size() >= ext.size()
+            && std::equal(ext.rbegin(), ext.rend(), fileName.rbegin(), [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); });
+        return isCsv ? Format::kCSV : Format::kJSON_LINES;
+    }
+
+    //!
+    //! \brief Write all metrics to fileName, in the format selected by its extension.
+    //!
+    bool write(const std::string& fileName) const
+    {
+        std::ofstream out(fileName);
+        if (!out)
+            return false;
+        write(out, formatFromFileName(fileName));
+        return static_cast<bool>(out);
+    }
+
+    void write(std::ostream& out, Format format) const
+    {
+        auto oldPrecision = out.precision(std::numeric_limits<double>::digits10 + 2);
+        if (format == Format::kCSV)
+            writeCsv(out);
+        else
+            writeJsonLines(out);
+        out.precision(oldPrecision);
+    }
+
+private:
+    Metric& getMetric(const std::string& unprefixedName, const std::string& unit)
+    {
+        const std::string name = mMetricPrefix + unprefixedName;
+        auto it = mMetricIndices.find(name);
+        if (it != mMetricIndices.end())
+            return mMetrics[it->second];
+        mMetricIndices[name] = mMetrics.size();
+        mMetrics.push_back(Metric{name, unit, mEngineHash, {}});
+        return mMetrics.back();
+    }
+
+    static std::string csvField(const std::string& s)
+    {
+        if (s.find_first_of(",\"\n") == std::string::npos)
+            return s;
+        std::string quoted = "\"";
+        for (char c : s)
+        {
+            if (c == '"')
+                quoted += '"';
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    void writeJsonLines(std::ostream& out) const
+    {
+        std::string parameters = "{";
+        for (size_t i = 0; i < mParameters.size(); i++)
+        {
+            parameters += (i ? "," : "") + jsonString(mParameters[i].first) + ":" + jsonString(mParameters[i].second);
+        }
+        parameters += "}";
+
+        for (const auto& m : mMetrics)
+        {
+            double sum{0}, minV{0}, maxV{0};
+            if (!m.samples.empty())
+            {
+                sum = std::accumulate(m.samples.begin(), m.samples.end(), 0.0);
+                minV = *std::min_element(m.samples.begin(), m.samples.end());
+                maxV = *std::max_element(m.samples.begin(), m.samples.end());
+            }
+            out << "{\"benchmark\":" << jsonString(mBenchmarkName) << ",\"metric\":" << jsonString(m.name)
+                << ",\"unit\":" << jsonString(m.unit) << ",\"engineHash\":" << jsonString(m.engineHash)
+                << ",\"count\":" << m.samples.size() << ",\"mean\":";
+            jsonNumber(out, m.samples.empty() ? 0.0 : sum / m.samples.size());
+            out << ",\"min\":";
+            jsonNumber(out, minV);
+            out << ",\"max\":";
+            jsonNumber(out, maxV);
+            out << ",\"samples\":[";
+            for (size_t i = 0; i < m.samples.size(); i++)
+            {
+                if (i)
+                    out << ",";
+                jsonNumber(out, m.samples[i]);
+            }
+            out << "],\"parameters\":" << parameters << "}\n";
+        }
+    }
+
+    void writeCsv(std::ostream& out) const
+    {
+        out << "benchmark,metric,unit,engineHash,index,value";
+        for (const auto& p : mParameters)
+            out << "," << csvField(p.first);
+        out << "\n";
+
+        std::string parameters;
+        for (const auto& p : mParameters)
+            parameters += "," + csvField(p.second);
+
+        for (const auto& m : mMetrics)
+        {
+            for (size_t i = 0; i < m.samples.size(); i++)
+            {
+                out << csvField(mBenchmarkName) << "," << csvField(m.name) << "," << csvField(m.unit) << ","
+                    << m.engineHash << "," << i << "," << m.samples[i] << parameters << "\n";
+            }
+        }
+    }
+
+    std::string mBenchmarkName;
+    std::string mEngineHash;
+    std::string mMetricPrefix;
+    std::vector<std::pair<std::string, std::string>> mParameters;
+    std::vector<Metric> mMetrics;
+    std::map<std::string, size_t> mMetricIndices;
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_BENCHMARK_RESULTS_H
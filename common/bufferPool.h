@@ -0,0 +1,282 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_BUFFER_POOL_H
+#define TENSORRT_BUFFER_POOL_H
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \brief Counters of a BufferPool. Sizes are in bytes and counted after rounding up to the size class.
+//!
+struct BufferPoolStats
+{
+    size_t allocations{0};       //!< Successful allocate() calls
+    size_t hits{0};              //!< Allocations served from a free block instead of the backing allocator
+    size_t bytesInUse{0};        //!< Bytes handed out and not released yet
+    size_t peakBytesInUse{0};    //!< Maximum of bytesInUse
+    size_t bytesCached{0};       //!< Bytes in free blocks kept for reuse
+    size_t peakBytesReserved{0}; //!< Maximum of bytesInUse + bytesCached, the footprint of the pool
+    size_t blocksFreed{0};       //!< Free blocks returned to the backing allocator by the cap or trim()
+
+    double hitRate() const
+    {
+        return allocations ? static_cast<double>(hits) / allocations : 0.0;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const BufferPoolStats& stats)
+{
+    return os << stats.allocations << " allocations, " << 100.0 * stats.hitRate() << "% reused, "
+              << stats.bytesInUse << " bytes in use (peak " << stats.peakBytesInUse << "), " << stats.bytesCached
+              << " bytes cached, peak footprint " << stats.peakBytesReserved << " bytes";
+}
+
+//!
+//! \class BufferPool
+//! \brief Thread-safe pool that keeps released blocks in per-size-class free lists for reuse.
+//!
+//! \details Requests are rounded up to a size class: 256 bytes, then four classes per power of two, so at most a
+//!          quarter of a block is wasted and a buffer whose size varies a little with the batch or the input still
+//!          finds a free block. Blocks come from AllocFunc and go back to FreeFunc, which have the same signatures
+//!          as for GenericBuffer, so the same pool works for host and device memory.
+//!
+//!          At most maxCachedBytes are kept in free blocks; beyond that the largest free blocks are freed on
+//!          release. If the backing allocator fails, the free blocks are trimmed and the allocation retried once.
+//!          Blocks still in use when the pool is destroyed are not freed.
+//!
+template <typename AllocFunc, typename FreeFunc>
+class BufferPool
+{
+public:
+    static const size_t kUNLIMITED = ~size_t(0);
+    static const size_t kMIN_BLOCK_SIZE = 256;
+
+    explicit BufferPool(size_t maxCachedBytes = kUNLIMITED, AllocFunc allocFunc = AllocFunc(), FreeFunc freeFunc = FreeFunc())
+        : mMaxCachedBytes(maxCachedBytes)
+        , allocFn(allocFunc)
+        , freeFn(freeFunc)
+    {
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    ~BufferPool()
+    {
+        trim();
+    }
+
+    //!
+    //! \brief A process-wide pool, destroyed at exit.
+    //!
+    static BufferPool& instance()
+    {
+        static BufferPool pool;
+        return pool;
+    }
+
+    //!
+    //! \brief The size of the blocks that serve requests of size bytes.
+    //!
+    static size_t sizeClass(size_t size)
+    {
+        if (size <= kMIN_BLOCK_SIZE)
+            return kMIN_BLOCK_SIZE;
+        size_t base = kMIN_BLOCK_SIZE;
+        while (base <= (size - 1) / 2)
+            base *= 2;
+        size_t step = base / 4;
+        return (size + step - 1) / step * step;
+    }
+
+    //!
+    //! \brief Return a block of at least size bytes, reusing a free one of the same size class if possible.
+    //!        Returns nullptr on failure.
+    //!
+    void* allocate(size_t size)
+    {
+        size_t bytes = sizeClass(size);
+        std::lock_guard<std::mutex> lock(mMutex);
+        void* ptr = nullptr;
+        auto it = mFree.find(bytes);
+        if (it != mFree.end() && !it->second.empty())
+        {
+            ptr = it->second.back();
+            it->second.pop_back();
+            mStats.bytesCached -= bytes;
+            ++mStats.hits;
+        }
+        else if (!allocFn(&ptr, bytes))
+        {
+            trimLocked(0);
+            if (!allocFn(&ptr, bytes))
+                return nullptr;
+        }
+        mInUse[ptr] = bytes;
+        ++mStats.allocations;
+        mStats.bytesInUse += bytes;
+        updatePeaks();
+        return ptr;
+    }
+
+    //!
+    //! \brief Return a block obtained from allocate() to the pool. nullptr and unknown pointers are ignored.
+    //!
+    void release(void* ptr)
+    {
+        if (!ptr)
+            return;
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mInUse.find(ptr);
+        if (it == mInUse.end())
+            return;
+        size_t bytes = it->second;
+        mInUse.erase(it);
+        mStats.bytesInUse -= bytes;
+        mFree[bytes].push_back(ptr);
+        mStats.bytesCached += bytes;
+        if (mStats.bytesCached > mMaxCachedBytes)
+            trimLocked(mMaxCachedBytes);
+    }
+
+    //!
+    //! \brief Free cached blocks, largest first, until at most maxCachedBytes are left in free blocks.
+    //!
+    void trim(size_t maxCachedBytes = 0)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        trimLocked(maxCachedBytes);
+    }
+
+    //!
+    //! \brief Change the cap on cached bytes, trimming the free blocks down to it.
+    //!
+    void setMaxCachedBytes(size_t maxCachedBytes)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mMaxCachedBytes = maxCachedBytes;
+        trimLocked(maxCachedBytes);
+    }
+
+    size_t getMaxCachedBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mMaxCachedBytes;
+    }
+
+    BufferPoolStats getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mStats;
+    }
+
+    //!
+    //! \brief Reset the counters. Current usage is kept and becomes the new peak.
+    //!
+    void resetStats()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        BufferPoolStats stats;
+        stats.bytesInUse = stats.peakBytesInUse = mStats.bytesInUse;
+        stats.bytesCached = mStats.bytesCached;
+        stats.peakBytesReserved = stats.bytesInUse + stats.bytesCached;
+        mStats = stats;
+    }
+
+private:
+    void updatePeaks()
+    {
+        if (mStats.bytesInUse > mStats.peakBytesInUse)
+            mStats.peakBytesInUse = mStats.bytesInUse;
+        if (mStats.bytesInUse + mStats.bytesCached > mStats.peakBytesReserved)
+            mStats.peakBytesReserved = mStats.bytesInUse + mStats.bytesCached;
+    }
+
+    void trimLocked(size_t maxCachedBytes)
+    {
+        for (auto it = mFree.rbegin(); it != mFree.rend() && mStats.bytesCached > maxCachedBytes; ++it)
+        {
+            std::vector<void*>& blocks = it->second;
+            while (!blocks.empty() && mStats.bytesCached > maxCachedBytes)
+            {
+                freeFn(blocks.back());
+                blocks.pop_back();
+                mStats.bytesCached -= it->first;
+                ++mStats.blocksFreed;
+            }
+        }
+    }
+
+    mutable std::mutex mMutex;
+    size_t mMaxCachedBytes;                     //!< Cap on bytesCached
+    AllocFunc allocFn;                          //!< Backing allocation of new blocks
+    FreeFunc freeFn;                            //!< Backing deallocation of trimmed blocks
+    std::map<size_t, std::vector<void*>> mFree; //!< Free blocks by size class
+    std::unordered_map<void*, size_t> mInUse;   //!< Size class of every block handed out
+    BufferPoolStats mStats;
+};
+
+template <typename AllocFunc, typename FreeFunc>
+const size_t BufferPool<AllocFunc, FreeFunc>::kUNLIMITED;
+
+template <typename AllocFunc, typename FreeFunc>
+const size_t BufferPool<AllocFunc, FreeFunc>::kMIN_BLOCK_SIZE;
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_BUFFER_POOL_H
@@ -0,0 +1,257 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_BUFFER_RING_H
+#define TENSORRT_BUFFER_RING_H
+
+#include <deque>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \brief States of one slot of a BufferRing. A slot moves kFREE -> kFILLING -> kIN_FLIGHT -> kDRAINING -> kFREE.
+//!
+enum class SlotState
+{
+    kFREE,      //!< Not used; the next acquire() may hand it out.
+    kFILLING,   //!< Owned by the host, which writes the inputs of the next batch into it.
+    kIN_FLIGHT, //!< Submitted to the backend: copies and execution may still be running.
+    kDRAINING,  //!< Completed; owned by the host, which reads the outputs until it releases the slot.
+};
+
+//!
+//! \class IRingBackend
+//! \brief The copies and executions behind a BufferRing, so that the slot state machine can be driven without a GPU.
+//!
+class IRingBackend
+{
+public:
+    //!
+    //! \brief Start the copies to the device, the execution and the copies back to the host of slot, and arm the
+    //!        fence of slot behind them. Must not wait for the work to complete.
+    //!
+    virtual bool enqueue(int slot) = 0;
+
+    //!
+    //! \brief Returns true if the work enqueued last for slot has completed.
+    //!
+    virtual bool query(int slot) = 0;
+
+    //!
+    //! \brief Block until the work enqueued last for slot has completed. Returns false if it failed.
+    //!
+    virtual bool synchronize(int slot) = 0;
+
+    virtual ~IRingBackend() {}
+};
+
+//!
+//! \class BufferRing
+//! \brief Pipelines batches through K buffer slots, so that the host fills slot i+1 while slot i is in flight.
+//!
+//! \details Slots are acquired in ring order, and drained in the order they were submitted, so outputs come back
+//!          in the same order as the inputs went in. acquire() never hands out a slot before the previous user
+//!          of it has released it, and drain() never returns a slot before its fence has completed, so the host
+//!          cannot overwrite inputs or read outputs that the backend is still using.
+//!
+//!          Calls that do not match the state of a slot fail without changing any state. The ring is meant to
+//!          be driven by one host thread; use one ring per thread.
+//!
+//!          A typical loop with K = 2 or 3:
+//!          \code
+//!          int slot = ring.acquire();
+//!          if (slot < 0)
+//!          {
+//!              // The next slot still holds the oldest batch: consume it first.
+//!              int done = ring.drain();
+//!              consume(done, ring.hasFailed(done));
+//!              ring.release(done);
+//!              slot = ring.acquire();
+//!          }
+//!          fill(slot);
+//!          ring.submit(slot);
+//!          \endcode
+//!
+class BufferRing
+{
+public:
+    BufferRing(int nbSlots, IRingBackend& backend)
+        : mStates(nbSlots > 0 ? nbSlots : 1, SlotState::kFREE)
+        , mFailed(mStates.size(), false)
+        , mBackend(backend)
+    {
+    }
+
+    int getNbSlots() const { return static_cast<int>(mStates.size()); }
+
+    SlotState getState(int slot) const { return mStates[slot]; }
+
+    //!
+    //! \brief Returns true if the backend reported a failure for the last submission of slot.
+    //!
+    bool hasFailed(int slot) const { return mFailed[slot]; }
+
+    //!
+    //! \brief Returns the number of slots in state.
+    //!
+    int count(SlotState state) const
+    {
+        int n{0};
+        for (SlotState s : mStates)
+            n += s == state;
+        return n;
+    }
+
+    //!
+    //! \brief Hand out the next slot in ring order for filling: kFREE -> kFILLING.
+    //!
+    //! \return The slot, or -1 if it has not been released yet. Drain and release the oldest slot, then retry.
+    //!
+    int acquire()
+    {
+        int slot = mNextAcquire;
+        if (mStates[slot] != SlotState::kFREE)
+            return -1;
+        mStates[slot] = SlotState::kFILLING;
+        mNextAcquire = (mNextAcquire + 1) % getNbSlots();
+        return slot;
+    }
+
+    //!
+    //! \brief Hand a filled slot to the backend: kFILLING -> kIN_FLIGHT.
+    //!
+    //! \return false if slot is not being filled, or if the backend failed to enqueue it. In the latter case the
+    //!         slot stays kFILLING so that it can be submitted again or released with cancel().
+    //!
+    bool submit(int slot)
+    {
+        if (!isSlot(slot) || mStates[slot] != SlotState::kFILLING || !mBackend.enqueue(slot))
+            return false;
+        mStates[slot] = SlotState::kIN_FLIGHT;
+        mInFlight.push_back(slot);
+        return true;
+    }
+
+    //!
+    //! \brief Give back a slot that was acquired but will not be submitted: kFILLING -> kFREE.
+    //!
+    bool cancel(int slot)
+    {
+        if (!isSlot(slot) || mStates[slot] != SlotState::kFILLING)
+            return false;
+        mStates[slot] = SlotState::kFREE;
+        return true;
+    }
+
+    //!
+    //! \brief Wait for the oldest in-flight slot to complete: kIN_FLIGHT -> kDRAINING.
+    //!
+    //! \return The slot, or -1 if nothing is in flight. If the backend failed, the slot is drained all the same and
+    //!         must be released, but hasFailed() is set and its outputs are not valid.
+    //!
+    int drain()
+    {
+        if (mInFlight.empty())
+            return -1;
+        int slot = mInFlight.front();
+        mInFlight.pop_front();
+        mFailed[slot] = !mBackend.synchronize(slot);
+        mStates[slot] = SlotState::kDRAINING;
+        return slot;
+    }
+
+    //!
+    //! \brief Like drain(), but returns -1 at once if the oldest in-flight slot has not completed yet.
+    //!
+    int tryDrain()
+    {
+        if (mInFlight.empty() || !mBackend.query(mInFlight.front()))
+            return -1;
+        return drain();
+    }
+
+    //!
+    //! \brief Return a drained slot to the ring once its outputs have been consumed: kDRAINING -> kFREE.
+    //!
+    bool release(int slot)
+    {
+        if (!isSlot(slot) || mStates[slot] != SlotState::kDRAINING)
+            return false;
+        mStates[slot] = SlotState::kFREE;
+        return true;
+    }
+
+    //!
+    //! \brief Wait for every in-flight slot and move it to kDRAINING, e.g. before the buffers are destroyed.
+    //!
+    //! \return false if any of them failed.
+    //!
+    bool synchronize()
+    {
+        bool ok{true};
+        while (!mInFlight.empty())
+            ok = !mFailed[drain()] && ok;
+        return ok;
+    }
+
+private:
+    bool isSlot(int slot) const { return slot >= 0 && slot < getNbSlots(); }
+
+    std::vector<SlotState> mStates; //!< State of every slot
+    std::vector<bool> mFailed;      //!< Whether the last submission of every slot failed
+    std::deque<int> mInFlight;      //!< In-flight slots in the order they were submitted
+    int mNextAcquire{0};            //!< Slot handed out by the next acquire()
+    IRingBackend& mBackend;
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_BUFFER_RING_H
@@ -53,8 +53,13 @@
 #include "NvInfer.h"
 #include "half.h"
 #include "common.h"
+#include "bufferRing.h"
+#include "hostMemory.h"
+#include "tensorFile.h"
+#include "tensorView.h"
 #include <cuda_runtime_api.h>
 #include <cassert>
+#include <fstream>
 #include <iostream>
 #include <iterator>
 #include <memory>
@@ -82,6 +87,7 @@ namespace samplesCommon
 //!          The boolean indicates whether or not the memory allocation was successful.
 //!          FreeFunc must be a functor that takes in (void* ptr) and returns void.
 //!          ptr is the allocated buffer address. It must work with nullptr input.
+//!          The functors may carry state, such as the kind of memory to allocate; it moves with the buffer.
 //!
 template <typename AllocFunc, typename FreeFunc>
 class GenericBuffer
@@ -99,8 +105,10 @@ public:
     //!
     //! \brief Construct a buffer with the specified allocation size in bytes.
     //!
-    GenericBuffer(size_t size)
+    GenericBuffer(size_t size, AllocFunc allocFunc = AllocFunc(), FreeFunc freeFunc = FreeFunc())
         : mByteSize(size)
+        , allocFn(allocFunc)
+        , freeFn(freeFunc)
     {
         if (!allocFn(&mBuffer, mByteSize))
             throw std::bad_alloc();
@@ -109,6 +117,8 @@ public:
     GenericBuffer(GenericBuffer&& buf)
         : mByteSize(buf.mByteSize)
         , mBuffer(buf.mBuffer)
+        , allocFn(buf.allocFn)
+        , freeFn(buf.freeFn)
     {
         buf.mByteSize = 0;
         buf.mBuffer = nullptr;
@@ -121,6 +131,8 @@ public:
             freeFn(mBuffer);
             mByteSize = buf.mByteSize;
             mBuffer = buf.mBuffer;
+            allocFn = buf.allocFn;
+            freeFn = buf.freeFn;
             buf.mByteSize = 0;
             buf.mBuffer = nullptr;
         }
@@ -154,37 +166,190 @@ private:
     FreeFunc freeFn;
 };
 
-class DeviceAllocator
+//!
+//! \brief cudaMalloc and cudaFree, the backing allocation of DeviceMemoryPool.
+//!
+class CudaMallocFunc
 {
 public:
     bool operator()(void** ptr, size_t size) const { return cudaMalloc(ptr, size) == cudaSuccess; }
 };
 
-class DeviceFree
+class CudaFreeFunc
 {
 public:
     void operator()(void* ptr) const { cudaFree(ptr); }
 };
 
+//!
+//! \brief Pool of device blocks, so that buffers created for every inference or request reuse memory instead of
+//!        paying for cudaMalloc and the implicit synchronization of cudaFree each time.
+//!
+//! \details Blocks are returned to the pool as soon as their buffer is destroyed, so work still using a buffer must
+//!          have completed by then, exactly as before cudaFree. Own the pool in the code that uses it rather than
+//!          relying on instance(), which is destroyed after the CUDA runtime may already have been torn down.
+//!
+using DeviceMemoryPool = BufferPool<CudaMallocFunc, CudaFreeFunc>;
+
+//!
+//! \brief Allocation policy of DeviceBuffer: cudaMalloc, or a block of pool if one is given.
+//!
+class DeviceAllocator
+{
+public:
+    DeviceAllocator(DeviceMemoryPool* pool = nullptr)
+        : mPool(pool)
+    {
+    }
+
+    bool operator()(void** ptr, size_t size) const
+    {
+        if (!mPool)
+            return CudaMallocFunc()(ptr, size);
+        *ptr = mPool->allocate(size);
+        return *ptr != nullptr;
+    }
+
+private:
+    DeviceMemoryPool* mPool;
+};
+
+class DeviceFree
+{
+public:
+    DeviceFree(DeviceMemoryPool* pool = nullptr)
+        : mPool(pool)
+    {
+    }
+
+    void operator()(void* ptr) const
+    {
+        if (mPool)
+            mPool->release(ptr);
+        else
+            CudaFreeFunc()(ptr);
+    }
+
+private:
+    DeviceMemoryPool* mPool;
+};
+
+//!
+//! \brief Kinds of host memory a HostBuffer can be backed by.
+//!
+enum class HostMemoryType
+{
+    kPAGEABLE,  //!< malloc. Copies to and from the device are staged by the driver and never truly asynchronous.
+    kPINNED,    //!< cudaMallocHost. Page-locked, so copies run at full bandwidth and overlap with execution.
+    kALIGNED,   //!< Pageable, aligned to kHOST_ALIGNMENT so host-side preprocessing can use aligned vector loads.
+    kHUGE_PAGE, //!< Pageable, aligned and advised to use transparent huge pages, for large staging buffers.
+    kPOOLED,    //!< Pageable, aligned and recycled through HostMemoryPool::instance() instead of being freed.
+};
+
+//!
+//! \brief Allocation policy of HostBuffer. Every type but kPINNED works without a GPU.
+//!
 class HostAllocator
 {
 public:
+    HostAllocator(HostMemoryType type = HostMemoryType::kPAGEABLE)
+        : mType(type)
+    {
+    }
+
     bool operator()(void** ptr, size_t size) const
     {
-        *ptr = malloc(size);
+        switch (mType)
+        {
+        case HostMemoryType::kPINNED: return cudaMallocHost(ptr, size) == cudaSuccess;
+        case HostMemoryType::kALIGNED: *ptr = alignedAlloc(size); break;
+        case HostMemoryType::kHUGE_PAGE: *ptr = hugePageAlloc(size); break;
+        case HostMemoryType::kPOOLED: *ptr = HostMemoryPool::instance().allocate(size); break;
+        case HostMemoryType::kPAGEABLE: *ptr = malloc(size); break;
+        }
         return *ptr != nullptr;
     }
+
+private:
+    HostMemoryType mType;
 };
 
 class HostFree
 {
 public:
-    void operator()(void* ptr) const { free(ptr); }
+    HostFree(HostMemoryType type = HostMemoryType::kPAGEABLE)
+        : mType(type)
+    {
+    }
+
+    void operator()(void* ptr) const
+    {
+        switch (mType)
+        {
+        case HostMemoryType::kPINNED: cudaFreeHost(ptr); break;
+        case HostMemoryType::kPOOLED: HostMemoryPool::instance().release(ptr); break;
+        case HostMemoryType::kALIGNED:
+        case HostMemoryType::kHUGE_PAGE:
+        case HostMemoryType::kPAGEABLE: free(ptr); break;
+        }
+    }
+
+private:
+    HostMemoryType mType;
 };
 
 using DeviceBuffer = GenericBuffer<DeviceAllocator, DeviceFree>;
 using HostBuffer = GenericBuffer<HostAllocator, HostFree>;
 
+//!
+//! \brief The TensorRT data type of binding elements of type T, for the type checks of BufferManager::getHostTensor.
+//!
+template <typename T>
+struct BindingDataType;
+
+template <>
+struct BindingDataType<float>
+{
+    static constexpr nvinfer1::DataType value = nvinfer1::DataType::kFLOAT;
+};
+
+template <>
+struct BindingDataType<half_float::half>
+{
+    static constexpr nvinfer1::DataType value = nvinfer1::DataType::kHALF;
+};
+
+template <>
+struct BindingDataType<int8_t>
+{
+    static constexpr nvinfer1::DataType value = nvinfer1::DataType::kINT8;
+};
+
+template <>
+struct BindingDataType<int32_t>
+{
+    static constexpr nvinfer1::DataType value = nvinfer1::DataType::kINT32;
+};
+
+//!
+//! \brief When BufferManager allocates the buffers of a binding.
+//!
+enum class AllocationPolicy
+{
+    kEAGER, //!< Every host and device buffer in the constructor.
+    kLAZY,  //!< Each buffer on first access. Host buffers that are never read, written or copied take no memory.
+};
+
+//!
+//! \brief Formats of BufferManager::dumpBuffer and BufferManager::loadBuffer.
+//!
+enum class DumpFormat
+{
+    kTEXT, //!< The shape on the first line, then the elements as text, one row of the last dimension per line.
+    kRAW,  //!< The bytes of the host buffer, in the binding's data type.
+    kNPY,  //!< The bytes of the host buffer after a NumPy .npy header with the data type and [batch, dims...] shape.
+};
+
 //!
 //! \brief  The ManagedBuffer class groups together a pair of corresponding device and host buffers.
 //!
@@ -203,6 +368,13 @@ public:
 //!          and debugging dumps to validate inference. The BufferManager class is meant to be
 //!          used to simplify buffer management and any interactions between buffers and the engine.
 //!
+//!          Buffers are sized for a batch capacity, initially the batch size given to the constructor. resize()
+//!          changes the batch size that copies, dumps and views use, and only reallocates to grow the capacity.
+//!          With AllocationPolicy::kLAZY, buffers are allocated the first time they are accessed, including
+//!          through a copy; allocate() does it up front, e.g. before timing a loop that uses pinned memory.
+//!          setDeviceOnly() drops the host mirror of a binding that the host never needs, such as a large
+//!          intermediate output.
+//!
 class BufferManager
 {
 public:
@@ -211,21 +383,38 @@ public:
     //!
     //! \brief Create a BufferManager for handling buffer interactions with engine.
     //!
-    BufferManager(std::shared_ptr<nvinfer1::ICudaEngine> engine, const int& batchSize)
+    //! \param hostMemoryType Kind of memory backing the host buffers. Use kPINNED when copies are timed or need to
+    //!        overlap with execution, and kPOOLED when BufferManagers are created repeatedly for the same engine.
+    //! \param devicePool Pool the device buffers are taken from and returned to, or nullptr to use cudaMalloc. It
+    //!        must outlive the BufferManager.
+    //! \param policy Whether to allocate every buffer now or each of them on first access.
+    //!
+    BufferManager(std::shared_ptr<nvinfer1::ICudaEngine> engine, const int& batchSize,
+                  HostMemoryType hostMemoryType = HostMemoryType::kPAGEABLE, DeviceMemoryPool* devicePool = nullptr,
+                  AllocationPolicy policy = AllocationPolicy::kEAGER)
         : mEngine(engine)
         , mBatchSize(batchSize)
+        , mCapacity(batchSize)
+        , mHostMemoryType(hostMemoryType)
+        , mDevicePool(devicePool)
+        , mDeviceOnly(mEngine->getNbBindings(), false)
+        , mDeviceBindings(mEngine->getNbBindings(), nullptr)
+    {
+        for (int i = 0; i < mEngine->getNbBindings(); i++)
+            mManagedBuffers.emplace_back(new ManagedBuffer());
+        if (policy == AllocationPolicy::kEAGER)
+            allocate();
+    }
+
+    //!
+    //! \brief Allocate every buffer that has not been allocated yet.
+    //!
+    void allocate() const
     {
         for (int i = 0; i < mEngine->getNbBindings(); i++)
         {
-            // Create host and device buffers
-            size_t vol = samplesCommon::volume(mEngine->getBindingDimensions(i));
-            size_t elementSize = samplesCommon::getElementSize(mEngine->getBindingDataType(i));
-            size_t allocationSize = static_cast<size_t>(mBatchSize) * vol * elementSize;
-            std::unique_ptr<ManagedBuffer> manBuf{new ManagedBuffer()};
-            manBuf->deviceBuffer = DeviceBuffer(allocationSize);
-            manBuf->hostBuffer = HostBuffer(allocationSize);
-            mDeviceBindings.emplace_back(manBuf->deviceBuffer.data());
-            mManagedBuffers.emplace_back(std::move(manBuf));
+            deviceBuffer(i);
+            hostBuffer(i);
         }
     }
 
@@ -233,12 +422,82 @@ public:
     //! \brief Returns a vector of device buffers that you can use directly as
     //!        bindings for the execute and enqueue methods of IExecutionContext.
     //!
-    std::vector<void*>& getDeviceBindings() { return mDeviceBindings; }
+    std::vector<void*>& getDeviceBindings()
+    {
+        allocateDeviceBindings();
+        return mDeviceBindings;
+    }
 
     //!
     //! \brief Returns a vector of device buffers.
     //!
-    const std::vector<void*>& getDeviceBindings() const { return mDeviceBindings; }
+    const std::vector<void*>& getDeviceBindings() const
+    {
+        allocateDeviceBindings();
+        return mDeviceBindings;
+    }
+
+    //!
+    //! \brief Drop the host buffer of tensorName, or give it back: the host never reads or writes a device-only
+    //!        binding, copies skip it and getHostBuffer returns nullptr for it.
+    //!
+    //! \return false if no such tensor can be found.
+    //!
+    bool setDeviceOnly(const std::string& tensorName, bool deviceOnly = true)
+    {
+        int index = mEngine->getBindingIndex(tensorName.c_str());
+        if (index == -1)
+            return false;
+        mDeviceOnly[index] = deviceOnly;
+        if (deviceOnly)
+            mManagedBuffers[index]->hostBuffer = HostBuffer();
+        return true;
+    }
+
+    bool isDeviceOnly(const std::string& tensorName) const
+    {
+        int index = mEngine->getBindingIndex(tensorName.c_str());
+        return index != -1 && mDeviceOnly[index];
+    }
+
+    //!
+    //! \brief Change the batch size of the buffers. Shrinking, or growing within the capacity reached so far,
+    //!        keeps the buffers and their contents. Growing beyond it reallocates the buffers that have been
+    //!        allocated, whose contents are then lost, and invalidates the pointers and bindings returned before.
+    //!
+    //! \return false if batchSize is not between 1 and the maximum batch size of the engine.
+    //!
+    bool resize(int batchSize)
+    {
+        if (batchSize < 1 || batchSize > mEngine->getMaxBatchSize())
+            return false;
+        if (batchSize > mCapacity)
+        {
+            mCapacity = batchSize;
+            for (int i = 0; i < mEngine->getNbBindings(); i++)
+            {
+                ManagedBuffer& buffer = *mManagedBuffers[i];
+                const bool hadDevice = buffer.deviceBuffer.data() != nullptr;
+                const bool hadHost = buffer.hostBuffer.data() != nullptr;
+                buffer.deviceBuffer = DeviceBuffer();
+                buffer.hostBuffer = HostBuffer();
+                mDeviceBindings[i] = nullptr;
+                if (hadDevice)
+                    deviceBuffer(i);
+                if (hadHost)
+                    hostBuffer(i);
+            }
+        }
+        mBatchSize = batchSize;
+        return true;
+    }
+
+    int getBatchSize() const { return mBatchSize; }
+
+    //!
+    //! \brief Returns the batch size the buffers are allocated for.
+    //!
+    int getCapacity() const { return mCapacity; }
 
     //!
     //! \brief Returns the device buffer corresponding to tensorName.
@@ -252,6 +511,21 @@ public:
     //!
     void* getHostBuffer(const std::string& tensorName) const { return getBuffer(true, tensorName); }
 
+    //!
+    //! \brief Returns a view of the host buffer corresponding to tensorName, shaped [batch, binding dimensions...].
+    //!        Returns an invalid view if no such tensor can be found or if its data type is not T.
+    //!
+    template <typename T>
+    TensorView<T> getHostTensor(const std::string& tensorName) const
+    {
+        int index = mEngine->getBindingIndex(tensorName.c_str());
+        if (index == -1 || mDeviceOnly[index]
+            || mEngine->getBindingDataType(index) != BindingDataType<typename std::remove_const<T>::type>::value)
+            return TensorView<T>();
+        std::vector<int64_t> shape = getShape(index);
+        return TensorView<T>(static_cast<T*>(hostBuffer(index)), shape.begin(), shape.end());
+    }
+
     //!
     //! \brief Returns the size of the host and device buffers that correspond to tensorName.
     //!        Returns kINVALID_SIZE_VALUE if no such tensor can be found.
@@ -261,37 +535,153 @@ public:
         int index = mEngine->getBindingIndex(tensorName.c_str());
         if (index == -1)
             return kINVALID_SIZE_VALUE;
-        return mManagedBuffers[index]->hostBuffer.size();
+        return byteSize(index);
     }
 
     //!
     //! \brief Dump host buffer with specified tensorName to ostream.
     //!        Prints error message to std::ostream if no such tensor can be found.
     //!
-    void dumpBuffer(std::ostream& os, const std::string& tensorName)
+    //! \param format kRAW and kNPY write the buffer in one block and need a stream opened in binary mode; they are
+    //!        much faster and smaller than text for large outputs, and can be replayed with loadBuffer.
+    //!
+    //! \return false if no such tensor can be found.
+    //!
+    bool dumpBuffer(std::ostream& os, const std::string& tensorName, DumpFormat format = DumpFormat::kTEXT)
     {
         int index = mEngine->getBindingIndex(tensorName.c_str());
         if (index == -1)
         {
             os << "Invalid tensor name" << std::endl;
-            return;
+            return false;
+        }
+        if (mDeviceOnly[index])
+        {
+            os << "Tensor has no host buffer" << std::endl;
+            return false;
         }
-        void* buf = mManagedBuffers[index]->hostBuffer.data();
-        size_t bufSize = mManagedBuffers[index]->hostBuffer.size();
+        void* buf = hostBuffer(index);
+        size_t bufSize = byteSize(index);
         nvinfer1::Dims bufDims = mEngine->getBindingDimensions(index);
-        size_t rowCount = static_cast<size_t>(bufDims.nbDims >= 1 ? bufDims.d[bufDims.nbDims - 1] : mBatchSize);
+        nvinfer1::DataType type = mEngine->getBindingDataType(index);
+
+        if (format == DumpFormat::kNPY)
+        {
+            const std::string header = npyHeader(type, getShape(index));
+            os.write(header.data(), header.size());
+        }
+        if (format != DumpFormat::kTEXT)
+        {
+            os.write(static_cast<const char*>(buf), bufSize);
+            return true;
+        }
 
-        os << "[" << mBatchSize;
+        size_t rowCount = static_cast<size_t>(bufDims.nbDims >= 1 ? bufDims.d[bufDims.nbDims - 1] : mBatchSize);
+        TensorTextWriter writer(os);
+        writer.writeString("[" + std::to_string(mBatchSize));
         for (int i = 0; i < bufDims.nbDims; i++)
-            os << ", " << bufDims.d[i];
-        os << "]" << std::endl;
-        switch (mEngine->getBindingDataType(index))
+            writer.writeString(", " + std::to_string(bufDims.d[i]));
+        writer.writeString("]\n");
+        switch (type)
+        {
+        case nvinfer1::DataType::kINT32: writer.write(static_cast<const int32_t*>(buf), bufSize / sizeof(int32_t), rowCount); break;
+        case nvinfer1::DataType::kFLOAT: writer.write(static_cast<const float*>(buf), bufSize / sizeof(float), rowCount); break;
+        case nvinfer1::DataType::kHALF: writer.write(static_cast<const half_float::half*>(buf), bufSize / sizeof(half_float::half), rowCount); break;
+        case nvinfer1::DataType::kINT8: writer.write(static_cast<const int8_t*>(buf), bufSize, rowCount); break;
+        }
+        return true;
+    }
+
+    //!
+    //! \brief Dump the host buffer with specified tensorName to fileName.
+    //!
+    //! \return false with a description in error if no such tensor can be found or the file cannot be written.
+    //!
+    bool dumpBuffer(const std::string& tensorName, const std::string& fileName, DumpFormat format, std::string& error)
+    {
+        int index = mEngine->getBindingIndex(tensorName.c_str());
+        if (index == -1 || mDeviceOnly[index])
+        {
+            error = (index == -1 ? "invalid tensor name " : "no host buffer for device-only tensor ") + tensorName;
+            return false;
+        }
+        if (format != DumpFormat::kTEXT)
+        {
+            return writeTensorFile(fileName, hostBuffer(index), byteSize(index), mEngine->getBindingDataType(index),
+                                   getShape(index), format == DumpFormat::kNPY, error);
+        }
+        std::ofstream file(fileName, std::ios::binary);
+        dumpBuffer(file, tensorName, format);
+        file.close();
+        if (!file)
+        {
+            error = "cannot write " + fileName;
+            return false;
+        }
+        return true;
+    }
+
+    //!
+    //! \brief Fill the host buffer with specified tensorName from a file written by dumpBuffer, e.g. to replay a
+    //!        dumped output as the input of another engine.
+    //!
+    //! \details Raw and .npy files are memory-mapped and may hold any number of samples of the binding, which
+    //!          fill the batch from the start of the file, wrapping around if the file holds fewer samples than
+    //!          the batch. A text file must hold exactly one value per element of the buffer.
+    //!
+    //! \return false with a description in error if no such tensor can be found or the file does not fit it.
+    //!
+    bool loadBuffer(const std::string& tensorName, const std::string& fileName, DumpFormat format, std::string& error)
+    {
+        int index = mEngine->getBindingIndex(tensorName.c_str());
+        if (index == -1 || mDeviceOnly[index])
         {
-        case nvinfer1::DataType::kINT32: print<int32_t>(os, buf, bufSize, rowCount); break;
-        case nvinfer1::DataType::kFLOAT: print<float>(os, buf, bufSize, rowCount); break;
-        case nvinfer1::DataType::kHALF: print<half_float::half>(os, buf, bufSize, rowCount); break;
-        case nvinfer1::DataType::kINT8: assert(0 && "Int8 network-level input and output is not supported"); break;
+            error = (index == -1 ? "invalid tensor name " : "no host buffer for device-only tensor ") + tensorName;
+            return false;
         }
+        void* buffer = hostBuffer(index);
+        nvinfer1::DataType type = mEngine->getBindingDataType(index);
+        if (format != DumpFormat::kTEXT)
+        {
+            TensorDataset dataset;
+            if (!dataset.open(fileName, type, mEngine->getBindingDimensions(index), error))
+                return false;
+            dataset.copyBatch(0, mBatchSize, buffer);
+            return true;
+        }
+
+        MappedFile file;
+        if (!file.open(fileName, MappedFile::AccessHint::kSEQUENTIAL))
+        {
+            error = "cannot map " + fileName + ": " + std::strerror(errno);
+            return false;
+        }
+        std::vector<double> values;
+        if (!parseTensorText(static_cast<const char*>(file.data()), file.size(), values, error))
+        {
+            error = fileName + ": " + error;
+            return false;
+        }
+        const size_t count = byteSize(index) / tensorElementSize(type);
+        if (values.size() != count)
+        {
+            error = fileName + ": holds " + std::to_string(values.size()) + " values, expected " + std::to_string(count);
+            return false;
+        }
+        switch (type)
+        {
+        case nvinfer1::DataType::kINT32: std::copy(values.begin(), values.end(), static_cast<int32_t*>(buffer)); break;
+        case nvinfer1::DataType::kFLOAT: std::copy(values.begin(), values.end(), static_cast<float*>(buffer)); break;
+        case nvinfer1::DataType::kINT8: std::copy(values.begin(), values.end(), static_cast<int8_t*>(buffer)); break;
+        case nvinfer1::DataType::kHALF:
+        {
+            half_float::half* dst = static_cast<half_float::half*>(buffer);
+            for (size_t i = 0; i < count; i++)
+                dst[i] = half_float::half(static_cast<float>(values[i]));
+            break;
+        }
+        }
+        return true;
     }
 
     //!
@@ -304,23 +694,8 @@ public:
     {
         assert(rowCount != 0);
         assert(bufSize % sizeof(T) == 0);
-        T* typedBuf = static_cast<T*>(buf);
-        size_t numItems = bufSize / sizeof(T);
-        for (int i = 0; i < static_cast<int>(numItems); i++)
-        {
-            // Handle rowCount == 1 case
-            if (rowCount == 1 && i != static_cast<int>(numItems) - 1)
-                os << typedBuf[i] << std::endl;
-            else if (rowCount == 1)
-                os << typedBuf[i];
-            // Handle rowCount > 1 case
-            else if (i % rowCount == 0)
-                os << typedBuf[i];
-            else if (i % rowCount == rowCount - 1)
-                os << " " << typedBuf[i] << std::endl;
-            else
-                os << " " << typedBuf[i];
-        }
+        TensorTextWriter writer(os);
+        writer.write(static_cast<const T*>(buf), bufSize / sizeof(T), rowCount);
     }
 
     //!
@@ -346,36 +721,201 @@ public:
     ~BufferManager() = default;
 
 private:
+    //!
+    //! \brief Returns the shape of the buffers of binding index: [batch, binding dimensions...].
+    //!
+    std::vector<int64_t> getShape(int index) const
+    {
+        nvinfer1::Dims dims = mEngine->getBindingDimensions(index);
+        std::vector<int64_t> shape{mBatchSize};
+        shape.insert(shape.end(), dims.d, dims.d + dims.nbDims);
+        return shape;
+    }
+
+    //!
+    //! \brief Returns the size in bytes of the buffers of binding index at the current batch size.
+    //!
+    size_t byteSize(int index) const
+    {
+        size_t vol = samplesCommon::volume(mEngine->getBindingDimensions(index));
+        size_t elementSize = samplesCommon::getElementSize(mEngine->getBindingDataType(index));
+        return static_cast<size_t>(mBatchSize) * vol * elementSize;
+    }
+
+    //!
+    //! \brief Returns the size in bytes of the buffers of binding index at the batch capacity.
+    //!
+    size_t allocationSize(int index) const
+    {
+        return byteSize(index) / mBatchSize * mCapacity;
+    }
+
+    //!
+    //! \brief Returns the device buffer of binding index, allocating it on first use.
+    //!
+    void* deviceBuffer(int index) const
+    {
+        DeviceBuffer& buffer = mManagedBuffers[index]->deviceBuffer;
+        if (!buffer.data())
+        {
+            buffer = DeviceBuffer(allocationSize(index), DeviceAllocator(mDevicePool), DeviceFree(mDevicePool));
+            mDeviceBindings[index] = buffer.data();
+        }
+        return buffer.data();
+    }
+
+    //!
+    //! \brief Returns the host buffer of binding index, allocating it on first use, or nullptr if it is device-only.
+    //!
+    void* hostBuffer(int index) const
+    {
+        if (mDeviceOnly[index])
+            return nullptr;
+        HostBuffer& buffer = mManagedBuffers[index]->hostBuffer;
+        if (!buffer.data())
+            buffer = HostBuffer(allocationSize(index), HostAllocator(mHostMemoryType), HostFree(mHostMemoryType));
+        return buffer.data();
+    }
+
+    void allocateDeviceBindings() const
+    {
+        for (int i = 0; i < mEngine->getNbBindings(); i++)
+            deviceBuffer(i);
+    }
+
     void* getBuffer(const bool isHost, const std::string& tensorName) const
     {
         int index = mEngine->getBindingIndex(tensorName.c_str());
         if (index == -1)
             return nullptr;
-        return (isHost ? mManagedBuffers[index]->hostBuffer.data() : mManagedBuffers[index]->deviceBuffer.data());
+        return isHost ? hostBuffer(index) : deviceBuffer(index);
     }
 
     void memcpyBuffers(const bool copyInput, const bool deviceToHost, const bool async, const cudaStream_t& stream = 0)
     {
         for (int i = 0; i < mEngine->getNbBindings(); i++)
         {
-            void* dstPtr = deviceToHost ? mManagedBuffers[i]->hostBuffer.data() : mManagedBuffers[i]->deviceBuffer.data();
-            const void* srcPtr = deviceToHost ? mManagedBuffers[i]->deviceBuffer.data() : mManagedBuffers[i]->hostBuffer.data();
-            const size_t byteSize = mManagedBuffers[i]->hostBuffer.size();
+            if (mDeviceOnly[i] || copyInput != mEngine->bindingIsInput(i))
+                continue;
+            void* dstPtr = deviceToHost ? hostBuffer(i) : deviceBuffer(i);
+            const void* srcPtr = deviceToHost ? deviceBuffer(i) : hostBuffer(i);
+            const size_t byteSize = this->byteSize(i);
             const cudaMemcpyKind memcpyType = deviceToHost ? cudaMemcpyDeviceToHost : cudaMemcpyHostToDevice;
-            if ((copyInput && mEngine->bindingIsInput(i)) || (!copyInput && !mEngine->bindingIsInput(i)))
-            {
-                if (async)
-                    CHECK(cudaMemcpyAsync(dstPtr, srcPtr, byteSize, memcpyType, stream));
-                else
-                    CHECK(cudaMemcpy(dstPtr, srcPtr, byteSize, memcpyType));
-            }
+            if (async)
+                CHECK(cudaMemcpyAsync(dstPtr, srcPtr, byteSize, memcpyType, stream));
+            else
+                CHECK(cudaMemcpy(dstPtr, srcPtr, byteSize, memcpyType));
         }
     }
 
-    std::shared_ptr<nvinfer1::ICudaEngine> mEngine;              //!< The pointer to the engine
-    int mBatchSize;                                              //!< The batch size
-    std::vector<std::unique_ptr<ManagedBuffer>> mManagedBuffers; //!< The vector of pointers to managed buffers
-    std::vector<void*> mDeviceBindings;                          //!< The vector of device buffers needed for engine execution
+    std::shared_ptr<nvinfer1::ICudaEngine> mEngine;                      //!< The pointer to the engine
+    int mBatchSize;                                                      //!< The batch size
+    int mCapacity;                                                       //!< The batch size the buffers are allocated for
+    HostMemoryType mHostMemoryType;                                      //!< The kind of memory backing the host buffers
+    DeviceMemoryPool* mDevicePool;                                       //!< The pool of the device buffers, or nullptr
+    std::vector<bool> mDeviceOnly;                                       //!< Whether each binding has no host buffer
+    std::vector<std::unique_ptr<ManagedBuffer>> mManagedBuffers;         //!< The vector of pointers to managed buffers, allocated on first access
+    mutable std::vector<void*> mDeviceBindings;                          //!< The vector of device buffers needed for engine execution
+};
+
+//!
+//! \brief  The RingBufferManager class pipelines batches through several BufferManagers, so that the input copies
+//!         of one batch overlap with the execution of the previous one.
+//!
+//! \details Every slot of the ring has its own BufferManager. A slot is copied to the device on a copy stream,
+//!          executed on a compute stream once its inputs are there, and copied back on an output stream once it has
+//!          been executed, with per-slot events between the stages. Drive it through getRing(): fill the host
+//!          buffers of an acquired slot, submit it, and read the outputs of a drained slot before releasing it.
+//!          Use pinned host memory, otherwise the copies cannot overlap with anything.
+//!
+class RingBufferManager : public IRingBackend
+{
+public:
+    //!
+    //! \param context The execution context all slots are executed with. It must outlive the RingBufferManager.
+    //! \param nbSlots Number of buffer sets: 2 overlaps copies with execution, 3 also keeps the host busy meanwhile.
+    //!
+    RingBufferManager(std::shared_ptr<nvinfer1::ICudaEngine> engine, nvinfer1::IExecutionContext& context,
+                      const int& batchSize, int nbSlots = 2, HostMemoryType hostMemoryType = HostMemoryType::kPINNED,
+                      DeviceMemoryPool* devicePool = nullptr)
+        : mContext(context)
+        , mBatchSize(batchSize)
+        , mRing(nbSlots, *this)
+    {
+        for (int i = 0; i < mRing.getNbSlots(); i++)
+        {
+            mBuffers.emplace_back(new BufferManager(engine, batchSize, hostMemoryType, devicePool));
+            cudaEvent_t inputReady, computed, done;
+            CHECK(cudaEventCreateWithFlags(&inputReady, cudaEventDisableTiming));
+            CHECK(cudaEventCreateWithFlags(&computed, cudaEventDisableTiming));
+            CHECK(cudaEventCreateWithFlags(&done, cudaEventDisableTiming));
+            mInputReady.push_back(inputReady);
+            mComputed.push_back(computed);
+            mDone.push_back(done);
+        }
+        CHECK(cudaStreamCreateWithFlags(&mCopyStream, cudaStreamNonBlocking));
+        CHECK(cudaStreamCreateWithFlags(&mComputeStream, cudaStreamNonBlocking));
+        CHECK(cudaStreamCreateWithFlags(&mOutputStream, cudaStreamNonBlocking));
+    }
+
+    RingBufferManager(const RingBufferManager&) = delete;
+    RingBufferManager& operator=(const RingBufferManager&) = delete;
+
+    ~RingBufferManager()
+    {
+        // The buffers must not be freed while copies or executions still use them.
+        mRing.synchronize();
+        for (int i = 0; i < mRing.getNbSlots(); i++)
+        {
+            cudaEventDestroy(mInputReady[i]);
+            cudaEventDestroy(mComputed[i]);
+            cudaEventDestroy(mDone[i]);
+        }
+        cudaStreamDestroy(mCopyStream);
+        cudaStreamDestroy(mComputeStream);
+        cudaStreamDestroy(mOutputStream);
+    }
+
+    //!
+    //! \brief Returns the slot state machine.
+    //!
+    BufferRing& getRing() { return mRing; }
+
+    //!
+    //! \brief Returns the buffers of slot. Only touch the host buffers while the slot is kFILLING or kDRAINING.
+    //!
+    BufferManager& getBuffers(int slot) { return *mBuffers[slot]; }
+
+    bool enqueue(int slot) override
+    {
+        BufferManager& buffers = *mBuffers[slot];
+        buffers.copyInputToDeviceAsync(mCopyStream);
+        CHECK(cudaEventRecord(mInputReady[slot], mCopyStream));
+        CHECK(cudaStreamWaitEvent(mComputeStream, mInputReady[slot], 0));
+        if (!mContext.enqueue(mBatchSize, buffers.getDeviceBindings().data(), mComputeStream, nullptr))
+            return false;
+        CHECK(cudaEventRecord(mComputed[slot], mComputeStream));
+        CHECK(cudaStreamWaitEvent(mOutputStream, mComputed[slot], 0));
+        buffers.copyOutputToHostAsync(mOutputStream);
+        CHECK(cudaEventRecord(mDone[slot], mOutputStream));
+        return true;
+    }
+
+    bool query(int slot) override { return cudaEventQuery(mDone[slot]) != cudaErrorNotReady; }
+
+    bool synchronize(int slot) override { return cudaEventSynchronize(mDone[slot]) == cudaSuccess; }
+
+private:
+    nvinfer1::IExecutionContext& mContext;
+    int mBatchSize;
+    BufferRing mRing;
+    std::vector<std::unique_ptr<BufferManager>> mBuffers; //!< Buffers of every slot
+    std::vector<cudaEvent_t> mInputReady;                 //!< Recorded once the inputs of a slot are on the device
+    std::vector<cudaEvent_t> mComputed;                   //!< Recorded once a slot has been executed
+    std::vector<cudaEvent_t> mDone;                       //!< Recorded once the outputs of a slot are on the host
+    cudaStream_t mCopyStream;
+    cudaStream_t mComputeStream;
+    cudaStream_t mOutputStream;
 };
 
 } // namespace samplesCommon
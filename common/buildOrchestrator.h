@@ -0,0 +1,280 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_BUILD_ORCHESTRATOR_H
+#define TENSORRT_BUILD_ORCHESTRATOR_H
+
+#include "jsonUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace samplesCommon
+{
+
+enum class BuildStatus
+{
+    kSUCCESS,
+    kFAILED,
+    kSKIPPED, //!< The configuration is not supported here, e.g. a precision without fast kernels on this GPU.
+};
+
+//!
+//! \brief Outcome and timing of one build, filled in by BuildOrchestrator and the build function.
+//!
+struct BuildRecord
+{
+    std::string name;
+    BuildStatus status{BuildStatus::kFAILED};
+    std::string message;  //!< Why the build failed or was skipped; set by the build function
+    uint64_t planBytes{0}; //!< Size of the serialized plan; set by the build function
+    double waitMs{0};      //!< Time from the start of the run until the build got a worker and its memory
+    double buildMs{0};
+};
+
+//!
+//! \brief One engine configuration to build.
+//!
+struct BuildJob
+{
+    using Function = std::function<BuildStatus(BuildRecord& record)>;
+
+    std::string name;
+    uint64_t memoryBytes{0}; //!< Estimated peak memory of the build, counted against the orchestrator's budget
+    Function build;          //!< Builds the engine with its own builder and stores or keeps the plan
+};
+
+//!
+//! \class BuildOrchestrator
+//! \brief Runs independent engine builds concurrently on a pool of worker threads.
+//!
+//! \details Jobs start in the order given, on at most maxParallel workers, and only while the memory estimates of
+//!          the running jobs fit into memoryBudget. A job larger than the whole budget still runs, alone.
+//!          Build functions must not share builders, networks or calibrators; each one runs on its own thread.
+//!          An exception escaping a build function fails that build only.
+//!
+class BuildOrchestrator
+{
+public:
+    //!
+    //! \param memoryBudget Total memory the concurrent builds may use, in bytes; 0 for no limit.
+    //!
+    BuildOrchestrator(int maxParallel, uint64_t memoryBudget = 0)
+        : mMaxParallel(std::max(maxParallel, 1))
+        , mMemoryBudget(memoryBudget)
+    {
+    }
+
+    //!
+    //! \brief Build every job and wait for all of them.
+    //!
+    //! \return true if no build failed. Skipped builds do not count as failures.
+    //!
+    bool run(const std::vector<BuildJob>& jobs)
+    {
+        mRecords.assign(jobs.size(), BuildRecord());
+        mNextJob = 0;
+        mMemoryInUse = 0;
+        mRunning = 0;
+        const auto tStart = std::chrono::high_resolution_clock::now();
+
+        std::vector<std::thread> workers;
+        const int nbWorkers = std::min(mMaxParallel, static_cast<int>(jobs.size()));
+        for (int w = 0; w < nbWorkers; w++)
+        {
+            workers.emplace_back([this, &jobs, tStart]() {
+                for (;;)
+                {
+                    size_t index;
+                    {
+                        // The next job is only taken once it fits, so that jobs start in order.
+                        std::unique_lock<std::mutex> lock(mMutex);
+                        mMemoryCv.wait(lock, [this, &jobs]() {
+                            return mNextJob == jobs.size() || mRunning == 0 || fits(jobs[mNextJob].memoryBytes);
+                        });
+                        if (mNextJob == jobs.size())
+                            return;
+                        index = mNextJob++;
+                        mMemoryInUse += jobs[index].memoryBytes;
+                        ++mRunning;
+                    }
+                    // The job after this one may fit as well.
+                    mMemoryCv.notify_all();
+                    execute(jobs[index], mRecords[index], tStart);
+                    {
+                        std::lock_guard<std::mutex> lock(mMutex);
+                        mMemoryInUse -= jobs[index].memoryBytes;
+                        --mRunning;
+                    }
+                    mMemoryCv.notify_all();
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        mWallMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+
+        return std::none_of(mRecords.begin(), mRecords.end(),
+                            [](const BuildRecord& r) { return r.status == BuildStatus::kFAILED; });
+    }
+
+    //!
+    //! \brief Returns the record of every job, in the order the jobs were given.
+    //!
+    const std::vector<BuildRecord>& getRecords() const { return mRecords; }
+
+    //!
+    //! \brief Returns the walltime of the last run() in milliseconds.
+    //!
+    double getWallMs() const { return mWallMs; }
+
+    //!
+    //! \brief Returns the sum of all build times of the last run(), i.e. the walltime of building one after another.
+    //!
+    double getSerialMs() const
+    {
+        double total{0};
+        for (const auto& r : mRecords)
+            total += r.buildMs;
+        return total;
+    }
+
+    //!
+    //! \brief Print one row per build followed by the walltime and the speedup over building serially.
+    //!
+    void writeTable(std::ostream& out) const
+    {
+        out << std::setw(20) << "build" << std::setw(10) << "status" << std::setw(12) << "wait ms" << std::setw(12)
+            << "build ms" << std::setw(12) << "plan MB" << "  " << "message" << std::endl;
+        for (const auto& r : mRecords)
+        {
+            out << std::setw(20) << r.name << std::setw(10) << statusName(r.status) << std::setw(12) << r.waitMs
+                << std::setw(12) << r.buildMs << std::setw(12) << r.planBytes / double(1 << 20) << "  " << r.message
+                << std::endl;
+        }
+        out << "Built " << mRecords.size() << " configurations in " << mWallMs << " ms (" << getSerialMs()
+            << " ms of builds, " << (mWallMs > 0 ? getSerialMs() / mWallMs : 0.0) << "x parallel speedup)." << std::endl;
+    }
+
+    void writeJson(std::ostream& out) const
+    {
+        out << "{\"wallMs\":";
+        jsonNumber(out, mWallMs);
+        out << ",\"serialMs\":";
+        jsonNumber(out, getSerialMs());
+        out << ",\"builds\":[";
+        for (size_t i = 0; i < mRecords.size(); i++)
+        {
+            const BuildRecord& r = mRecords[i];
+            out << (i ? ",\n" : "\n") << "{\"name\":" << jsonString(r.name) << ",\"status\":\""
+                << statusName(r.status) << "\",\"waitMs\":";
+            jsonNumber(out, r.waitMs);
+            out << ",\"buildMs\":";
+            jsonNumber(out, r.buildMs);
+            out << ",\"planBytes\":" << r.planBytes << ",\"message\":" << jsonString(r.message) << "}";
+        }
+        out << "\n]}\n";
+    }
+
+    static const char* statusName(BuildStatus status)
+    {
+        switch (status)
+        {
+        case BuildStatus::kSUCCESS: return "ok";
+        case BuildStatus::kFAILED: return "failed";
+        case BuildStatus::kSKIPPED: return "skipped";
+        }
+        return "";
+    }
+
+private:
+    bool fits(uint64_t memory) const { return mMemoryBudget == 0 || mMemoryInUse + memory <= mMemoryBudget; }
+
+    static void execute(const BuildJob& job, BuildRecord& record,
+                        std::chrono::high_resolution_clock::time_point tStart)
+    {
+        record.name = job.name;
+        const auto tBuild = std::chrono::high_resolution_clock::now();
+        record.waitMs = std::chrono::duration<double, std::milli>(tBuild - tStart).count();
+        try
+        {
+            record.status = job.build(record);
+        }
+        catch (const std::exception& e)
+        {
+            record.status = BuildStatus::kFAILED;
+            record.message = e.what();
+        }
+        record.buildMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tBuild).count();
+    }
+
+    int mMaxParallel;
+    uint64_t mMemoryBudget;
+    std::vector<BuildRecord> mRecords;
+    double mWallMs{0};
+
+    std::mutex mMutex;
+    std::condition_variable mMemoryCv;
+    size_t mNextJob{0};
+    uint64_t mMemoryInUse{0};
+    int mRunning{0};
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_BUILD_ORCHESTRATOR_H
@@ -0,0 +1,326 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_CALIBRATION_READER_H
+#define TENSORRT_CALIBRATION_READER_H
+
+#include "NvInfer.h"
+#include "tensorFile.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <dirent.h>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \brief Collect the calibration files named by path.
+//!
+//! \details A directory contributes its regular files in name order; hidden files are skipped. Any other file is
+//!          read as a list with one file name per line, relative to the directory of the list.
+//!
+//! \return false with a description in error if path cannot be read or names no files.
+//!
+inline bool listCalibrationFiles(const std::string& path, std::vector<std::string>& files, std::string& error)
+{
+    files.clear();
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+    {
+        error = "cannot access " + path;
+        return false;
+    }
+
+    if (S_ISDIR(st.st_mode))
+    {
+        DIR* dir = opendir(path.c_str());
+        if (!dir)
+        {
+            error = "cannot list " + path;
+            return false;
+        }
+        while (const dirent* d = readdir(dir))
+        {
+            std::string name = path + "/" + d->d_name;
+            if (d->d_name[0] != '.' && stat(name.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+                files.push_back(name);
+        }
+        closedir(dir);
+        std::sort(files.begin(), files.end());
+    }
+    else
+    {
+        std::ifstream list(path);
+        size_t slash = path.rfind('/');
+        const std::string base = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+        std::string line;
+        while (std::getline(list, line))
+        {
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (line.empty() || line[0] == '#')
+                continue;
+            files.push_back(line[0] == '/' ? line : base + line);
+        }
+    }
+
+    if (files.empty())
+    {
+        error = path + " does not name any calibration files";
+        return false;
+    }
+    return true;
+}
+
+//!
+//! \brief Calibration data of one network input.
+//!
+struct CalibrationInput
+{
+    std::string name;
+    nvinfer1::Dims dims;            //!< Dimensions of one sample, without the batch
+    std::vector<std::string> files; //!< Raw float32 or .npy files, each holding one or more samples
+};
+
+//!
+//! \class CalibrationBatchReader
+//! \brief Streams calibration batches from raw or .npy files, reading ahead on a background thread.
+//!
+//! \details The files of each input are read as one continuous sequence of samples, so batches may span files.
+//!          Reading stops after maxBatches batches or when any input runs out of samples; a trailing partial batch
+//!          is dropped because calibration needs complete batches. At most prefetchDepth batches are held ready, which
+//!          bounds the memory use independently of the size of the data set.
+//!          The thread starts on the first call to next(), so a reader that is never consumed, for example because a
+//!          calibration cache makes calibration unnecessary, does not touch its files.
+//!
+class CalibrationBatchReader
+{
+public:
+    //! One buffer per input, in the order the inputs were given, each holding getBatchSize() float samples.
+    using Batch = std::vector<std::vector<char>>;
+
+    //!
+    //! \param maxBatches Number of batches to read; 0 reads every complete batch.
+    //!
+    CalibrationBatchReader(const std::vector<CalibrationInput>& inputs, int batchSize, int maxBatches, int prefetchDepth = 2)
+        : mInputs(inputs)
+        , mBatchSize(batchSize)
+        , mMaxBatches(maxBatches)
+        , mPrefetchDepth(std::max(prefetchDepth, 1))
+    {
+    }
+
+    CalibrationBatchReader(const CalibrationBatchReader&) = delete;
+    CalibrationBatchReader& operator=(const CalibrationBatchReader&) = delete;
+
+    ~CalibrationBatchReader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mSpaceCv.notify_all();
+        if (mThread.joinable())
+            mThread.join();
+    }
+
+    int getBatchSize() const { return mBatchSize; }
+
+    const std::vector<CalibrationInput>& getInputs() const { return mInputs; }
+
+    //!
+    //! \brief Returns the size in bytes of one batch of input.
+    //!
+    size_t getBatchBytes(int input) const { return sampleBytes(mInputs[input]) * mBatchSize; }
+
+    //!
+    //! \brief Wait for the next batch and move it into batch.
+    //!
+    //! \return false at the end of the data or after a read error, see getError().
+    //!
+    bool next(Batch& batch)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (!mThread.joinable())
+            mThread = std::thread(&CalibrationBatchReader::readAhead, this);
+        mReadyCv.wait(lock, [this]() { return !mReady.empty() || mDone; });
+        if (mReady.empty())
+            return false;
+        batch = std::move(mReady.front());
+        mReady.pop_front();
+        ++mConsumed;
+        lock.unlock();
+        mSpaceCv.notify_one();
+        return true;
+    }
+
+    //!
+    //! \brief Returns the number of batches returned by next() so far.
+    //!
+    int getNbBatchesRead() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mConsumed;
+    }
+
+    //!
+    //! \brief Returns why reading stopped early, or an empty string if it did not.
+    //!
+    std::string getError() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mError;
+    }
+
+private:
+    //! Read position in the files of one input.
+    struct Cursor
+    {
+        size_t nextFile{0};
+        TensorDataset dataset;
+        int64_t sample{0};
+        int64_t nbSamples{0};
+    };
+
+    static size_t sampleBytes(const CalibrationInput& input)
+    {
+        int64_t volume = 1;
+        for (int i = 0; i < input.dims.nbDims; i++)
+            volume *= input.dims.d[i];
+        return static_cast<size_t>(volume) * sizeof(float);
+    }
+
+    //!
+    //! \brief Copy the next count samples of input into dst, opening further files as needed.
+    //!
+    //! \return false at the end of the files or on error, which is then set.
+    //!
+    bool readSamples(const CalibrationInput& input, Cursor& cursor, int64_t count, char* dst, std::string& error)
+    {
+        const size_t bytes = sampleBytes(input);
+        while (count > 0)
+        {
+            if (cursor.sample == cursor.nbSamples)
+            {
+                if (cursor.nextFile == input.files.size())
+                    return false;
+                const std::string& file = input.files[cursor.nextFile++];
+                if (!cursor.dataset.open(file, nvinfer1::DataType::kFLOAT, input.dims, error))
+                    return false;
+                cursor.sample = 0;
+                cursor.nbSamples = cursor.dataset.getNbSamples();
+            }
+            int64_t n = std::min(count, cursor.nbSamples - cursor.sample);
+            cursor.dataset.copySamples(cursor.sample, n, dst);
+            cursor.sample += n;
+            dst += n * bytes;
+            count -= n;
+        }
+        return true;
+    }
+
+    void readAhead()
+    {
+        std::vector<Cursor> cursors(mInputs.size());
+        std::string error;
+        for (int b = 0; mMaxBatches <= 0 || b < mMaxBatches; b++)
+        {
+            Batch batch(mInputs.size());
+            bool complete{true};
+            for (size_t i = 0; i < mInputs.size() && complete; i++)
+            {
+                batch[i].resize(getBatchBytes(static_cast<int>(i)));
+                complete = readSamples(mInputs[i], cursors[i], mBatchSize, batch[i].data(), error);
+            }
+            if (!complete)
+                break;
+
+            std::unique_lock<std::mutex> lock(mMutex);
+            mSpaceCv.wait(lock, [this]() { return mReady.size() < static_cast<size_t>(mPrefetchDepth) || mStop; });
+            if (mStop)
+                return;
+            mReady.push_back(std::move(batch));
+            lock.unlock();
+            mReadyCv.notify_one();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mError = error;
+            mDone = true;
+        }
+        mReadyCv.notify_all();
+    }
+
+    std::vector<CalibrationInput> mInputs;
+    int mBatchSize;
+    int mMaxBatches;
+    int mPrefetchDepth;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mReadyCv; //!< Signalled when a batch is ready or reading has finished
+    std::condition_variable mSpaceCv; //!< Signalled when a batch has been consumed or the reader is destroyed
+    std::deque<Batch> mReady;
+    std::string mError;
+    int mConsumed{0};
+    bool mDone{false};
+    bool mStop{false};
+    std::thread mThread;
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_CALIBRATION_READER_H
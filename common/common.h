@@ -52,6 +52,8 @@
 
 #include "NvInfer.h"
 #include "NvInferPlugin.h"
+#include "engineCache.h"
+#include "jsonUtils.h"
 #include "logger.h"
 #include "NvOnnxConfig.h"
 #include "NvOnnxParser.h"
@@ -62,6 +64,7 @@
 #include <cstring>
 #include <cuda_runtime_api.h>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
@@ -109,12 +112,29 @@ struct SimpleProfiler : public nvinfer1::IProfiler
     {
         float time{0};
         int count{0};
+        std::vector<float> samples;
     };
 
     virtual void reportLayerTime(const char* layerName, float ms)
     {
-        mProfile[layerName].count++;
-        mProfile[layerName].time += ms;
+        auto it = mProfile.find(layerName);
+        if (it == mProfile.end())
+        {
+            it = mProfile.emplace(layerName, Record()).first;
+            mLayerIndices[layerName] = mLayerOrder.size();
+            mLayerOrder.push_back(layerName);
+        }
+        it->second.count++;
+        it->second.time += ms;
+        it->second.samples.push_back(ms);
+
+        // Layers are reported in execution order, so going back to an earlier layer starts a new invocation.
+        int index = mLayerIndices[it->first];
+        if (!mEvents.empty() && index <= mEvents.back().layer)
+        {
+            ++mInvocations;
+        }
+        mEvents.push_back(Event{index, mInvocations, ms});
     }
 
     SimpleProfiler(
@@ -124,17 +144,21 @@ struct SimpleProfiler : public nvinfer1::IProfiler
     {
         for (const auto& srcProfiler : srcProfilers)
         {
-            for (const auto& rec : srcProfiler.mProfile)
+            for (const auto& layerName : srcProfiler.mLayerOrder)
             {
-                auto it = mProfile.find(rec.first);
+                const Record& rec = srcProfiler.mProfile.at(layerName);
+                auto it = mProfile.find(layerName);
                 if (it == mProfile.end())
                 {
-                    mProfile.insert(rec);
+                    mProfile.insert(std::make_pair(layerName, rec));
+                    mLayerIndices[layerName] = mLayerOrder.size();
+                    mLayerOrder.push_back(layerName);
                 }
                 else
                 {
-                    it->second.time += rec.second.time;
-                    it->second.count += rec.second.count;
+                    it->second.time += rec.time;
+                    it->second.count += rec.count;
+                    it->second.samples.insert(it->second.samples.end(), rec.samples.begin(), rec.samples.end());
                 }
             }
         }
@@ -162,15 +186,25 @@ struct SimpleProfiler : public nvinfer1::IProfiler
                 << " ";
             out << std::setw(12) << "Invocations"
                 << " ";
-            out << std::setw(12) << "Runtime, ms" << std::endl;
+            out << std::setw(12) << "Runtime, ms"
+                << " ";
+            out << std::setw(12) << "Min, ms"
+                << " ";
+            out << std::setw(12) << "Median, ms"
+                << " ";
+            out << std::setw(12) << "Max, ms" << std::endl;
         }
         for (const auto& elem : value.mProfile)
         {
+            const Stats stats = getStats(elem.second);
             out << std::setw(maxLayerNameLength) << elem.first << " ";
             out << std::setw(12) << std::fixed << std::setprecision(1) << (elem.second.time * 100.0F / totalTime) << "%"
                 << " ";
             out << std::setw(12) << elem.second.count << " ";
-            out << std::setw(12) << std::fixed << std::setprecision(2) << elem.second.time << std::endl;
+            out << std::setw(12) << std::fixed << std::setprecision(2) << elem.second.time << " ";
+            out << std::setw(12) << std::setprecision(4) << stats.min << " ";
+            out << std::setw(12) << stats.median << " ";
+            out << std::setw(12) << stats.max << std::endl;
         }
         out.flags(old_settings);
         out.precision(old_precision);
@@ -179,9 +213,124 @@ struct SimpleProfiler : public nvinfer1::IProfiler
         return out;
     }
 
+    //!
+    //! \brief Write the per-layer statistics as one JSON document, with the layers in execution order.
+    //!
+    bool exportJson(const std::string& fileName) const
+    {
+        std::ofstream out(fileName);
+        if (!out)
+            return false;
+
+        float totalTime = 0;
+        for (const auto& elem : mProfile)
+            totalTime += elem.second.time;
+
+        out << "{\"name\":" << samplesCommon::jsonString(mName) << ",\"totalMs\":";
+        samplesCommon::jsonNumber(out, totalTime);
+        out << ",\"layers\":[";
+        for (size_t i = 0; i < mLayerOrder.size(); i++)
+        {
+            const Record& rec = mProfile.at(mLayerOrder[i]);
+            const Stats stats = getStats(rec);
+            out << (i ? ",\n" : "\n") << "{\"name\":" << samplesCommon::jsonString(mLayerOrder[i])
+                << ",\"invocations\":" << rec.count << ",\"totalMs\":";
+            samplesCommon::jsonNumber(out, rec.time);
+            out << ",\"averageMs\":";
+            samplesCommon::jsonNumber(out, rec.count ? rec.time / rec.count : 0);
+            out << ",\"minMs\":";
+            samplesCommon::jsonNumber(out, stats.min);
+            out << ",\"medianMs\":";
+            samplesCommon::jsonNumber(out, stats.median);
+            out << ",\"maxMs\":";
+            samplesCommon::jsonNumber(out, stats.max);
+            out << ",\"percentage\":";
+            samplesCommon::jsonNumber(out, rec.time * 100.0F / totalTime);
+            out << "}";
+        }
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+
+    //!
+    //! \brief Write every recorded layer execution as a Chrome trace_event timeline (chrome://tracing, Perfetto).
+    //! \details The profiler only reports durations, so layers are laid out back to back on a single track, and each
+    //!          invocation of the network is emitted as an enclosing event.
+    //!
+    bool exportTrace(const std::string& fileName) const
+    {
+        std::ofstream out(fileName);
+        if (!out)
+            return false;
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        double timestamp = 0; // microseconds
+        bool first = true;
+        for (size_t begin = 0; begin < mEvents.size();)
+        {
+            size_t end = begin;
+            double duration = 0;
+            for (; end < mEvents.size() && mEvents[end].invocation == mEvents[begin].invocation; end++)
+                duration += mEvents[end].ms * 1000.0;
+
+            writeTraceEvent(out, first, "Invocation " + std::to_string(mEvents[begin].invocation), "invocation", timestamp, duration);
+            for (size_t i = begin; i < end; i++)
+            {
+                writeTraceEvent(out, first, mLayerOrder[mEvents[i].layer], "layer", timestamp, mEvents[i].ms * 1000.0);
+                timestamp += mEvents[i].ms * 1000.0;
+            }
+            begin = end;
+        }
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+
 private:
+    struct Event
+    {
+        int layer;
+        int invocation;
+        float ms;
+    };
+
+    struct Stats
+    {
+        float min{0};
+        float median{0};
+        float max{0};
+    };
+
+    static Stats getStats(const Record& rec)
+    {
+        Stats stats;
+        if (rec.samples.empty())
+            return stats;
+        std::vector<float> sorted(rec.samples);
+        std::sort(sorted.begin(), sorted.end());
+        stats.min = sorted.front();
+        stats.max = sorted.back();
+        size_t mid = sorted.size() / 2;
+        stats.median = sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+        return stats;
+    }
+
+    static void writeTraceEvent(std::ostream& out, bool& first, const std::string& name, const char* category, double ts, double dur)
+    {
+        out << (first ? "\n" : ",\n") << "{\"name\":" << samplesCommon::jsonString(name) << ",\"cat\":\"" << category
+            << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":";
+        samplesCommon::jsonNumber(out, ts);
+        out << ",\"dur\":";
+        samplesCommon::jsonNumber(out, dur);
+        out << "}";
+        first = false;
+    }
+
     std::string mName;
     std::map<std::string, Record> mProfile;
+    std::vector<std::string> mLayerOrder;
+    std::map<std::string, int> mLayerIndices;
+    std::vector<Event> mEvents;
+    int mInvocations{0};
 };
 
 // Locate path to file, given its filename or filepath suffix and possible dirs it might lie in
@@ -493,6 +642,73 @@ inline void enableDLA(IBuilder* b, int useDLACore, bool allowGPUFallback = true)
     }
 }
 
+//!
+//! \brief Start an engine cache key with what every plan depends on besides the model and the builder settings:
+//!        the TensorRT version and the GPU it is built for.
+//!
+inline EngineCacheKey createEngineCacheKey()
+{
+    int device{0};
+    cudaDeviceProp prop;
+    CHECK(cudaGetDevice(&device));
+    CHECK(cudaGetDeviceProperties(&prop, device));
+
+    EngineCacheKey key;
+    key.addSetting("tensorrt", NV_TENSORRT_MAJOR * 1000 + NV_TENSORRT_MINOR * 100 + NV_TENSORRT_PATCH)
+        .addSetting("tensorrtBuild", NV_TENSORRT_BUILD)
+        .addSetting("gpu", prop.name)
+        .addSetting("computeCapability", prop.major * 10 + prop.minor);
+    return key;
+}
+
+//!
+//! \class MappedHostMemory
+//! \brief IHostMemory that owns the mapping of a plan file, so it can be used and destroyed like a serialized
+//!        engine.
+//!
+class MappedHostMemory : public IHostMemory
+{
+public:
+    explicit MappedHostMemory(MappedFile&& file)
+        : mFile(std::move(file))
+    {
+    }
+
+    // The mapping is read-only; TensorRT only reads plans passed to deserializeCudaEngine().
+    void* data() const override { return const_cast<void*>(mFile.data()); }
+    std::size_t size() const override { return mFile.size(); }
+    DataType type() const override { return DataType::kINT8; }
+    void destroy() override { delete this; }
+
+private:
+    MappedFile mFile;
+};
+
+//!
+//! \brief Returns the plan cached under key, or the plan returned by build(), which is then added to the cache.
+//!
+//! \details With a disabled cache this is just build(). The result is destroyed by the caller either way.
+//!
+inline IHostMemory* loadOrBuildPlan(const EngineCache& cache, const EngineCacheKey& key, const std::function<IHostMemory*()>& build)
+{
+    MappedFile plan;
+    if (cache.load(key.str(), plan))
+    {
+        gLogInfo << "Loaded cached engine " << cache.getPath(key.str()) << std::endl;
+        return new MappedHostMemory(std::move(plan));
+    }
+
+    IHostMemory* built = build();
+    if (built && cache.isEnabled())
+    {
+        if (cache.store(key.str(), built->data(), built->size()))
+            gLogInfo << "Engine has been cached as " << cache.getPath(key.str()) << std::endl;
+        else
+            gLogWarning << "Could not write " << cache.getPath(key.str()) << ": " << strerror(errno) << std::endl;
+    }
+    return built;
+}
+
 inline int parseDLA(int argc, char** argv)
 {
     for (int i = 1; i < argc; i++)
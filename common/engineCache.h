@@ -0,0 +1,287 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_ENGINE_CACHE_H
+#define TENSORRT_ENGINE_CACHE_H
+
+#include "hashUtils.h"
+#include "mappedFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \class EngineCacheKey
+//! \brief Fingerprint of everything a serialized engine depends on.
+//!
+//! \details Files are hashed by content, not by name or timestamp, so touching or copying a model does not
+//!          invalidate its plan while editing it does. Settings are hashed as name=value pairs in the order added.
+//!
+class EngineCacheKey
+{
+public:
+    //!
+    //! \brief Hash the contents of fileName. A missing or empty file hashes differently from every other file, so that
+    //!        e.g. a calibration cache that appears later produces a new key.
+    //!
+    EngineCacheKey& addFile(const std::string& fileName)
+    {
+        MappedFile file;
+        if (file.open(fileName))
+        {
+            uint64_t size = file.size();
+            mHash.update("file:", 5).update(&size, sizeof(size)).update(file.data(), file.size());
+        }
+        else
+        {
+            mHash.update("missing:", 8);
+        }
+        return *this;
+    }
+
+    template <typename T>
+    EngineCacheKey& addSetting(const std::string& name, const T& value)
+    {
+        std::ostringstream ss;
+        ss << name << "=" << value << ";";
+        mHash.update(ss.str());
+        return *this;
+    }
+
+    std::string str() const { return mHash.hexDigest(); }
+
+private:
+    Fnv1aHash mHash;
+};
+
+//!
+//! \class EngineCache
+//! \brief Directory of serialized engines named by their EngineCacheKey, evicted least recently used first.
+//!
+//! \details Plans are written to a temporary file in the cache directory and renamed into place, so concurrent
+//!          readers never see a partial plan. Loading a plan refreshes its modification time, which is what
+//!          eviction orders by.
+//!
+class EngineCache
+{
+public:
+    static constexpr uint64_t kDEFAULT_MAX_BYTES = 4ULL << 30;
+
+    //!
+    //! \param directory Cache directory, created on the first store. An empty directory disables the cache.
+    //! \param maxBytes Total size of the plans kept after a store. The plan just stored is always kept.
+    //!
+    explicit EngineCache(const std::string& directory, uint64_t maxBytes = kDEFAULT_MAX_BYTES)
+        : mDirectory(directory)
+        , mMaxBytes(maxBytes)
+    {
+    }
+
+    bool isEnabled() const { return !mDirectory.empty(); }
+
+    std::string getPath(const std::string& key) const { return mDirectory + "/" + key + kEXTENSION; }
+
+    //!
+    //! \brief Map the plan stored under key, so that it can be deserialized without copying it first.
+    //!
+    //! \return false on a miss.
+    //!
+    bool load(const std::string& key, MappedFile& plan, MappedFile::AccessHint hint = MappedFile::AccessHint::kNONE) const
+    {
+        if (!isEnabled())
+            return false;
+        const std::string path = getPath(key);
+        if (!plan.open(path, hint))
+            return false;
+        // Mark the entry as recently used.
+        utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+        return true;
+    }
+
+    //!
+    //! \brief Atomically store a plan under key, then evict the least recently used plans beyond the size limit.
+    //!
+    //! \return false if the plan could not be written; errno describes the failure.
+    //!
+    bool store(const std::string& key, const void* data, size_t size) const
+    {
+        if (!isEnabled() || !createDirectories(mDirectory))
+            return false;
+
+        const std::string path = getPath(key);
+        std::ostringstream tmp;
+        tmp << path << ".tmp." << getpid();
+        const std::string tmpPath = tmp.str();
+
+        int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            return false;
+        const char* bytes = static_cast<const char*>(data);
+        size_t written = 0;
+        while (written < size)
+        {
+            ssize_t n = ::write(fd, bytes + written, size - written);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                break;
+            written += static_cast<size_t>(n);
+        }
+        bool ok = written == size && fsync(fd) == 0;
+        ok = ::close(fd) == 0 && ok;
+        if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0)
+        {
+            int error = errno;
+            std::remove(tmpPath.c_str());
+            errno = error;
+            return false;
+        }
+
+        evict(key);
+        return true;
+    }
+
+    //!
+    //! \brief Remove the least recently used plans until the cache fits in its size limit. keep is never removed.
+    //!
+    //! \return The number of plans removed.
+    //!
+    int evict(const std::string& keep = std::string()) const
+    {
+        std::vector<Entry> entries = list();
+        uint64_t total = 0;
+        for (const auto& e : entries)
+            total += e.size;
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            return a.mtimeNs < b.mtimeNs;
+        });
+        int removed = 0;
+        for (const auto& e : entries)
+        {
+            if (total <= mMaxBytes)
+                break;
+            if (e.key == keep)
+                continue;
+            if (std::remove(getPath(e.key).c_str()) == 0)
+            {
+                total -= e.size;
+                removed++;
+            }
+        }
+        return removed;
+    }
+
+    struct Entry
+    {
+        std::string key;
+        uint64_t size;
+        int64_t mtimeNs;
+    };
+
+    //!
+    //! \brief Returns the plans currently in the cache, in no particular order.
+    //!
+    std::vector<Entry> list() const
+    {
+        std::vector<Entry> entries;
+        DIR* dir = opendir(mDirectory.c_str());
+        if (!dir)
+            return entries;
+        const std::string ext = kEXTENSION;
+        while (const dirent* d = readdir(dir))
+        {
+            std::string name = d->d_name;
+            if (name.size() <= ext.size() || name.compare(name.size() - ext.size(), ext.size(), ext) != 0)
+                continue;
+            struct stat st;
+            if (stat((mDirectory + "/" + name).c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+                continue;
+            int64_t mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+            entries.push_back(Entry{name.substr(0, name.size() - ext.size()), static_cast<uint64_t>(st.st_size), mtimeNs});
+        }
+        closedir(dir);
+        return entries;
+    }
+
+private:
+    static constexpr const char* kEXTENSION = ".plan";
+
+    //! mkdir -p
+    static bool createDirectories(const std::string& path)
+    {
+        for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1))
+        {
+            const std::string prefix = path.substr(0, pos);
+            if (!prefix.empty() && mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST)
+                return false;
+            if (pos == std::string::npos)
+                return true;
+        }
+    }
+
+    std::string mDirectory;
+    uint64_t mMaxBytes;
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_ENGINE_CACHE_H
@@ -0,0 +1,131 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_HOST_MEMORY_H
+#define TENSORRT_HOST_MEMORY_H
+
+#include "bufferPool.h"
+#include <cstddef>
+#include <cstdlib>
+#include <sys/mman.h>
+
+namespace samplesCommon
+{
+
+//! Alignment of aligned, huge-page and pooled host allocations: one cache line, and enough for any vector load.
+constexpr size_t kHOST_ALIGNMENT = 64;
+
+//! Size of a transparent huge page on x86-64 and most aarch64 kernels.
+constexpr size_t kHUGE_PAGE_SIZE = size_t(2) << 20;
+
+//!
+//! \brief Round size up to a multiple of alignment, which must be a power of two. A size of 0 counts as 1.
+//!
+inline size_t roundUp(size_t size, size_t alignment)
+{
+    return ((size ? size : 1) + alignment - 1) & ~(alignment - 1);
+}
+
+//!
+//! \brief Allocate size bytes aligned to alignment, a power of two multiple of sizeof(void*).
+//!        Returns nullptr on failure. Release with free().
+//!
+inline void* alignedAlloc(size_t size, size_t alignment = kHOST_ALIGNMENT)
+{
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, roundUp(size, alignment)) != 0)
+        return nullptr;
+    return ptr;
+}
+
+//!
+//! \brief Allocate size bytes, rounded up to whole huge pages, and ask the kernel to back them with transparent
+//!        huge pages. Returns nullptr on failure. Release with free().
+//!
+//! \details Large staging buffers then take one TLB entry per 2 MB instead of one per 4 KB. The advice is only a
+//!          hint: if transparent huge pages are disabled the memory is still valid and uses normal pages.
+//!
+inline void* hugePageAlloc(size_t size)
+{
+    size_t bytes = roundUp(size, kHUGE_PAGE_SIZE);
+    void* ptr = alignedAlloc(bytes, kHUGE_PAGE_SIZE);
+#ifdef MADV_HUGEPAGE
+    if (ptr)
+        madvise(ptr, bytes, MADV_HUGEPAGE);
+#endif
+    return ptr;
+}
+
+//!
+//! \brief Allocation functor of kHOST_ALIGNMENT aligned host blocks, with the signature GenericBuffer expects.
+//!
+class AlignedHostAllocator
+{
+public:
+    bool operator()(void** ptr, size_t size) const
+    {
+        *ptr = alignedAlloc(size);
+        return *ptr != nullptr;
+    }
+};
+
+class AlignedHostFree
+{
+public:
+    void operator()(void* ptr) const { free(ptr); }
+};
+
+//!
+//! \brief Pool of aligned host blocks. HostMemoryPool::instance() backs HostMemoryType::kPOOLED.
+//!
+using HostMemoryPool = BufferPool<AlignedHostAllocator, AlignedHostFree>;
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_HOST_MEMORY_H
@@ -0,0 +1,173 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_HOST_TIMERS_H
+#define TENSORRT_HOST_TIMERS_H
+
+#include "latencyHistogram.h"
+#include <chrono>
+#include <ostream>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+namespace samplesCommon
+{
+
+//!
+//! \class ScopedTimer
+//! \brief Records the host walltime of a scope into a LatencyHistogram when it ends.
+//!
+//! \details A null histogram disables the timer without reading the clock, so timers can stay in hot paths.
+//!
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(LatencyHistogram* histogram)
+        : mHistogram(histogram)
+    {
+        if (mHistogram)
+            mStart = std::chrono::high_resolution_clock::now();
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer()
+    {
+        if (mHistogram)
+            mHistogram->record(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - mStart).count());
+    }
+
+private:
+    LatencyHistogram* mHistogram;
+    std::chrono::high_resolution_clock::time_point mStart;
+};
+
+//!
+//! \class CpuUsage
+//! \brief CPU time and context switches of the whole process over an interval, from getrusage(RUSAGE_SELF).
+//!
+//! \details Utilization is CPU time over walltime, so 1.0 means one core fully busy. A process that blocks in
+//!          cudaEventSynchronize accumulates voluntary context switches; one that spins or is launch bound
+//!          stays close to one core per host thread.
+//!
+class CpuUsage
+{
+public:
+    //!
+    //! \brief Start a new interval.
+    //!
+    void start()
+    {
+        getrusage(RUSAGE_SELF, &mStartUsage);
+        mStartWall = std::chrono::high_resolution_clock::now();
+        mStopped = false;
+    }
+
+    //!
+    //! \brief End the interval; the accessors then report it.
+    //!
+    void stop()
+    {
+        getrusage(RUSAGE_SELF, &mStopUsage);
+        mStopWall = std::chrono::high_resolution_clock::now();
+        mStopped = true;
+    }
+
+    double wallMs() const { return std::chrono::duration<double, std::milli>(end() - mStartWall).count(); }
+    double userMs() const { return toMs(stopUsage().ru_utime) - toMs(mStartUsage.ru_utime); }
+    double systemMs() const { return toMs(stopUsage().ru_stime) - toMs(mStartUsage.ru_stime); }
+    long voluntarySwitches() const { return stopUsage().ru_nvcsw - mStartUsage.ru_nvcsw; }
+    long involuntarySwitches() const { return stopUsage().ru_nivcsw - mStartUsage.ru_nivcsw; }
+
+    //!
+    //! \brief Returns the CPU time (user and system) per walltime, in cores.
+    //!
+    double utilization() const
+    {
+        const double wall = wallMs();
+        return wall > 0 ? (userMs() + systemMs()) / wall : 0.0;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const CpuUsage& usage)
+    {
+        os << usage.utilization() << " cores (user " << usage.userMs() << " ms, system " << usage.systemMs()
+           << " ms over " << usage.wallMs() << " ms), " << usage.voluntarySwitches() << " voluntary and "
+           << usage.involuntarySwitches() << " involuntary context switches";
+        return os;
+    }
+
+private:
+    static double toMs(const timeval& t) { return t.tv_sec * 1000.0 + t.tv_usec / 1000.0; }
+
+    //! Before stop(), the interval extends to now.
+    rusage stopUsage() const
+    {
+        if (mStopped)
+            return mStopUsage;
+        rusage now;
+        getrusage(RUSAGE_SELF, &now);
+        return now;
+    }
+
+    std::chrono::high_resolution_clock::time_point end() const
+    {
+        return mStopped ? mStopWall : std::chrono::high_resolution_clock::now();
+    }
+
+    rusage mStartUsage{};
+    rusage mStopUsage{};
+    std::chrono::high_resolution_clock::time_point mStartWall;
+    std::chrono::high_resolution_clock::time_point mStopWall;
+    bool mStopped{false};
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_HOST_TIMERS_H
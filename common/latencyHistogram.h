@@ -0,0 +1,224 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_LATENCY_HISTOGRAM_H
+#define TENSORRT_LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+
+namespace samplesCommon
+{
+
+//!
+//! \class LatencyHistogram
+//! \brief Constant-memory histogram of latencies in milliseconds.
+//!
+//! \details Samples are counted in log-spaced buckets: every power of two between kMIN_EXPONENT and kMAX_EXPONENT
+//!          is split into kSUB_BUCKETS linear sub-buckets, which bounds the relative error of any reported
+//!          percentile to 1 / kSUB_BUCKETS. Exact min, max, mean and standard deviation are tracked on the side.
+//!          The class holds no pointers, so it can be copied, merged across threads, or placed in shared memory.
+//!
+class LatencyHistogram
+{
+public:
+    static const int kSUB_BUCKETS = 64;   //!< Linear sub-buckets per power of two
+    static const int kMIN_EXPONENT = -14; //!< Smallest resolved latency is 2^-14 ms (~61 ns)
+    static const int kMAX_EXPONENT = 22;  //!< Largest resolved latency is 2^22 ms (~70 min)
+    static const int kNB_BUCKETS = (kMAX_EXPONENT - kMIN_EXPONENT) * kSUB_BUCKETS + 2; //!< Includes under/overflow
+
+    LatencyHistogram() { reset(); }
+
+    //!
+    //! \brief Discard all recorded samples.
+    //!
+    void reset()
+    {
+        std::memset(mBuckets, 0, sizeof(mBuckets));
+        mCount = 0;
+        mMean = 0.0;
+        mM2 = 0.0;
+        mMin = std::numeric_limits<double>::infinity();
+        mMax = -std::numeric_limits<double>::infinity();
+    }
+
+    //!
+    //! \brief Record one latency sample, in milliseconds.
+    //!
+    void record(double ms)
+    {
+        ++mBuckets[bucketIndex(ms)];
+        ++mCount;
+        // Welford's update keeps the variance numerically stable over millions of samples.
+        const double delta = ms - mMean;
+        mMean += delta / static_cast<double>(mCount);
+        mM2 += delta * (ms - mMean);
+        mMin = std::min(mMin, ms);
+        mMax = std::max(mMax, ms);
+    }
+
+    //!
+    //! \brief Add all samples of another histogram to this one.
+    //!
+    void merge(const LatencyHistogram& other)
+    {
+        if (other.mCount == 0)
+            return;
+        for (int i = 0; i < kNB_BUCKETS; i++)
+            mBuckets[i] += other.mBuckets[i];
+
+        const double n1 = static_cast<double>(mCount);
+        const double n2 = static_cast<double>(other.mCount);
+        const double delta = other.mMean - mMean;
+        mCount += other.mCount;
+        mMean += delta * n2 / (n1 + n2);
+        mM2 += other.mM2 + delta * delta * n1 * n2 / (n1 + n2);
+        mMin = std::min(mMin, other.mMin);
+        mMax = std::max(mMax, other.mMax);
+    }
+
+    uint64_t count() const { return mCount; }
+    double min() const { return mCount ? mMin : 0.0; }
+    double max() const { return mCount ? mMax : 0.0; }
+    double mean() const { return mMean; }
+    double sum() const { return mMean * static_cast<double>(mCount); }
+
+    //!
+    //! \brief Returns the sample standard deviation, or 0 with fewer than two samples.
+    //!
+    double stddev() const
+    {
+        return mCount > 1 ? std::sqrt(mM2 / static_cast<double>(mCount - 1)) : 0.0;
+    }
+
+    //!
+    //! \brief Returns the latency at percentage pct (0 <= pct <= 100).
+    //!        0 returns the minimum and 100 the maximum; other values are accurate to one bucket width.
+    //!
+    double percentile(double pct) const
+    {
+        if (mCount == 0)
+            return 0.0;
+        if (pct <= 0)
+            return mMin;
+        if (pct >= 100)
+            return mMax;
+
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(pct / 100.0 * static_cast<double>(mCount))));
+        uint64_t seen = 0;
+        for (int i = 0; i < kNB_BUCKETS; i++)
+        {
+            seen += mBuckets[i];
+            if (seen >= rank)
+                return std::min(std::max(bucketMidpoint(i), mMin), mMax);
+        }
+        return mMax;
+    }
+
+    //!
+    //! \brief Print count, min, mean, stddev, the standard percentiles and max on one line.
+    //!
+    friend std::ostream& operator<<(std::ostream& os, const LatencyHistogram& h)
+    {
+        auto oldFlags = os.flags();
+        auto oldPrecision = os.precision();
+        os << std::fixed << std::setprecision(5);
+        os << "count = " << h.count() << ", min = " << h.min() << " ms, mean = " << h.mean()
+           << " ms, stddev = " << h.stddev() << " ms, p50 = " << h.percentile(50) << " ms, p90 = " << h.percentile(90)
+           << " ms, p95 = " << h.percentile(95) << " ms, p99 = " << h.percentile(99)
+           << " ms, p99.9 = " << h.percentile(99.9) << " ms, max = " << h.max() << " ms";
+        os.flags(oldFlags);
+        os.precision(oldPrecision);
+        return os;
+    }
+
+private:
+    static int bucketIndex(double ms)
+    {
+        if (!(ms > 0))
+            return 0;
+        int exponent;
+        // ms = mantissa * 2^exponent with mantissa in [0.5, 1)
+        const double mantissa = std::frexp(ms, &exponent);
+        if (exponent <= kMIN_EXPONENT)
+            return 0;
+        if (exponent > kMAX_EXPONENT)
+            return kNB_BUCKETS - 1;
+        const int sub = std::min(kSUB_BUCKETS - 1, static_cast<int>((mantissa - 0.5) * 2 * kSUB_BUCKETS));
+        return 1 + (exponent - kMIN_EXPONENT - 1) * kSUB_BUCKETS + sub;
+    }
+
+    static double bucketMidpoint(int index)
+    {
+        if (index == 0)
+            return std::ldexp(0.5, kMIN_EXPONENT);
+        if (index == kNB_BUCKETS - 1)
+            return std::ldexp(1.0, kMAX_EXPONENT);
+        const int exponent = (index - 1) / kSUB_BUCKETS + kMIN_EXPONENT + 1;
+        const int sub = (index - 1) % kSUB_BUCKETS;
+        const double mantissa = 0.5 + (sub + 0.5) / (2.0 * kSUB_BUCKETS);
+        return std::ldexp(mantissa, exponent);
+    }
+
+    uint64_t mBuckets[kNB_BUCKETS];
+    uint64_t mCount;
+    double mMean;
+    double mM2;
+    double mMin;
+    double mMax;
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_LATENCY_HISTOGRAM_H
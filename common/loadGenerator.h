@@ -0,0 +1,303 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_LOAD_GENERATOR_H
+#define TENSORRT_LOAD_GENERATOR_H
+
+#include "latencyHistogram.h"
+#include "streamRunner.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \enum ArrivalProcess
+//! \brief Distribution of the gaps between consecutive requests of an open-loop load.
+//!
+enum class ArrivalProcess
+{
+    kUNIFORM, //!< Requests arrive exactly 1/qps apart
+    kPOISSON  //!< Gaps are exponentially distributed with mean 1/qps
+};
+
+//!
+//! \class ArrivalSchedule
+//! \brief Generates the arrival offsets of an open-loop load, in seconds from the start of the run.
+//!
+class ArrivalSchedule
+{
+public:
+    ArrivalSchedule(double qps, ArrivalProcess process, unsigned int seed = 0)
+        : mProcess(process)
+        , mMeanGap(1.0 / qps)
+        , mGenerator(seed)
+        , mExponential(qps)
+    {
+    }
+
+    //!
+    //! \brief Returns the offset of the next arrival.
+    //!
+    double next()
+    {
+        mNow += mProcess == ArrivalProcess::kPOISSON ? mExponential(mGenerator) : mMeanGap;
+        return mNow;
+    }
+
+private:
+    ArrivalProcess mProcess;
+    double mMeanGap;
+    double mNow{0.0};
+    std::mt19937 mGenerator;
+    std::exponential_distribution<double> mExponential;
+};
+
+//!
+//! \class BoundedQueue
+//! \brief Fixed-capacity FIFO shared between one producer and several consumers.
+//!
+//! \details push() never blocks: a full queue rejects the item, which is how an open-loop load sheds requests
+//!          it cannot absorb. pop() blocks until an item is available or the queue has been closed and drained.
+//!
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity)
+        : mCapacity(capacity)
+    {
+    }
+
+    bool push(const T& item)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mClosed || mItems.size() >= mCapacity)
+                return false;
+            mItems.push_back(item);
+        }
+        mCv.notify_one();
+        return true;
+    }
+
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCv.wait(lock, [this]() { return mClosed || !mItems.empty(); });
+        if (mItems.empty())
+            return false;
+        item = mItems.front();
+        mItems.pop_front();
+        return true;
+    }
+
+    //!
+    //! \brief Reject further pushes and wake all consumers once the queue is empty.
+    //!
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mClosed = true;
+        }
+        mCv.notify_all();
+    }
+
+private:
+    size_t mCapacity;
+    bool mClosed{false};
+    std::deque<T> mItems;
+    std::mutex mMutex;
+    std::condition_variable mCv;
+};
+
+//!
+//! \brief Results of one open-loop run at a fixed offered load.
+//!
+struct LoadPointStats
+{
+    double offeredQps{0.0};
+    double achievedQps{0.0};
+    uint64_t completed{0};
+    uint64_t dropped{0};        //!< Requests rejected because the queue was full
+    LatencyHistogram queueing;  //!< Arrival to start of service
+    LatencyHistogram service;   //!< Duration of IInferenceStream::infer
+    LatencyHistogram total;     //!< Arrival to completion
+};
+
+//!
+//! \class OpenLoopRunner
+//! \brief Drives a set of IInferenceStreams with requests arriving at a target rate, independently of how fast
+//!        they are served.
+//!
+//! \details A generator thread pushes requests into a BoundedQueue following an ArrivalSchedule; one worker thread
+//!          per stream pops and serves them. Queueing delay and service time are recorded separately, so the
+//!          effect of load on latency is visible, which back-to-back (closed-loop) runs hide. Each worker prepares
+//!          its stream while it waits for the next request, so input staging is not part of the service time.
+//!
+class OpenLoopRunner
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    OpenLoopRunner(const std::vector<IInferenceStream*>& streams, size_t queueCapacity, ArrivalProcess process, unsigned int seed = 0)
+        : mStreams(streams)
+        , mQueueCapacity(queueCapacity)
+        , mProcess(process)
+        , mSeed(seed)
+    {
+    }
+
+    //!
+    //! \brief Offer nbRequests requests at qps requests per second and wait until all accepted ones are served.
+    //!
+    //! \return false if any inference failed. The run then stops at once: requests still scheduled are neither
+    //!         offered nor counted as dropped.
+    //!
+    bool run(double qps, int nbRequests, LoadPointStats& stats)
+    {
+        BoundedQueue<Clock::time_point> queue(mQueueCapacity);
+        std::vector<LoadPointStats> partial(mStreams.size());
+        std::atomic<bool> failed{false};
+        std::mutex failedMutex;
+        std::condition_variable failedCv;
+
+        std::vector<std::thread> workers;
+        for (size_t s = 0; s < mStreams.size(); s++)
+        {
+            workers.emplace_back([&, s]() {
+                Clock::time_point arrival;
+                mStreams[s]->bindThread();
+                mStreams[s]->prepare();
+                while (queue.pop(arrival))
+                {
+                    float gpuMs{-1.0f};
+                    Clock::time_point start = Clock::now();
+                    bool ok = mStreams[s]->infer(gpuMs);
+                    Clock::time_point end = Clock::now();
+                    if (!ok)
+                    {
+                        {
+                            std::lock_guard<std::mutex> lock(failedMutex);
+                            failed = true;
+                        }
+                        failedCv.notify_all();
+                        queue.close();
+                        return;
+                    }
+                    partial[s].queueing.record(toMs(start - arrival));
+                    partial[s].service.record(toMs(end - start));
+                    partial[s].total.record(toMs(end - arrival));
+                    ++partial[s].completed;
+                    mStreams[s]->prepare();
+                }
+            });
+        }
+
+        uint64_t dropped{0};
+        ArrivalSchedule schedule(qps, mProcess, mSeed);
+        Clock::time_point runStart = Clock::now();
+        for (int i = 0; i < nbRequests; i++)
+        {
+            Clock::time_point arrival = runStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(schedule.next()));
+            {
+                // Wait for the arrival, but wake up on a failure instead of sleeping through the rest of the schedule.
+                std::unique_lock<std::mutex> lock(failedMutex);
+                if (failedCv.wait_until(lock, arrival, [&failed]() { return failed.load(); }))
+                    break;
+            }
+            // The arrival time, not the time of the push, is what the request is charged from. A worker sets failed
+            // before it closes the queue, so a push rejected by the closed queue is not mistaken for a drop.
+            if (!queue.push(arrival))
+            {
+                if (failed)
+                    break;
+                ++dropped;
+            }
+        }
+        queue.close();
+        for (auto& w : workers)
+            w.join();
+        double wallMs = toMs(Clock::now() - runStart);
+
+        stats = LoadPointStats();
+        stats.offeredQps = qps;
+        stats.dropped = dropped;
+        for (const auto& p : partial)
+        {
+            stats.queueing.merge(p.queueing);
+            stats.service.merge(p.service);
+            stats.total.merge(p.total);
+            stats.completed += p.completed;
+        }
+        stats.achievedQps = wallMs > 0 ? stats.completed * 1000.0 / wallMs : 0.0;
+        return !failed;
+    }
+
+private:
+    static double toMs(Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); }
+
+    std::vector<IInferenceStream*> mStreams;
+    size_t mQueueCapacity;
+    ArrivalProcess mProcess;
+    unsigned int mSeed;
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_LOAD_GENERATOR_H
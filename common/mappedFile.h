@@ -0,0 +1,186 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_MAPPED_FILE_H
+#define TENSORRT_MAPPED_FILE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace samplesCommon
+{
+
+//!
+//! \class MappedFile
+//! \brief RAII read-only memory mapping of a whole file.
+//!
+//! \details Pages are loaded on first access and shared with the page cache, so large inputs or plans can be
+//!          consumed in place instead of being read into an intermediate buffer.
+//!
+class MappedFile
+{
+public:
+    //!
+    //! \brief How the mapping is going to be read, so the kernel can fault pages in ahead of use.
+    //!
+    enum class AccessHint
+    {
+        kNONE,       //!< Demand paging only.
+        kPOPULATE,   //!< Read the whole file while mapping it (MAP_POPULATE); open() returns once it is resident.
+        kWILLNEED,   //!< Start reading the whole file in the background (MADV_WILLNEED).
+        kSEQUENTIAL, //!< Read ahead aggressively and drop pages behind the reader (MADV_SEQUENTIAL).
+    };
+
+    MappedFile() = default;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other)
+        : mData(other.mData)
+        , mSize(other.mSize)
+    {
+        other.mData = nullptr;
+        other.mSize = 0;
+    }
+
+    MappedFile& operator=(MappedFile&& other)
+    {
+        if (this != &other)
+        {
+            close();
+            mData = other.mData;
+            mSize = other.mSize;
+            other.mData = nullptr;
+            other.mSize = 0;
+        }
+        return *this;
+    }
+
+    ~MappedFile() { close(); }
+
+    //!
+    //! \brief Map fileName, replacing any previous mapping.
+    //!
+    //! \return false if the file cannot be opened, is empty or cannot be mapped; errno describes the failure, and is
+    //!         EINVAL for an empty file, which cannot be mapped.
+    //!
+    bool open(const std::string& fileName, AccessHint hint = AccessHint::kNONE)
+    {
+        close();
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        int error = fstat(fd, &st) != 0 ? errno : st.st_size == 0 ? EINVAL : 0;
+        if (error)
+        {
+            ::close(fd);
+            errno = error;
+            return false;
+        }
+
+        int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        if (hint == AccessHint::kPOPULATE)
+            flags |= MAP_POPULATE;
+#endif
+        void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, flags, fd, 0);
+        // The mapping keeps its own reference to the file. Keep the errno of mmap for the caller.
+        error = errno;
+        ::close(fd);
+        errno = error;
+        if (data == MAP_FAILED)
+            return false;
+
+        mData = data;
+        mSize = static_cast<size_t>(st.st_size);
+        advise(hint);
+        return true;
+    }
+
+    //!
+    //! \brief Pass an access hint for the whole mapping to the kernel. Hints are advisory, so failures are ignored.
+    //!
+    void advise(AccessHint hint) const
+    {
+        if (!mData)
+            return;
+        if (hint == AccessHint::kWILLNEED)
+            madvise(mData, mSize, MADV_WILLNEED);
+        else if (hint == AccessHint::kSEQUENTIAL)
+            madvise(mData, mSize, MADV_SEQUENTIAL);
+    }
+
+    void close()
+    {
+        if (mData)
+            munmap(mData, mSize);
+        mData = nullptr;
+        mSize = 0;
+    }
+
+    bool isOpen() const { return mData != nullptr; }
+    const void* data() const { return mData; }
+    size_t size() const { return mSize; }
+
+private:
+    void* mData{nullptr};
+    size_t mSize{0};
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_MAPPED_FILE_H
@@ -0,0 +1,371 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_MULTI_PROCESS_H
+#define TENSORRT_MULTI_PROCESS_H
+
+#include "latencyHistogram.h"
+#include "streamRunner.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <semaphore.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \class Semaphore
+//! \brief Named POSIX semaphore shared by a parent and the children it forks after open().
+//!
+//! \details The name is unlinked when the owner's object is destroyed. Children that leave through exit() keep it.
+//!
+class Semaphore
+{
+public:
+    Semaphore(const std::string& semName)
+        : mSemName(semName)
+    {
+    }
+
+    Semaphore(const Semaphore&) = delete;
+    Semaphore& operator=(const Semaphore&) = delete;
+
+    ~Semaphore()
+    {
+        if (mSemEngine != SEM_FAILED)
+        {
+            sem_unlink(mSemName.c_str());
+            sem_close(mSemEngine);
+        }
+    }
+
+    void wait()
+    {
+        while (sem_wait(mSemEngine) != 0 && errno == EINTR)
+        {
+        }
+    }
+
+    //!
+    //! \brief Wait at most timeoutMs milliseconds. Returns false on timeout.
+    //!
+    bool waitFor(int timeoutMs)
+    {
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeoutMs / 1000;
+        deadline.tv_nsec += static_cast<long>(timeoutMs % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        int status;
+        while ((status = sem_timedwait(mSemEngine, &deadline)) != 0 && errno == EINTR)
+        {
+        }
+        return status == 0;
+    }
+
+    void post()
+    {
+        sem_post(mSemEngine);
+    }
+
+    void open()
+    {
+        mSemEngine = sem_open(mSemName.c_str(), O_CREAT | O_EXCL, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP, 0);
+        if (mSemEngine == SEM_FAILED)
+        {
+            throw std::runtime_error("Could not create semaphore " + mSemName);
+        }
+    }
+
+private:
+    std::string mSemName;
+    sem_t* mSemEngine{SEM_FAILED};
+};
+
+//!
+//! \class SharedMemory
+//! \brief Named POSIX shared memory object, e.g. to publish a serialized engine to other processes.
+//!
+class SharedMemory
+{
+public:
+    SharedMemory(const std::string& name)
+        : mName(name)
+    {
+    }
+
+    ~SharedMemory()
+    {
+        shm_unlink(mName.c_str());
+    }
+
+    int open_ro()
+    {
+        return open(O_RDONLY, 0666);
+    }
+
+    int open_rw()
+    {
+        return open(O_RDWR | O_CREAT, 0666);
+    }
+
+private:
+    int open(int flag, mode_t mode)
+    {
+        int fd = shm_open(mName.c_str(), flag, mode);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Could not create file descriptor: /dev/shm" + mName);
+        }
+        return fd;
+    }
+
+    std::string mName;
+};
+
+//!
+//! \class SharedArray
+//! \brief Fixed-size array in an anonymous shared mapping. Created before fork(), it is shared with every child.
+//!
+//! \details T must not hold pointers or otherwise refer to memory outside the array, since that memory is private to
+//!          each process. Elements are value-initialized and never destroyed.
+//!
+template <typename T>
+class SharedArray
+{
+public:
+    explicit SharedArray(size_t size)
+        : mSize(size)
+    {
+        void* data = mmap(nullptr, sizeof(T) * size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED)
+        {
+            throw std::runtime_error("Could not map shared memory");
+        }
+        mData = static_cast<T*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            new (mData + i) T();
+        }
+    }
+
+    SharedArray(const SharedArray&) = delete;
+    SharedArray& operator=(const SharedArray&) = delete;
+
+    ~SharedArray()
+    {
+        munmap(mData, sizeof(T) * mSize);
+    }
+
+    T& operator[](size_t i) { return mData[i]; }
+    const T& operator[](size_t i) const { return mData[i]; }
+    size_t size() const { return mSize; }
+
+private:
+    T* mData{nullptr};
+    size_t mSize{0};
+};
+
+//!
+//! \brief Results a benchmark child process reports to its parent through a SharedArray.
+//!
+struct ProcessResult
+{
+    enum State : int32_t
+    {
+        kSTARTING, //!< Not yet ready to measure
+        kREADY,    //!< Warmed up and waiting for the start signal
+        kDONE,     //!< Measured; the statistics below are complete
+        kFAILED,
+    };
+
+    std::atomic<int32_t> state{kSTARTING};
+    StreamStats stats; //!< All streams of the process merged together
+    double wallMs{0};  //!< Walltime of the measured phase
+};
+
+//!
+//! \brief Merge the statistics of all processes that completed.
+//!
+//! \return the number of processes that completed; the others are left out of merged.
+//!
+inline int mergeProcessResults(const SharedArray<ProcessResult>& results, StreamStats& merged, double& inferencesPerSecond)
+{
+    int done{0};
+    inferencesPerSecond = 0;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const ProcessResult& r = results[i];
+        if (r.state != ProcessResult::kDONE)
+            continue;
+        merged.gpu.merge(r.stats.gpu);
+        merged.host.merge(r.stats.host);
+        merged.inferences += r.stats.inferences;
+        // The processes are measured over the same period, so their rates add up.
+        if (r.wallMs > 0)
+            inferencesPerSecond += r.stats.inferences * 1000.0 / r.wallMs;
+        ++done;
+    }
+    return done;
+}
+
+//!
+//! \class ProcessGroup
+//! \brief Forks a group of child processes that each run a function and exit, and waits for them.
+//!
+class ProcessGroup
+{
+public:
+    //!
+    //! \brief Fork nbProcesses children. Child i calls child(i) and exits with status 0 if it returned true and 1
+    //!        otherwise; only the parent returns.
+    //!
+    //! \return false if a fork failed. The children already started still have to be waited for.
+    //!
+    bool spawn(int nbProcesses, const std::function<bool(int)>& child)
+    {
+        for (int i = 0; i < nbProcesses; i++)
+        {
+            pid_t pid = fork();
+            if (pid == 0)
+            {
+                bool pass = child(i);
+                std::cout.flush();
+                std::exit(pass ? EXIT_SUCCESS : EXIT_FAILURE);
+            }
+            if (pid == -1)
+            {
+                return false;
+            }
+            mChildren.push_back(Child{pid, true, false});
+        }
+        return true;
+    }
+
+    //!
+    //! \brief Collect the children that have exited, without blocking. Returns the number still running.
+    //!
+    int poll()
+    {
+        int running{0};
+        for (auto& c : mChildren)
+        {
+            int status;
+            if (c.running && waitpid(c.pid, &status, WNOHANG) == c.pid)
+                exited(c, status);
+            running += c.running;
+        }
+        return running;
+    }
+
+    //!
+    //! \brief Returns whether child i is still running, as of the last poll() or waitAll().
+    //!
+    bool isRunning(size_t i) const { return mChildren[i].running; }
+
+    //!
+    //! \brief Wait for every child to exit and return the number that failed or were killed.
+    //!
+    int waitAll()
+    {
+        int failed{0};
+        for (auto& c : mChildren)
+        {
+            int status;
+            while (c.running && waitpid(c.pid, &status, 0) == -1 && errno == EINTR)
+            {
+            }
+            if (c.running)
+                exited(c, status);
+            failed += c.failed;
+        }
+        return failed;
+    }
+
+    size_t size() const { return mChildren.size(); }
+
+private:
+    struct Child
+    {
+        pid_t pid;
+        bool running;
+        bool failed;
+    };
+
+    static void exited(Child& c, int status)
+    {
+        c.running = false;
+        c.failed = !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    }
+
+    std::vector<Child> mChildren;
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_MULTI_PROCESS_H
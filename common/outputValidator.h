@@ -0,0 +1,418 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_OUTPUT_VALIDATOR_H
+#define TENSORRT_OUTPUT_VALIDATOR_H
+
+#include "NvInfer.h"
+#include "half.h"
+#include "mappedFile.h"
+#include "tensorFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace samplesCommon
+{
+
+//!
+//! \brief When an output element is considered to match its reference value.
+//!
+//! \details An element matches if |output - reference| <= absTol + relTol * |reference|, as in numpy.allclose, or if
+//!          the two values are at most ulpTol units in the last place of the output type apart. NaNs only match NaNs
+//!          and infinities only match infinities of the same sign.
+//!
+struct ValidationTolerance
+{
+    float absTol{1e-5f};
+    float relTol{1e-3f};
+    int64_t ulpTol{0};
+};
+
+struct ValidationMismatch
+{
+    size_t index;
+    float output;
+    float reference;
+    int64_t ulps; //!< Distance in units in the last place of the output type
+};
+
+//!
+//! \brief Error statistics of an output compared against its reference.
+//!
+//! \details NaN differences are counted as mismatches but left out of the error statistics.
+//!
+struct ValidationReport
+{
+    size_t nbElements{0};
+    size_t nbMismatches{0};
+    double maxAbsError{0};
+    size_t maxAbsErrorIndex{0};
+    double maxRelError{0};
+    double meanAbsError{0};
+    std::vector<ValidationMismatch> mismatches; //!< The first mismatches in index order
+
+    bool passed() const { return nbMismatches == 0; }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const ValidationReport& report)
+{
+    os << report.nbMismatches << " of " << report.nbElements << " elements out of tolerance, max abs error "
+       << report.maxAbsError << " at [" << report.maxAbsErrorIndex << "], max rel error " << report.maxRelError
+       << ", mean abs error " << report.meanAbsError;
+    for (const auto& m : report.mismatches)
+    {
+        os << std::endl
+           << "  [" << m.index << "] output " << m.output << ", reference " << m.reference << ", " << m.ulps << " ulp";
+    }
+    return os;
+}
+
+namespace detail
+{
+
+//! Elements converted to float and compared per block, small enough for the scratch buffers to stay in L1.
+constexpr size_t kVALIDATION_BLOCK = 2048;
+
+//! half to float conversion of all 65536 bit patterns, built once.
+inline const float* halfToFloatTable()
+{
+    static const std::vector<float> table = [] {
+        std::vector<float> t(1 << 16);
+        for (uint32_t i = 0; i < t.size(); i++)
+        {
+            uint16_t bits = static_cast<uint16_t>(i);
+            half_float::half h;
+            std::memcpy(static_cast<void*>(&h), &bits, sizeof(bits));
+            t[i] = static_cast<float>(h);
+        }
+        return t;
+    }();
+    return table.data();
+}
+
+//! Convert n elements of type, starting at element first of src, to float.
+inline void convertToFloat(const void* src, nvinfer1::DataType type, size_t first, size_t n, float* dst)
+{
+    switch (type)
+    {
+    case nvinfer1::DataType::kFLOAT: std::memcpy(dst, static_cast<const float*>(src) + first, n * sizeof(float)); break;
+    case nvinfer1::DataType::kHALF:
+    {
+        const float* table = halfToFloatTable();
+        const uint16_t* in = static_cast<const uint16_t*>(src) + first;
+        for (size_t i = 0; i < n; i++)
+            dst[i] = table[in[i]];
+        break;
+    }
+    case nvinfer1::DataType::kINT8:
+    {
+        const int8_t* in = static_cast<const int8_t*>(src) + first;
+        for (size_t i = 0; i < n; i++)
+            dst[i] = in[i];
+        break;
+    }
+    case nvinfer1::DataType::kINT32:
+    {
+        const int32_t* in = static_cast<const int32_t*>(src) + first;
+        for (size_t i = 0; i < n; i++)
+            dst[i] = static_cast<float>(in[i]);
+        break;
+    }
+    }
+}
+
+//! Map the bits of an IEEE value to integers that are ordered like the values, with +0 and -0 both at 0.
+inline int64_t orderedBits(uint32_t bits, int signBit)
+{
+    const uint32_t sign = 1u << signBit;
+    return (bits & sign) ? -static_cast<int64_t>(bits & (sign - 1)) : static_cast<int64_t>(bits);
+}
+
+//! Statistics of one block, accumulated by compareBlock.
+struct BlockStats
+{
+    double sumAbsError{0};
+    float maxAbsError{0};
+    float maxRelError{0};
+    size_t nbCandidates{0}; //!< Elements outside the abs/rel tolerance, still to be checked in ulps
+};
+
+inline void compareScalar(
+    const float* out, const float* ref, size_t n, const ValidationTolerance& tol, float& sum, BlockStats& stats)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        float err = std::fabs(out[i] - ref[i]);
+        float absRef = std::fabs(ref[i]);
+        if (!(err <= std::min(tol.absTol + tol.relTol * absRef, FLT_MAX)))
+            stats.nbCandidates++;
+        if (err == err)
+        {
+            sum += err;
+            stats.maxAbsError = std::max(stats.maxAbsError, err);
+            stats.maxRelError = std::max(stats.maxRelError, err / std::max(absRef, FLT_MIN));
+        }
+    }
+}
+
+//!
+//! \brief Branch-free pass over a block: error sums and maxima, and the number of elements outside the abs/rel
+//!        tolerance. Uses SSE2 where available, four elements at a time.
+//!
+inline BlockStats compareBlock(const float* out, const float* ref, size_t n, const ValidationTolerance& tol)
+{
+    BlockStats stats;
+    float sum{0};
+    size_t i{0};
+#if defined(__SSE2__)
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 absTol = _mm_set1_ps(tol.absTol);
+    const __m128 relTol = _mm_set1_ps(tol.relTol);
+    const __m128 minRef = _mm_set1_ps(FLT_MIN);
+    const __m128 maxTol = _mm_set1_ps(FLT_MAX);
+    __m128 sum4 = _mm_setzero_ps();
+    __m128 max4 = _mm_setzero_ps();
+    __m128 rel4 = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 o = _mm_loadu_ps(out + i);
+        __m128 r = _mm_loadu_ps(ref + i);
+        __m128 err = _mm_andnot_ps(signMask, _mm_sub_ps(o, r));
+        __m128 absRef = _mm_andnot_ps(signMask, r);
+        // The bound is kept finite so that an infinite reference does not accept an infinite error.
+        __m128 within = _mm_cmple_ps(err, _mm_min_ps(_mm_add_ps(absTol, _mm_mul_ps(relTol, absRef)), maxTol));
+        int outside = ~_mm_movemask_ps(within) & 0xf;
+        stats.nbCandidates += (outside & 1) + ((outside >> 1) & 1) + ((outside >> 2) & 1) + (outside >> 3);
+        // NaN errors are zeroed so that they do not poison the sums and maxima.
+        err = _mm_and_ps(err, _mm_cmpeq_ps(err, err));
+        sum4 = _mm_add_ps(sum4, err);
+        max4 = _mm_max_ps(max4, err);
+        // maxps returns its second operand if either is NaN, which drops the NaN of an infinite error relative to an
+        // infinite reference as the scalar loop does.
+        rel4 = _mm_max_ps(_mm_div_ps(err, _mm_max_ps(absRef, minRef)), rel4);
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, sum4);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    _mm_storeu_ps(lanes, max4);
+    stats.maxAbsError = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    _mm_storeu_ps(lanes, rel4);
+    stats.maxRelError = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+    compareScalar(out + i, ref + i, n - i, tol, sum, stats);
+    stats.sumAbsError = sum;
+    return stats;
+}
+
+} // namespace detail
+
+//!
+//! \brief Distance between an output value and its reference in units in the last place of the output type.
+//!
+//! \details The output value must be exactly representable in type, which holds for values converted from it.
+//!          Integer types count the difference to the rounded reference. Returns the largest int64_t if only one of
+//!          the values is NaN.
+//!
+inline int64_t ulpDistance(float output, float reference, nvinfer1::DataType type)
+{
+    if (std::isnan(output) || std::isnan(reference))
+        return std::isnan(output) && std::isnan(reference) ? 0 : std::numeric_limits<int64_t>::max();
+    switch (type)
+    {
+    case nvinfer1::DataType::kFLOAT:
+    {
+        uint32_t o, r;
+        std::memcpy(&o, &output, sizeof(o));
+        std::memcpy(&r, &reference, sizeof(r));
+        return std::llabs(detail::orderedBits(o, 31) - detail::orderedBits(r, 31));
+    }
+    case nvinfer1::DataType::kHALF:
+    {
+        half_float::half o(output), r(reference);
+        uint16_t ob, rb;
+        std::memcpy(&ob, &o, sizeof(ob));
+        std::memcpy(&rb, &r, sizeof(rb));
+        return std::llabs(detail::orderedBits(ob, 15) - detail::orderedBits(rb, 15));
+    }
+    case nvinfer1::DataType::kINT8:
+    case nvinfer1::DataType::kINT32: return std::llabs(std::llround(output) - std::llround(reference));
+    }
+    return 0;
+}
+
+//!
+//! \brief Compare count elements of output, of type outputType, against reference, of type referenceType.
+//!
+//! \details Both tensors are converted to float a block at a time and compared in one vectorized pass that yields the
+//!          error statistics and the elements outside the abs/rel tolerance. Only blocks holding such elements are
+//!          revisited to measure their ulp distance and record the first maxMismatches mismatches, so a matching
+//!          output costs a single pass over both buffers.
+//!
+inline ValidationReport validateTensor(const void* output, nvinfer1::DataType outputType, const void* reference,
+    nvinfer1::DataType referenceType, size_t count, const ValidationTolerance& tolerance, size_t maxMismatches = 10)
+{
+    ValidationReport report;
+    report.nbElements = count;
+    std::vector<float> outBlock(detail::kVALIDATION_BLOCK);
+    std::vector<float> refBlock(detail::kVALIDATION_BLOCK);
+    double sum{0};
+    for (size_t first = 0; first < count; first += detail::kVALIDATION_BLOCK)
+    {
+        const size_t n = std::min(detail::kVALIDATION_BLOCK, count - first);
+        // float data is compared in place instead of being copied.
+        const float* out = outputType == nvinfer1::DataType::kFLOAT ? static_cast<const float*>(output) + first
+                                                                    : outBlock.data();
+        const float* ref = referenceType == nvinfer1::DataType::kFLOAT ? static_cast<const float*>(reference) + first
+                                                                       : refBlock.data();
+        if (outputType != nvinfer1::DataType::kFLOAT)
+            detail::convertToFloat(output, outputType, first, n, outBlock.data());
+        if (referenceType != nvinfer1::DataType::kFLOAT)
+            detail::convertToFloat(reference, referenceType, first, n, refBlock.data());
+
+        detail::BlockStats stats = detail::compareBlock(out, ref, n, tolerance);
+        sum += stats.sumAbsError;
+        report.maxRelError = std::max(report.maxRelError, static_cast<double>(stats.maxRelError));
+        if (stats.maxAbsError > report.maxAbsError)
+        {
+            report.maxAbsError = stats.maxAbsError;
+            for (size_t i = 0; i < n; i++)
+            {
+                if (std::fabs(out[i] - ref[i]) == stats.maxAbsError)
+                {
+                    report.maxAbsErrorIndex = first + i;
+                    break;
+                }
+            }
+        }
+
+        if (stats.nbCandidates == 0)
+            continue;
+        for (size_t i = 0; i < n; i++)
+        {
+            float err = std::fabs(out[i] - ref[i]);
+            if (err <= std::min(tolerance.absTol + tolerance.relTol * std::fabs(ref[i]), FLT_MAX))
+                continue;
+            int64_t ulps = ulpDistance(out[i], ref[i], outputType);
+            if (ulps <= tolerance.ulpTol)
+                continue;
+            if (report.mismatches.size() < maxMismatches)
+                report.mismatches.push_back(ValidationMismatch{first + i, out[i], ref[i], ulps});
+            report.nbMismatches++;
+        }
+    }
+    report.meanAbsError = count ? sum / count : 0;
+    return report;
+}
+
+//!
+//! \class ReferenceTensor
+//! \brief A memory-mapped raw or .npy file holding the expected values of an output.
+//!
+//! \details .npy files may be of any supported dtype, e.g. a float32 reference for an fp16 or int8 output.
+//!          Raw files hold values of the output type.
+//!
+class ReferenceTensor
+{
+public:
+    //!
+    //! \return false with a description in error if the file cannot be mapped or is malformed.
+    //!
+    bool open(const std::string& fileName, nvinfer1::DataType outputType, std::string& error)
+    {
+        if (!mFile.open(fileName))
+        {
+            error = "cannot map " + fileName + ": " + std::strerror(errno);
+            return false;
+        }
+        mInfo = TensorFileInfo();
+        if (isNpyFile(mFile.data(), mFile.size()))
+        {
+            if (!parseNpyHeader(mFile.data(), mFile.size(), mInfo, error))
+            {
+                error = fileName + ": " + error;
+                return false;
+            }
+        }
+        else
+        {
+            mInfo.type = outputType;
+            mInfo.dataSize = mFile.size();
+        }
+        if (mInfo.dataSize % tensorElementSize(mInfo.type) != 0)
+        {
+            error = fileName + ": size is not a multiple of the element size";
+            return false;
+        }
+        return true;
+    }
+
+    nvinfer1::DataType getType() const { return mInfo.type; }
+    size_t getNbElements() const { return mInfo.dataSize / tensorElementSize(mInfo.type); }
+    const void* data() const { return static_cast<const char*>(mFile.data()) + mInfo.dataOffset; }
+
+private:
+    MappedFile mFile;
+    TensorFileInfo mInfo;
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_OUTPUT_VALIDATOR_H
@@ -0,0 +1,407 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_RUN_MANIFEST_H
+#define TENSORRT_RUN_MANIFEST_H
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \brief One benchmark run of a manifest, as the command line options that describe it.
+//!
+struct ManifestRun
+{
+    std::string name;
+    std::vector<std::string> args; //!< Options such as "--batch=8" or "--fp16"
+};
+
+namespace detail
+{
+
+//! Option name and value as written in a manifest; flags have no value.
+struct ManifestOption
+{
+    std::string key;
+    std::string value;
+    bool isFlag;
+};
+
+inline std::string manifestArg(const ManifestOption& option)
+{
+    return option.isFlag ? "--" + option.key : "--" + option.key + "=" + option.value;
+}
+
+inline std::string trim(const std::string& s)
+{
+    const size_t first = s.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos)
+        return "";
+    return s.substr(first, s.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+//!
+//! \class ManifestJsonParser
+//! \brief Parser of the JSON subset used by manifests: objects whose values are strings, numbers, booleans, null or
+//!        arrays of strings and numbers.
+//!
+class ManifestJsonParser
+{
+public:
+    explicit ManifestJsonParser(const std::string& text)
+        : mText(text)
+    {
+    }
+
+    //!
+    //! \brief Parse {"defaults": {...}, "runs": [{...}, ...]} or a bare array of runs.
+    //!
+    bool parse(std::vector<ManifestRun>& runs, std::string& error)
+    {
+        std::vector<ManifestOption> defaults;
+        bool ok{false};
+        if (peek() == '[')
+        {
+            ok = parseRuns(runs);
+        }
+        else if (consume('{'))
+        {
+            ok = true;
+            bool first{true};
+            while (ok && !consume('}'))
+            {
+                std::string key;
+                ok = (first || consume(',')) && parseString(key) && consume(':');
+                first = false;
+                if (ok && key == "defaults")
+                {
+                    std::string ignored;
+                    ok = parseOptions(defaults, ignored);
+                }
+                else if (ok && key == "runs")
+                {
+                    ok = parseRuns(runs);
+                }
+                else if (ok)
+                {
+                    mError = "unknown key \"" + key + "\", expected \"defaults\" or \"runs\"";
+                    ok = false;
+                }
+            }
+        }
+        if (ok && peek() != '\0')
+        {
+            fail("trailing characters");
+            ok = false;
+        }
+        if (!ok)
+        {
+            error = mError.empty() ? "malformed JSON" : mError;
+            error += " at offset " + std::to_string(mPos);
+            return false;
+        }
+        for (auto& run : runs)
+        {
+            std::vector<std::string> args;
+            for (const auto& option : defaults)
+                args.push_back(manifestArg(option));
+            args.insert(args.end(), run.args.begin(), run.args.end());
+            run.args.swap(args);
+        }
+        return true;
+    }
+
+private:
+    char peek()
+    {
+        while (mPos < mText.size() && std::isspace(static_cast<unsigned char>(mText[mPos])))
+            mPos++;
+        return mPos < mText.size() ? mText[mPos] : '\0';
+    }
+
+    bool consume(char c)
+    {
+        if (peek() != c)
+            return false;
+        mPos++;
+        return true;
+    }
+
+    bool fail(const std::string& message)
+    {
+        if (mError.empty())
+            mError = message;
+        return false;
+    }
+
+    bool parseString(std::string& s)
+    {
+        if (!consume('"'))
+            return fail("expected a string");
+        s.clear();
+        while (mPos < mText.size() && mText[mPos] != '"')
+        {
+            char c = mText[mPos++];
+            if (c == '\\' && mPos < mText.size())
+            {
+                c = mText[mPos++];
+                switch (c)
+                {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'u': return fail("\\u escapes are not supported");
+                default: break; // \" \\ and \/ stand for themselves
+                }
+            }
+            s += c;
+        }
+        if (mPos == mText.size())
+            return fail("unterminated string");
+        mPos++;
+        return true;
+    }
+
+    //! Parse a scalar. Numbers keep their spelling, so that they reach the option parser unchanged.
+    bool parseScalar(ManifestOption& option)
+    {
+        const char c = peek();
+        option.isFlag = false;
+        if (c == '"')
+            return parseString(option.value);
+        const size_t start = mPos;
+        while (mPos < mText.size() && (std::isalnum(static_cast<unsigned char>(mText[mPos])) || mText[mPos] == '.'
+                                          || mText[mPos] == '-' || mText[mPos] == '+'))
+            mPos++;
+        option.value = mText.substr(start, mPos - start);
+        if (option.value.empty())
+            return fail("expected a value");
+        if (option.value == "true" || option.value == "false" || option.value == "null")
+        {
+            option.isFlag = true;
+            return true;
+        }
+        char* end;
+        std::strtod(option.value.c_str(), &end);
+        return *end == '\0' || fail("invalid value " + option.value);
+    }
+
+    //!
+    //! \brief Parse an object of options. true adds a flag, false and null leave the option out, and an array
+    //!        repeats the option once per element. The "name" key is returned separately.
+    //!
+    bool parseOptions(std::vector<ManifestOption>& options, std::string& name)
+    {
+        if (!consume('{'))
+            return fail("expected an object");
+        bool first{true};
+        while (!consume('}'))
+        {
+            ManifestOption option;
+            if (!(first || consume(',')) || !parseString(option.key) || !consume(':'))
+                return fail("expected a key");
+            first = false;
+            if (consume('['))
+            {
+                bool firstElement{true};
+                while (!consume(']'))
+                {
+                    if (!(firstElement || consume(',')) || !parseScalar(option) || option.isFlag)
+                        return fail("arrays may only hold strings and numbers");
+                    firstElement = false;
+                    options.push_back(option);
+                }
+                continue;
+            }
+            if (!parseScalar(option))
+                return false;
+            if (option.key == "name")
+                name = option.value;
+            else if (!option.isFlag || option.value == "true")
+                options.push_back(option);
+        }
+        return true;
+    }
+
+    bool parseRuns(std::vector<ManifestRun>& runs)
+    {
+        if (!consume('['))
+            return fail("expected an array of runs");
+        bool first{true};
+        while (!consume(']'))
+        {
+            if (!first && !consume(','))
+                return fail("expected ','");
+            first = false;
+            ManifestRun run;
+            std::vector<ManifestOption> options;
+            if (!parseOptions(options, run.name))
+                return false;
+            for (const auto& option : options)
+                run.args.push_back(manifestArg(option));
+            runs.push_back(run);
+        }
+        return true;
+    }
+
+    const std::string& mText;
+    size_t mPos{0};
+    std::string mError;
+};
+
+//!
+//! \brief Parse an INI manifest: one [name] section per run holding key = value lines, or bare keys for flags.
+//!        Keys before the first section apply to every run; '#' and ';' start comment lines.
+//!
+inline bool parseIniManifest(const std::string& text, std::vector<ManifestRun>& runs, std::string& error)
+{
+    std::vector<std::string> defaults;
+    std::istringstream lines(text);
+    std::string line;
+    for (int lineNumber = 1; std::getline(lines, line); lineNumber++)
+    {
+        line = trim(line);
+        if (line.empty() || line[0] == '#' || line[0] == ';')
+            continue;
+        if (line[0] == '[')
+        {
+            if (line.back() != ']' || line.size() < 3)
+            {
+                error = "line " + std::to_string(lineNumber) + ": malformed section header";
+                return false;
+            }
+            runs.push_back(ManifestRun{trim(line.substr(1, line.size() - 2)), defaults});
+            continue;
+        }
+        const size_t equals = line.find('=');
+        ManifestOption option{trim(line.substr(0, equals)), "", equals == std::string::npos};
+        if (!option.isFlag)
+            option.value = trim(line.substr(equals + 1));
+        if (option.key.empty())
+        {
+            error = "line " + std::to_string(lineNumber) + ": missing option name";
+            return false;
+        }
+        (runs.empty() ? defaults : runs.back().args).push_back(manifestArg(option));
+    }
+    return true;
+}
+
+} // namespace detail
+
+//!
+//! \brief Read the runs of a JSON or INI manifest file.
+//!
+//! \details Each run is a set of command line options without their leading "--". In JSON, a manifest is either an
+//!          array of run objects or an object with "runs" and "defaults", whose options precede those of every run:
+//!          \code
+//!          {"defaults": {"iterations": 20}, "runs": [{"name": "fp16", "onnx": "model.onnx", "fp16": true}]}
+//!          \endcode
+//!          In INI, every [name] section is a run and options before the first section are the defaults:
+//!          \code
+//!          iterations = 20
+//!          [fp16]
+//!          onnx = model.onnx
+//!          fp16
+//!          \endcode
+//!          Runs without a name are named run1, run2 and so on, in manifest order.
+//!
+//! \return false with a description in error if the file cannot be read or parsed, or holds no runs.
+//!
+inline bool loadRunManifest(const std::string& fileName, std::vector<ManifestRun>& runs, std::string& error)
+{
+    std::ifstream in(fileName);
+    if (!in)
+    {
+        error = "cannot open " + fileName;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+
+    // A JSON manifest starts with an object, or with an array of objects where an INI file has a section header.
+    const size_t first = text.find_first_not_of(" \t\r\n");
+    const size_t second = first == std::string::npos ? first : text.find_first_not_of(" \t\r\n", first + 1);
+    const bool isJson = first != std::string::npos
+        && (text[first] == '{' || (text[first] == '[' && second != std::string::npos && (text[second] == '{' || text[second] == ']')));
+
+    runs.clear();
+    bool ok = isJson ? detail::ManifestJsonParser(text).parse(runs, error) : detail::parseIniManifest(text, runs, error);
+    if (!ok)
+    {
+        error = fileName + ": " + error;
+        return false;
+    }
+    if (runs.empty())
+    {
+        error = fileName + ": no runs";
+        return false;
+    }
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        if (runs[i].name.empty())
+            runs[i].name = "run" + std::to_string(i + 1);
+    }
+    return true;
+}
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_RUN_MANIFEST_H
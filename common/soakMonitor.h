@@ -0,0 +1,243 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_SOAK_MONITOR_H
+#define TENSORRT_SOAK_MONITOR_H
+
+#include "latencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \class RollingWindow
+//! \brief Latency and throughput of the samples recorded in the last windowMs of a run.
+//!
+//! \details The window is kept as nbSlices histograms, one per windowMs / nbSlices of run time, and slides a slice at a
+//!          time, so memory stays constant however long the run. Sample times are in milliseconds from the start of
+//!          the run and must not go backwards by more than a slice. All methods may be called from several threads.
+//!
+class RollingWindow
+{
+public:
+    RollingWindow(double windowMs, int nbSlices = 10)
+        : mSliceMs(windowMs / std::max(nbSlices, 1))
+        , mSlices(std::max(nbSlices, 1))
+        , mIndices(mSlices.size(), -1)
+    {
+    }
+
+    //!
+    //! \brief Record one latency sample that completed at timeMs.
+    //!
+    void record(double timeMs, double latencyMs)
+    {
+        const int64_t index = sliceIndex(timeMs);
+        const size_t slot = static_cast<size_t>(index % static_cast<int64_t>(mSlices.size()));
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mIndices[slot] != index)
+        {
+            // The slot still holds a slice that has left the window.
+            if (mIndices[slot] > index)
+                return;
+            mSlices[slot].reset();
+            mIndices[slot] = index;
+        }
+        mSlices[slot].record(latencyMs);
+    }
+
+    //!
+    //! \brief Returns the latencies recorded in the window ending at nowMs.
+    //!
+    LatencyHistogram latency(double nowMs) const
+    {
+        const int64_t last = sliceIndex(nowMs);
+        const int64_t first = last - static_cast<int64_t>(mSlices.size()) + 1;
+        LatencyHistogram merged;
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (size_t slot = 0; slot < mSlices.size(); slot++)
+        {
+            if (mIndices[slot] >= first && mIndices[slot] <= last)
+                merged.merge(mSlices[slot]);
+        }
+        return merged;
+    }
+
+    //!
+    //! \brief Returns the samples per second recorded in the window ending at nowMs. Before a whole window has
+    //!        passed, the rate is taken over the run so far.
+    //!
+    double throughput(double nowMs) const
+    {
+        const int64_t first = sliceIndex(nowMs) - static_cast<int64_t>(mSlices.size()) + 1;
+        const double spanMs = nowMs - std::max(0.0, first * mSliceMs);
+        return spanMs > 0 ? latency(nowMs).count() * 1000.0 / spanMs : 0.0;
+    }
+
+    double getWindowMs() const { return mSliceMs * mSlices.size(); }
+
+private:
+    int64_t sliceIndex(double timeMs) const { return static_cast<int64_t>(std::max(0.0, timeMs) / mSliceMs); }
+
+    double mSliceMs;
+    std::vector<LatencyHistogram> mSlices;
+    std::vector<int64_t> mIndices; //!< Slice index held by each slot, -1 if unused
+    mutable std::mutex mMutex;
+};
+
+//!
+//! \class MemoryGrowthDetector
+//! \brief Flags a memory usage series that keeps growing.
+//!
+//! \details Usage is considered growing when none of the last windowSize samples is smaller than its predecessor,
+//!          they grew by at least minGrowthBytes overall, and both the older and the newer half of them grew.
+//!          Allocator caches and lazy initialization grow once and then level off, so a single step does not trip
+//!          the detector; the usage has to keep growing across the window. The window holds at least 3 samples.
+//!
+class MemoryGrowthDetector
+{
+public:
+    MemoryGrowthDetector(size_t windowSize, int64_t minGrowthBytes)
+        : mWindowSize(std::max<size_t>(windowSize, 3))
+        , mMinGrowth(minGrowthBytes)
+    {
+    }
+
+    //!
+    //! \brief Add the usage measured at timeMs and return whether it is growing.
+    //!
+    bool add(double timeMs, int64_t bytes)
+    {
+        mSamples.push_back(Sample{timeMs, bytes});
+        if (mSamples.size() > mWindowSize)
+            mSamples.pop_front();
+        return isGrowing();
+    }
+
+    bool isGrowing() const
+    {
+        const size_t middle = mSamples.size() / 2;
+        if (mSamples.size() < mWindowSize || growth() < mMinGrowth || mSamples[middle].bytes == mSamples.front().bytes
+            || mSamples.back().bytes == mSamples[middle].bytes)
+            return false;
+        for (size_t i = 1; i < mSamples.size(); i++)
+        {
+            if (mSamples[i].bytes < mSamples[i - 1].bytes)
+                return false;
+        }
+        return true;
+    }
+
+    //!
+    //! \brief Returns the change in usage over the window, in bytes.
+    //!
+    int64_t growth() const { return mSamples.empty() ? 0 : mSamples.back().bytes - mSamples.front().bytes; }
+
+    //!
+    //! \brief Returns the least-squares slope of the usage over the window, in bytes per second.
+    //!
+    double slope() const
+    {
+        const double n = static_cast<double>(mSamples.size());
+        if (mSamples.size() < 2)
+            return 0.0;
+        double meanT{0}, meanB{0};
+        for (const auto& s : mSamples)
+        {
+            meanT += s.timeMs / n;
+            meanB += static_cast<double>(s.bytes) / n;
+        }
+        double covariance{0}, variance{0};
+        for (const auto& s : mSamples)
+        {
+            covariance += (s.timeMs - meanT) * (static_cast<double>(s.bytes) - meanB);
+            variance += (s.timeMs - meanT) * (s.timeMs - meanT);
+        }
+        return variance > 0 ? covariance / variance * 1000.0 : 0.0;
+    }
+
+    size_t getWindowSize() const { return mWindowSize; }
+
+private:
+    struct Sample
+    {
+        double timeMs;
+        int64_t bytes;
+    };
+
+    size_t mWindowSize;
+    int64_t mMinGrowth;
+    std::deque<Sample> mSamples;
+};
+
+//!
+//! \brief Returns the resident set size of this process in bytes, or -1 if /proc/self/statm cannot be read.
+//!
+inline int64_t residentSetBytes()
+{
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm)
+        return -1;
+    long long pages{0}, resident{0};
+    const bool ok = std::fscanf(statm, "%lld %lld", &pages, &resident) == 2;
+    std::fclose(statm);
+    return ok ? resident * sysconf(_SC_PAGESIZE) : -1;
+}
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_SOAK_MONITOR_H
@@ -0,0 +1,213 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_STEADY_STATE_DETECTOR_H
+#define TENSORRT_STEADY_STATE_DETECTOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \class SteadyStateDetector
+//! \brief Decides when a timing series has settled, from the coefficient of variation of a sliding window.
+//!
+//! \details The series is considered steady once the last windowSize samples have a coefficient of variation
+//!          (standard deviation divided by mean) at or below cvThreshold. Clock ramp-up, lazy allocation and
+//!          cold caches show up as a drifting or noisy window and keep the detector unsteady.
+//!
+class SteadyStateDetector
+{
+public:
+    SteadyStateDetector(size_t windowSize, double cvThreshold)
+        : mWindow(windowSize > 1 ? windowSize : 2)
+        , mThreshold(cvThreshold)
+    {
+    }
+
+    //!
+    //! \brief Add one sample and return whether the series is steady.
+    //!
+    bool add(double sample)
+    {
+        if (mCount < mWindow.size())
+        {
+            ++mCount;
+        }
+        else
+        {
+            const double old = mWindow[mNext];
+            mSum -= old;
+            mSumSquares -= old * old;
+        }
+        mWindow[mNext] = sample;
+        mSum += sample;
+        mSumSquares += sample * sample;
+        mNext = (mNext + 1) % mWindow.size();
+
+        // Recompute the sums once per window so that rounding errors of the running update cannot accumulate.
+        if (mNext == 0)
+        {
+            mSum = 0;
+            mSumSquares = 0;
+            for (double v : mWindow)
+            {
+                mSum += v;
+                mSumSquares += v * v;
+            }
+        }
+        return isSteady();
+    }
+
+    //!
+    //! \brief Returns true if the window is full and its coefficient of variation is within the threshold.
+    //!
+    bool isSteady() const { return mCount == mWindow.size() && cv() <= mThreshold; }
+
+    //!
+    //! \brief Returns the coefficient of variation of the samples in the window.
+    //!
+    double cv() const
+    {
+        if (mCount < 2)
+            return std::numeric_limits<double>::infinity();
+        const double n = static_cast<double>(mCount);
+        const double mean = mSum / n;
+        const double variance = std::max(0.0, (mSumSquares - mSum * mean) / (n - 1));
+        return mean != 0 ? std::sqrt(variance) / std::fabs(mean) : std::numeric_limits<double>::infinity();
+    }
+
+    //!
+    //! \brief Returns the mean of the samples in the window.
+    //!
+    double mean() const { return mCount ? mSum / mCount : 0.0; }
+
+    size_t getWindowSize() const { return mWindow.size(); }
+
+    void reset()
+    {
+        mCount = 0;
+        mNext = 0;
+        mSum = 0;
+        mSumSquares = 0;
+    }
+
+private:
+    std::vector<double> mWindow;
+    double mThreshold;
+    size_t mCount{0};
+    size_t mNext{0};
+    double mSum{0};
+    double mSumSquares{0};
+};
+
+//!
+//! \brief Where a warm-up stands, as returned by WarmUpController::status.
+//!
+enum class WarmUpStatus
+{
+    kRUNNING,        //!< Run another untimed sample.
+    kDONE,           //!< The fixed warm-up time has passed and no steady state was asked for.
+    kSTEADY,         //!< The fixed warm-up time has passed and the series is steady.
+    kBUDGET_EXPIRED, //!< The series did not settle within the budget; measure anyway.
+};
+
+//!
+//! \class WarmUpController
+//! \brief Decides when a warm-up loop stops: after minMs, and if cvThreshold is positive, once a SteadyStateDetector
+//!        reports a steady series or after budgetMs, whichever comes first.
+//!
+//! \details The caller owns the clock and passes the time elapsed since the start of the warm-up, so the policy
+//!          can be driven by synthetic timings.
+//!
+class WarmUpController
+{
+public:
+    WarmUpController(double minMs, double cvThreshold, size_t windowSize, double budgetMs)
+        : mDetector(windowSize, cvThreshold)
+        , mMinMs(minMs)
+        , mBudgetMs(budgetMs)
+        , mAdaptive(cvThreshold > 0)
+    {
+    }
+
+    //!
+    //! \brief Add the measurement of one warm-up sample.
+    //!
+    void add(double sample) { mDetector.add(sample); }
+
+    //!
+    //! \brief Returns whether to run another sample, elapsedMs after the warm-up started.
+    //!
+    WarmUpStatus status(double elapsedMs) const
+    {
+        if (elapsedMs >= mMinMs && (!mAdaptive || mDetector.isSteady()))
+            return mAdaptive ? WarmUpStatus::kSTEADY : WarmUpStatus::kDONE;
+        if (mAdaptive && elapsedMs >= mBudgetMs)
+            return WarmUpStatus::kBUDGET_EXPIRED;
+        return WarmUpStatus::kRUNNING;
+    }
+
+    const SteadyStateDetector& getDetector() const { return mDetector; }
+
+private:
+    SteadyStateDetector mDetector;
+    double mMinMs;
+    double mBudgetMs;
+    bool mAdaptive;
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_STEADY_STATE_DETECTOR_H
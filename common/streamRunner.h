@@ -0,0 +1,230 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_STREAM_RUNNER_H
+#define TENSORRT_STREAM_RUNNER_H
+
+#include "latencyHistogram.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \class IInferenceStream
+//! \brief Interface of one independent inference pipeline (an execution context, its buffers and its stream).
+//!
+//! \details MultiStreamRunner drives each IInferenceStream from its own host thread, so implementations only
+//!          need to be safe against concurrent calls on *different* objects. A host-only implementation can
+//!          be substituted to exercise the scheduling and statistics without a GPU.
+//!
+class IInferenceStream
+{
+public:
+    //!
+    //! \brief Prepare the calling thread to drive this stream, e.g. make the stream's CUDA device current on it.
+    //!
+    //! \details The runners call it on each of their threads before its first prepare() or infer(), since a new
+    //!          thread starts on device 0 whatever device the stream was created on.
+    //!
+    virtual void bindThread() {}
+
+    //!
+    //! \brief Stage the inputs of the next inference, e.g. copy them from a dataset into the input buffers.
+    //!
+    //! \details The runners call it before starting the clock of each infer(), so the host latency and the throughput
+    //!          they report cover the inference only. A stream that is not prepared must stage its inputs in infer().
+    //!
+    virtual void prepare() {}
+
+    //!
+    //! \brief Run one inference to completion.
+    //!
+    //! \param gpuMs Set to the device time of the inference in milliseconds, or to a negative value if the
+    //!        implementation cannot measure it.
+    //!
+    //! \return false if the inference failed; the runner then stops all streams.
+    //!
+    virtual bool infer(float& gpuMs) = 0;
+
+    virtual ~IInferenceStream() {}
+};
+
+//!
+//! \brief Latency statistics collected for one stream.
+//!
+struct StreamStats
+{
+    LatencyHistogram gpu;  //!< Device time per inference, as reported by IInferenceStream::infer
+    LatencyHistogram host; //!< Host walltime per call to IInferenceStream::infer
+    uint64_t inferences{0};
+};
+
+//!
+//! \class MultiStreamRunner
+//! \brief Runs a set of IInferenceStreams concurrently, one host thread each, and collects per-stream latency.
+//!
+class MultiStreamRunner
+{
+public:
+    explicit MultiStreamRunner(const std::vector<IInferenceStream*>& streams)
+        : mStreams(streams)
+        , mStats(streams.size())
+    {
+    }
+
+    //!
+    //! \brief Run runsPerStream inferences on every stream. All threads are released together so that the
+    //!        measured walltime covers only the concurrent phase.
+    //!
+    //! \return false if any inference failed.
+    //!
+    bool run(int runsPerStream)
+    {
+        mFailed = false;
+        bool go{false};
+        std::mutex mutex;
+        std::condition_variable startCv;
+
+        std::vector<std::thread> threads;
+        for (size_t s = 0; s < mStreams.size(); s++)
+        {
+            threads.emplace_back([&, s]() {
+                mStreams[s]->bindThread();
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    startCv.wait(lock, [&go]() { return go; });
+                }
+                runStream(*mStreams[s], mStats[s], runsPerStream);
+            });
+        }
+
+        auto tStart = std::chrono::high_resolution_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            go = true;
+        }
+        startCv.notify_all();
+        for (auto& t : threads)
+            t.join();
+        mWallMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+
+        return !mFailed;
+    }
+
+    //!
+    //! \brief Returns the statistics of each stream, in the order the streams were given.
+    //!
+    const std::vector<StreamStats>& getStreamStats() const { return mStats; }
+
+    //!
+    //! \brief Returns the statistics of all streams merged together.
+    //!
+    StreamStats getAggregateStats() const
+    {
+        StreamStats total;
+        for (const auto& s : mStats)
+        {
+            total.gpu.merge(s.gpu);
+            total.host.merge(s.host);
+            total.inferences += s.inferences;
+        }
+        return total;
+    }
+
+    //!
+    //! \brief Returns the accumulated walltime of all calls to run(), in milliseconds.
+    //!
+    double getWallMs() const { return mWallMs; }
+
+    //!
+    //! \brief Returns completed inferences per second across all streams.
+    //!
+    double getInferencesPerSecond() const
+    {
+        return mWallMs > 0 ? getAggregateStats().inferences * 1000.0 / mWallMs : 0.0;
+    }
+
+private:
+    void runStream(IInferenceStream& stream, StreamStats& stats, int runs)
+    {
+        for (int i = 0; i < runs && !mFailed; i++)
+        {
+            float gpuMs{-1.0f};
+            stream.prepare();
+            auto tStart = std::chrono::high_resolution_clock::now();
+            bool ok = stream.infer(gpuMs);
+            auto tEnd = std::chrono::high_resolution_clock::now();
+            if (!ok)
+            {
+                mFailed = true;
+                return;
+            }
+            stats.host.record(std::chrono::duration<double, std::milli>(tEnd - tStart).count());
+            if (gpuMs >= 0)
+                stats.gpu.record(gpuMs);
+            ++stats.inferences;
+        }
+    }
+
+    std::vector<IInferenceStream*> mStreams;
+    std::vector<StreamStats> mStats;
+    std::atomic<bool> mFailed{false};
+    double mWallMs{0.0};
+};
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_STREAM_RUNNER_H
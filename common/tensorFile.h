@@ -0,0 +1,665 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_TENSOR_FILE_H
+#define TENSORRT_TENSOR_FILE_H
+
+#include "NvInfer.h"
+#include "mappedFile.h"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace samplesCommon
+{
+
+//!
+//! \brief Layout and location of the tensor data stored in a raw or NumPy (.npy) file.
+//!
+struct TensorFileInfo
+{
+    nvinfer1::DataType type{nvinfer1::DataType::kFLOAT};
+    std::vector<int64_t> shape; //!< Shape from the .npy header; empty for raw files
+    size_t dataOffset{0};       //!< Offset of the first element from the start of the file
+    size_t dataSize{0};         //!< Size of the tensor data in bytes
+    bool isNpy{false};
+};
+
+inline size_t tensorElementSize(nvinfer1::DataType type)
+{
+    switch (type)
+    {
+    case nvinfer1::DataType::kINT32: return 4;
+    case nvinfer1::DataType::kFLOAT: return 4;
+    case nvinfer1::DataType::kHALF: return 2;
+    case nvinfer1::DataType::kINT8: return 1;
+    }
+    return 0;
+}
+
+//!
+//! \brief Returns the NumPy type descriptor of a TensorRT data type, e.g. "<f4" for kFLOAT.
+//!
+inline std::string npyDescr(nvinfer1::DataType type)
+{
+    switch (type)
+    {
+    case nvinfer1::DataType::kINT32: return "<i4";
+    case nvinfer1::DataType::kFLOAT: return "<f4";
+    case nvinfer1::DataType::kHALF: return "<f2";
+    case nvinfer1::DataType::kINT8: return "|i1";
+    }
+    return "";
+}
+
+inline bool npyDescrToDataType(const std::string& descr, nvinfer1::DataType& type)
+{
+    // Data is consumed in host byte order, so only little-endian and byte-sized types are accepted.
+    if (descr.size() != 3 || descr[0] == '>')
+        return false;
+    const std::string kind = descr.substr(1);
+    if (kind == "f4")
+        type = nvinfer1::DataType::kFLOAT;
+    else if (kind == "f2")
+        type = nvinfer1::DataType::kHALF;
+    else if (kind == "i4")
+        type = nvinfer1::DataType::kINT32;
+    else if (kind == "i1")
+        type = nvinfer1::DataType::kINT8;
+    else
+        return false;
+    return true;
+}
+
+inline bool isNpyFile(const void* data, size_t size)
+{
+    static const char kMAGIC[] = "\x93NUMPY";
+    return size >= 10 && std::memcmp(data, kMAGIC, 6) == 0;
+}
+
+//!
+//! \brief Parse the header of a .npy file held in memory.
+//!
+//! \return false with a description in error if the header is malformed or describes an unsupported layout.
+//!
+inline bool parseNpyHeader(const void* data, size_t size, TensorFileInfo& info, std::string& error)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    if (!isNpyFile(data, size))
+    {
+        error = "missing .npy magic string";
+        return false;
+    }
+
+    const int major = bytes[6];
+    size_t headerLength{0};
+    size_t headerStart{0};
+    if (major == 1)
+    {
+        headerLength = bytes[8] | (bytes[9] << 8);
+        headerStart = 10;
+    }
+    else if (major == 2 || major == 3)
+    {
+        if (size < 12)
+        {
+            error = "truncated .npy header";
+            return false;
+        }
+        headerLength = bytes[8] | (bytes[9] << 8) | (bytes[10] << 16) | (static_cast<size_t>(bytes[11]) << 24);
+        headerStart = 12;
+    }
+    else
+    {
+        error = "unsupported .npy version " + std::to_string(major);
+        return false;
+    }
+    if (headerStart + headerLength > size)
+    {
+        error = "truncated .npy header";
+        return false;
+    }
+
+    const std::string header(reinterpret_cast<const char*>(bytes + headerStart), headerLength);
+    auto valueOf = [&header](const std::string& key) -> std::string {
+        size_t pos = header.find("'" + key + "'");
+        if (pos == std::string::npos)
+            return "";
+        pos = header.find(':', pos);
+        return pos == std::string::npos ? "" : header.substr(pos + 1);
+    };
+
+    std::string descr = valueOf("descr");
+    size_t quote = descr.find('\'');
+    size_t endQuote = quote == std::string::npos ? quote : descr.find('\'', quote + 1);
+    if (endQuote == std::string::npos || !npyDescrToDataType(descr.substr(quote + 1, endQuote - quote - 1), info.type))
+    {
+        error = "unsupported or missing .npy dtype";
+        return false;
+    }
+
+    std::string fortranOrder = valueOf("fortran_order");
+    if (fortranOrder.find("False") != 0 && fortranOrder.find(" False") != 0)
+    {
+        error = "only C-ordered .npy arrays are supported";
+        return false;
+    }
+
+    std::string shape = valueOf("shape");
+    size_t open = shape.find('(');
+    size_t close = shape.find(')');
+    if (open == std::string::npos || close == std::string::npos || close < open)
+    {
+        error = "missing .npy shape";
+        return false;
+    }
+    info.shape.clear();
+    std::istringstream dims(shape.substr(open + 1, close - open - 1));
+    std::string dim;
+    while (std::getline(dims, dim, ','))
+    {
+        if (dim.find_first_of("0123456789") != std::string::npos)
+            info.shape.push_back(std::strtoll(dim.c_str(), nullptr, 10));
+    }
+
+    int64_t elements = 1;
+    for (int64_t d : info.shape)
+        elements *= d;
+    info.isNpy = true;
+    info.dataOffset = headerStart + headerLength;
+    info.dataSize = static_cast<size_t>(elements) * tensorElementSize(info.type);
+    if (info.dataOffset + info.dataSize > size)
+    {
+        error = "file is smaller than its .npy header describes";
+        return false;
+    }
+    return true;
+}
+
+//!
+//! \brief Returns a .npy version 1.0 header for a C-ordered tensor. It is padded so that the data that follows
+//!        starts at a multiple of 64 bytes, as NumPy does.
+//!
+inline std::string npyHeader(nvinfer1::DataType type, const std::vector<int64_t>& shape)
+{
+    std::string dict = "{'descr': '" + npyDescr(type) + "', 'fortran_order': False, 'shape': (";
+    for (size_t i = 0; i < shape.size(); i++)
+        dict += std::to_string(shape[i]) + (shape.size() == 1 ? "," : i + 1 < shape.size() ? ", " : "");
+    dict += "), }";
+    const size_t kPREAMBLE = 10;
+    size_t total = (kPREAMBLE + dict.size() + 1 + 63) / 64 * 64;
+    dict.append(total - kPREAMBLE - dict.size() - 1, ' ');
+    dict += '\n';
+
+    std::string header("\x93NUMPY\x01\x00", 8);
+    header += static_cast<char>(dict.size() & 0xFF);
+    header += static_cast<char>(dict.size() >> 8);
+    return header + dict;
+}
+
+//!
+//! \brief Write size bytes of tensor data to fileName, as a raw file or as a .npy file of the given shape.
+//!
+//! \return false with a description in error if the file cannot be written.
+//!
+inline bool writeTensorFile(const std::string& fileName, const void* data, size_t size, nvinfer1::DataType type,
+                            const std::vector<int64_t>& shape, bool npy, std::string& error)
+{
+    std::ofstream file(fileName, std::ios::binary);
+    if (npy)
+    {
+        const std::string header = npyHeader(type, shape);
+        file.write(header.data(), header.size());
+    }
+    file.write(static_cast<const char*>(data), size);
+    file.close();
+    if (!file)
+    {
+        error = "cannot write " + fileName;
+        return false;
+    }
+    return true;
+}
+
+//!
+//! \class TensorDataset
+//! \brief A memory-mapped raw or .npy file holding one or more samples of a binding, served batch by batch.
+//!
+//! \details A sample is one batch item of the binding. Batches are taken from consecutive samples and wrap around
+//!          at the end of the file, so a dataset of any length can feed any number of iterations.
+//!          Raw files are interpreted with the binding's type; .npy files must match it and must either hold a
+//!          single sample or end in the binding's dimensions.
+//!
+class TensorDataset
+{
+public:
+    //!
+    //! \return false with a description in error if the file cannot be mapped or does not fit the binding.
+    //!
+    bool open(const std::string& fileName, nvinfer1::DataType type, const nvinfer1::Dims& dims, std::string& error)
+    {
+        if (!mFile.open(fileName))
+        {
+            error = "cannot map " + fileName + ": " + std::strerror(errno);
+            return false;
+        }
+
+        int64_t volume = 1;
+        for (int i = 0; i < dims.nbDims; i++)
+            volume *= dims.d[i];
+        mSampleSize = static_cast<size_t>(volume) * tensorElementSize(type);
+
+        mInfo = TensorFileInfo();
+        if (isNpyFile(mFile.data(), mFile.size()))
+        {
+            if (!parseNpyHeader(mFile.data(), mFile.size(), mInfo, error))
+            {
+                error = fileName + ": " + error;
+                return false;
+            }
+            if (mInfo.type != type)
+            {
+                error = fileName + ": dtype does not match the binding, expected " + npyDescr(type);
+                return false;
+            }
+            if (!shapeMatches(mInfo.shape, dims, volume))
+            {
+                error = fileName + ": shape does not match the binding dimensions";
+                return false;
+            }
+        }
+        else
+        {
+            mInfo.type = type;
+            mInfo.dataSize = mFile.size();
+        }
+
+        if (mSampleSize == 0 || mInfo.dataSize == 0 || mInfo.dataSize % mSampleSize != 0)
+        {
+            error = fileName + ": size " + std::to_string(mInfo.dataSize) + " is not a multiple of the sample size "
+                + std::to_string(mSampleSize);
+            return false;
+        }
+        mNbSamples = static_cast<int64_t>(mInfo.dataSize / mSampleSize);
+        return true;
+    }
+
+    int64_t getNbSamples() const { return mNbSamples; }
+    size_t getSampleSize() const { return mSampleSize; }
+    const TensorFileInfo& getInfo() const { return mInfo; }
+
+    //!
+    //! \brief Returns the number of distinct batches before the dataset repeats.
+    //!
+    int64_t getNbBatches(int batchSize) const
+    {
+        int64_t gcd = mNbSamples;
+        for (int64_t b = batchSize; b != 0;)
+        {
+            int64_t t = gcd % b;
+            gcd = b;
+            b = t;
+        }
+        return mNbSamples / gcd;
+    }
+
+    //!
+    //! \brief Copy batch batchIndex (counted from the start of the file, wrapping around) of batchSize samples
+    //!        straight from the mapping into dst, which must hold batchSize * getSampleSize() bytes.
+    //!
+    void copyBatch(int64_t batchIndex, int batchSize, void* dst) const
+    {
+        const char* src = static_cast<const char*>(mFile.data()) + mInfo.dataOffset;
+        char* out = static_cast<char*>(dst);
+        int64_t sample = (batchIndex % mNbSamples) * batchSize % mNbSamples;
+        for (int64_t remaining = batchSize; remaining > 0;)
+        {
+            int64_t n = std::min(remaining, mNbSamples - sample);
+            std::memcpy(out, src + sample * mSampleSize, n * mSampleSize);
+            out += n * mSampleSize;
+            remaining -= n;
+            sample = 0;
+        }
+    }
+
+    //!
+    //! \brief Copy count samples starting at sample first into dst. The range must lie within the file.
+    //!
+    void copySamples(int64_t first, int64_t count, void* dst) const
+    {
+        assert(first >= 0 && first + count <= mNbSamples);
+        const char* src = static_cast<const char*>(mFile.data()) + mInfo.dataOffset;
+        std::memcpy(dst, src + first * mSampleSize, count * mSampleSize);
+    }
+
+private:
+    static bool shapeMatches(const std::vector<int64_t>& shape, const nvinfer1::Dims& dims, int64_t volume)
+    {
+        int64_t elements = 1;
+        for (int64_t d : shape)
+            elements *= d;
+        if (elements == volume)
+            return true;
+        if (static_cast<int>(shape.size()) < dims.nbDims)
+            return false;
+        return std::equal(dims.d, dims.d + dims.nbDims, shape.end() - dims.nbDims);
+    }
+
+    MappedFile mFile;
+    TensorFileInfo mInfo;
+    size_t mSampleSize{0};
+    int64_t mNbSamples{0};
+};
+
+//!
+//! \class TensorTextWriter
+//! \brief Formats tensors as text into a preallocated buffer that is written out in large blocks.
+//!
+//! \details Integers and floating-point values are formatted by hand, which avoids the per-element virtual calls,
+//!          locale lookups and sentry objects of formatting through std::ostream, and most of the cost of
+//!          snprintf. The output is the same as streaming each element with the stream's precision: values that
+//!          cannot be rounded exactly in double arithmetic, and infinities and NaNs, fall back to snprintf.
+//!
+class TensorTextWriter
+{
+public:
+    explicit TensorTextWriter(std::ostream& os, size_t bufferSize = 1 << 16)
+        : mOs(os)
+        , mBuffer(bufferSize < 64 ? 64 : bufferSize)
+        , mPrecision(static_cast<int>(os.precision()))
+    {
+    }
+
+    ~TensorTextWriter() { flush(); }
+
+    //!
+    //! \brief Write count elements, rowCount to a line separated by spaces. Every line but a final partial row
+    //!        ends with a newline, except that a rowCount of 1 puts no newline after the last element.
+    //!
+    template <typename T>
+    void write(const T* data, size_t count, size_t rowCount)
+    {
+        assert(rowCount != 0);
+        for (size_t i = 0; i < count; i += rowCount)
+        {
+            const size_t end = std::min(count, i + rowCount);
+            for (size_t j = i; j < end; j++)
+            {
+                if (j != i)
+                    put(' ');
+                append(data[j]);
+            }
+            if (end - i == rowCount && (rowCount != 1 || end != count))
+                put('\n');
+        }
+    }
+
+    void writeString(const std::string& str)
+    {
+        for (char c : str)
+            put(c);
+    }
+
+    void flush()
+    {
+        if (mUsed)
+            mOs.write(mBuffer.data(), mUsed);
+        mUsed = 0;
+    }
+
+private:
+    static const size_t kMAX_ELEMENT_CHARS = 32;
+
+    void put(char c)
+    {
+        reserve(1);
+        mBuffer[mUsed++] = c;
+    }
+
+    void reserve(size_t n)
+    {
+        if (mUsed + n > mBuffer.size())
+            flush();
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value>::type append(T value)
+    {
+        reserve(kMAX_ELEMENT_CHARS);
+        char digits[24];
+        int n = 0;
+        // Widen so that int8_t prints as a number, and negate in unsigned arithmetic so INT_MIN works.
+        const int64_t wide = value;
+        uint64_t magnitude = wide < 0 ? 0 - static_cast<uint64_t>(wide) : static_cast<uint64_t>(wide);
+        do
+        {
+            digits[n++] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude);
+        if (wide < 0)
+            mBuffer[mUsed++] = '-';
+        while (n)
+            mBuffer[mUsed++] = digits[--n];
+    }
+
+    template <typename T>
+    typename std::enable_if<!std::is_integral<T>::value>::type append(const T& value)
+    {
+        reserve(kMAX_ELEMENT_CHARS);
+        const double x = static_cast<float>(value);
+        if (!formatGeneral(x))
+        {
+            int n = std::snprintf(&mBuffer[mUsed], kMAX_ELEMENT_CHARS, "%.*g", mPrecision, x);
+            mUsed += n > 0 ? std::min(static_cast<size_t>(n), kMAX_ELEMENT_CHARS - 1) : 0;
+        }
+    }
+
+    //!
+    //! \brief Format x like printf("%.*g", mPrecision, x). Returns false, without writing anything, if the result
+    //!        cannot be guaranteed to match, so that the caller falls back to snprintf.
+    //!
+    bool formatGeneral(double x)
+    {
+        const int precision = mPrecision == 0 ? 1 : mPrecision;
+        // Beyond 9 digits the scaled value carries too few fraction bits in a double to detect ties reliably.
+        if (!std::isfinite(x) || precision > 9)
+            return false;
+        char* out = &mBuffer[mUsed];
+        char* p = out;
+        if (std::signbit(x))
+            *p++ = '-';
+        x = std::fabs(x);
+        if (x == 0)
+        {
+            *p++ = '0';
+            mUsed += p - out;
+            return true;
+        }
+
+        // Round to precision significant digits: digits = round(x * 10^(precision - 1 - exponent)).
+        int exponent = static_cast<int>(std::floor(std::log10(x)));
+        const double limit = pow10(precision);
+        double scaled{0};
+        for (int attempt = 0; attempt < 2; attempt++)
+        {
+            scaled = x * pow10(precision - 1 - exponent);
+            if (scaled >= limit)
+                exponent++;
+            else if (scaled < limit / 10)
+                exponent--;
+            else
+                break;
+        }
+        scaled = x * pow10(precision - 1 - exponent);
+        if (!(scaled >= limit / 10 && scaled < limit))
+            return false;
+        double integral = std::floor(scaled);
+        const double fraction = scaled - integral;
+        // A tie or near-tie may round either way in exact decimal arithmetic.
+        if (std::fabs(fraction - 0.5) < 1e-6)
+            return false;
+        uint64_t digits = static_cast<uint64_t>(integral) + (fraction > 0.5);
+        if (digits >= static_cast<uint64_t>(limit))
+        {
+            digits /= 10;
+            exponent++;
+        }
+
+        char text[20];
+        for (int i = precision - 1; i >= 0; i--)
+        {
+            text[i] = static_cast<char>('0' + digits % 10);
+            digits /= 10;
+        }
+        int nbDigits = precision;
+        while (nbDigits > 1 && text[nbDigits - 1] == '0')
+            nbDigits--;
+
+        if (exponent < -4 || exponent >= precision)
+        {
+            *p++ = text[0];
+            if (nbDigits > 1)
+            {
+                *p++ = '.';
+                for (int i = 1; i < nbDigits; i++)
+                    *p++ = text[i];
+            }
+            *p++ = 'e';
+            *p++ = exponent < 0 ? '-' : '+';
+            int e = exponent < 0 ? -exponent : exponent;
+            if (e >= 100)
+                *p++ = static_cast<char>('0' + e / 100);
+            *p++ = static_cast<char>('0' + e / 10 % 10);
+            *p++ = static_cast<char>('0' + e % 10);
+        }
+        else if (exponent >= 0)
+        {
+            for (int i = 0; i <= exponent; i++)
+                *p++ = i < nbDigits ? text[i] : '0';
+            if (nbDigits > exponent + 1)
+            {
+                *p++ = '.';
+                for (int i = exponent + 1; i < nbDigits; i++)
+                    *p++ = text[i];
+            }
+        }
+        else
+        {
+            *p++ = '0';
+            *p++ = '.';
+            for (int i = exponent; i < -1; i++)
+                *p++ = '0';
+            for (int i = 0; i < nbDigits; i++)
+                *p++ = text[i];
+        }
+        mUsed += p - out;
+        return true;
+    }
+
+    static double pow10(int e)
+    {
+        static const double kPOWERS[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+            1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        if (e >= 0 && e <= 22)
+            return kPOWERS[e];
+        return std::pow(10.0, e);
+    }
+
+    std::ostream& mOs;
+    std::vector<char> mBuffer;
+    size_t mUsed{0};
+    int mPrecision;
+};
+
+//!
+//! \brief Parse the numbers of a text dump written by TensorTextWriter. A first line starting with '[', holding the
+//!        shape, is skipped.
+//!
+//! \return false with a description in error if something other than numbers and whitespace is found.
+//!
+inline bool parseTensorText(const char* text, size_t size, std::vector<double>& values, std::string& error)
+{
+    values.clear();
+    const std::string str(text, size);
+    size_t pos = str.find_first_not_of(" \t\r\n");
+    if (pos != std::string::npos && str[pos] == '[')
+        pos = str.find('\n', pos);
+    const char* p = str.c_str() + (pos == std::string::npos ? str.size() : pos);
+    for (;;)
+    {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+            p++;
+        if (!*p)
+            return true;
+        char* end = nullptr;
+        double value = std::strtod(p, &end);
+        if (end == p)
+        {
+            error = "unexpected character '" + std::string(1, *p) + "' after " + std::to_string(values.size()) + " values";
+            return false;
+        }
+        values.push_back(value);
+        p = end;
+    }
+}
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_TENSOR_FILE_H
@@ -0,0 +1,540 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_TENSOR_VIEW_H
+#define TENSORRT_TENSOR_VIEW_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace samplesCommon
+{
+
+//!
+//! \class TensorView
+//! \brief Non-owning typed view of a strided tensor in host memory.
+//!
+//! \details A view is a pointer, a shape and a stride per dimension, in elements. It is cheap to copy and never
+//!          allocates, so views of the same buffer with a different layout, a batch slice or a single channel can
+//!          be made freely. Strides may be negative, e.g. to reverse the channel order of an image with flip().
+//!
+//!          Use copyTensor() and convertTensor() to move data between views of different layouts or types.
+//!
+template <typename T>
+class TensorView
+{
+public:
+    static const int kMAX_DIMS = 8;
+
+    //!
+    //! \brief An empty view; valid() is false.
+    //!
+    TensorView()
+        : mData(nullptr)
+        , mNbDims(0)
+    {
+    }
+
+    //!
+    //! \brief A contiguous row-major view of data, e.g. TensorView<float>(data, {N, C, H, W}).
+    //!
+    TensorView(T* data, std::initializer_list<int64_t> shape)
+        : TensorView(data, shape.begin(), shape.end())
+    {
+    }
+
+    //!
+    //! \brief A contiguous row-major view of data with the dimensions in [first, last).
+    //!
+    template <typename DimIt>
+    TensorView(T* data, DimIt first, DimIt last)
+        : mData(data)
+        , mNbDims(static_cast<int>(std::distance(first, last)))
+    {
+        assert(mNbDims <= kMAX_DIMS);
+        std::copy(first, last, mDims);
+        int64_t stride = 1;
+        for (int i = mNbDims - 1; i >= 0; i--)
+        {
+            mStrides[i] = stride;
+            stride *= mDims[i];
+        }
+    }
+
+    //!
+    //! \brief A view of data with arbitrary strides, in elements.
+    //!
+    TensorView(T* data, int nbDims, const int64_t* dims, const int64_t* strides)
+        : mData(data)
+        , mNbDims(nbDims)
+    {
+        assert(nbDims <= kMAX_DIMS);
+        std::copy(dims, dims + nbDims, mDims);
+        std::copy(strides, strides + nbDims, mStrides);
+    }
+
+    //!
+    //! \brief Read-only view of a mutable view.
+    //!
+    template <typename U, typename = typename std::enable_if<std::is_same<const U, T>::value && !std::is_same<U, T>::value>::type>
+    TensorView(const TensorView<U>& view)
+        : mData(view.data())
+        , mNbDims(view.getNbDims())
+    {
+        for (int i = 0; i < mNbDims; i++)
+        {
+            mDims[i] = view.dim(i);
+            mStrides[i] = view.stride(i);
+        }
+    }
+
+    T* data() const { return mData; }
+
+    bool valid() const { return mData != nullptr; }
+
+    int getNbDims() const { return mNbDims; }
+
+    int64_t dim(int i) const { return mDims[i]; }
+
+    int64_t stride(int i) const { return mStrides[i]; }
+
+    //!
+    //! \brief Returns the number of elements.
+    //!
+    int64_t volume() const
+    {
+        int64_t v = 1;
+        for (int i = 0; i < mNbDims; i++)
+            v *= mDims[i];
+        return v;
+    }
+
+    //!
+    //! \brief Returns true if the elements are dense and in row-major order.
+    //!
+    bool isContiguous() const
+    {
+        int64_t stride = 1;
+        for (int i = mNbDims - 1; i >= 0; i--)
+        {
+            if (mDims[i] != 1 && mStrides[i] != stride)
+                return false;
+            stride *= mDims[i];
+        }
+        return true;
+    }
+
+    //!
+    //! \brief Returns true if both views have the same shape.
+    //!
+    template <typename U>
+    bool sameShape(const TensorView<U>& other) const
+    {
+        if (mNbDims != other.getNbDims())
+            return false;
+        for (int i = 0; i < mNbDims; i++)
+        {
+            if (mDims[i] != other.dim(i))
+                return false;
+        }
+        return true;
+    }
+
+    //!
+    //! \brief The element at the given index, one coordinate per dimension: view(n, c, h, w).
+    //!
+    template <typename... Idx>
+    T& operator()(Idx... idx) const
+    {
+        const int64_t index[] = {static_cast<int64_t>(idx)...};
+        assert(static_cast<int>(sizeof...(Idx)) == mNbDims);
+        int64_t offset = 0;
+        for (int i = 0; i < mNbDims; i++)
+        {
+            assert(index[i] >= 0 && index[i] < mDims[i]);
+            offset += index[i] * mStrides[i];
+        }
+        return mData[offset];
+    }
+
+    //!
+    //! \brief The sub-tensor at index i of the first dimension, e.g. one sample of a batch or one channel of it.
+    //!
+    TensorView operator[](int64_t i) const
+    {
+        assert(mNbDims > 0 && i >= 0 && i < mDims[0]);
+        return TensorView(mData + i * mStrides[0], mNbDims - 1, mDims + 1, mStrides + 1);
+    }
+
+    //!
+    //! \brief The samples [begin, end) of the batch, i.e. of the first dimension.
+    //!
+    TensorView slice(int64_t begin, int64_t end) const { return narrow(0, begin, end); }
+
+    //!
+    //! \brief The sub-view [begin, end) of dimension d.
+    //!
+    TensorView narrow(int d, int64_t begin, int64_t end) const
+    {
+        assert(d >= 0 && d < mNbDims && begin >= 0 && begin <= end && end <= mDims[d]);
+        TensorView view(*this);
+        view.mData += begin * mStrides[d];
+        view.mDims[d] = end - begin;
+        return view;
+    }
+
+    //!
+    //! \brief The same elements with the dimensions reordered: dimension i of the result is dimension order[i]
+    //!        of this view. For instance an NHWC view permuted with {0, 3, 1, 2} is indexed as NCHW.
+    //!
+    TensorView permute(std::initializer_list<int> order) const
+    {
+        assert(static_cast<int>(order.size()) == mNbDims);
+        TensorView view(*this);
+        int i = 0;
+        for (int d : order)
+        {
+            assert(d >= 0 && d < mNbDims);
+            view.mDims[i] = mDims[d];
+            view.mStrides[i] = mStrides[d];
+            i++;
+        }
+        return view;
+    }
+
+    //!
+    //! \brief The same elements with dimension d in reverse order, e.g. to turn RGB channels into BGR.
+    //!
+    TensorView flip(int d) const
+    {
+        assert(d >= 0 && d < mNbDims);
+        TensorView view(*this);
+        if (mDims[d] > 0)
+            view.mData += (mDims[d] - 1) * mStrides[d];
+        view.mStrides[d] = -mStrides[d];
+        return view;
+    }
+
+private:
+    T* mData;
+    int mNbDims;
+    int64_t mDims[kMAX_DIMS];
+    int64_t mStrides[kMAX_DIMS];
+};
+
+template <typename T>
+const int TensorView<T>::kMAX_DIMS;
+
+namespace detail
+{
+
+//!
+//! \brief Shape and strides shared by the source and the destination of a copy, simplified for the copy loops.
+//!
+struct CopyLayout
+{
+    int nbDims{0};
+    int64_t dims[TensorView<int>::kMAX_DIMS];
+    int64_t src[TensorView<int>::kMAX_DIMS];
+    int64_t dst[TensorView<int>::kMAX_DIMS];
+};
+
+//!
+//! \brief Drop unit dimensions, merge dimensions that are contiguous in both views, and, for layout changes, move
+//!        the dimension that is contiguous in the source right before the one that is contiguous in the
+//!        destination so that the two can be tiled.
+//!
+template <typename S, typename D>
+CopyLayout makeCopyLayout(const TensorView<S>& src, const TensorView<D>& dst)
+{
+    CopyLayout layout;
+    for (int i = 0; i < dst.getNbDims(); i++)
+    {
+        if (dst.dim(i) == 1)
+            continue;
+        int n = layout.nbDims;
+        if (n > 0 && layout.src[n - 1] == src.stride(i) * dst.dim(i) && layout.dst[n - 1] == dst.stride(i) * dst.dim(i))
+        {
+            layout.dims[n - 1] *= dst.dim(i);
+            layout.src[n - 1] = src.stride(i);
+            layout.dst[n - 1] = dst.stride(i);
+            continue;
+        }
+        layout.dims[n] = dst.dim(i);
+        layout.src[n] = src.stride(i);
+        layout.dst[n] = dst.stride(i);
+        layout.nbDims++;
+    }
+
+    int last = layout.nbDims - 1;
+    if (last >= 1 && layout.src[last] != 1)
+    {
+        for (int k = last - 1; k >= 0; k--)
+        {
+            if (layout.src[k] == 1)
+            {
+                std::swap(layout.dims[k], layout.dims[last - 1]);
+                std::swap(layout.src[k], layout.src[last - 1]);
+                std::swap(layout.dst[k], layout.dst[last - 1]);
+                break;
+            }
+        }
+    }
+    return layout;
+}
+
+//!
+//! \brief Element conversion of a copy: a plain cast, or scale * x + shift computed in float.
+//!
+template <typename S, typename D>
+struct ConvertOp
+{
+    float scale;
+    float shift;
+    bool affine;
+
+    D operator()(const S& x) const
+    {
+        return affine ? static_cast<D>(static_cast<float>(x) * scale + shift) : static_cast<D>(x);
+    }
+};
+
+//!
+//! \brief Convert n contiguous elements. Plain copies of the same type are memcpys, and the common
+//!        uint8 -> float and float -> float conversions of preprocessing are vectorized.
+//!
+template <typename S, typename D>
+void convertRun(const S* src, D* dst, int64_t n, const ConvertOp<S, D>& op)
+{
+    if (std::is_same<S, D>::value && !op.affine)
+    {
+        std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(D));
+        return;
+    }
+    for (int64_t i = 0; i < n; i++)
+        dst[i] = op(src[i]);
+}
+
+#if defined(__SSE2__)
+inline void convertRun(const float* src, float* dst, int64_t n, const ConvertOp<float, float>& op)
+{
+    if (!op.affine)
+    {
+        std::memcpy(dst, src, n * sizeof(float));
+        return;
+    }
+    const __m128 scale = _mm_set1_ps(op.scale);
+    const __m128 shift = _mm_set1_ps(op.shift);
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), shift));
+    for (; i < n; i++)
+        dst[i] = op(src[i]);
+}
+
+inline void convertRun(const uint8_t* src, float* dst, int64_t n, const ConvertOp<uint8_t, float>& op)
+{
+    const __m128 scale = _mm_set1_ps(op.affine ? op.scale : 1.0f);
+    const __m128 shift = _mm_set1_ps(op.affine ? op.shift : 0.0f);
+    const __m128i zero = _mm_setzero_si128();
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+        __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+        __m128i words[4] = {_mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero), _mm_unpacklo_epi16(hi, zero),
+            _mm_unpackhi_epi16(hi, zero)};
+        for (int j = 0; j < 4; j++)
+            _mm_storeu_ps(dst + i + 4 * j, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(words[j]), scale), shift));
+    }
+    for (; i < n; i++)
+        dst[i] = op(src[i]);
+}
+#endif
+
+//!
+//! \brief Copy the elements of layout, one dimension per level of recursion. The last dimension is a contiguous
+//!        run, a strided loop, or, when the one before it is contiguous in the source, a tiled transpose that
+//!        reads and writes whole cache lines.
+//!
+template <typename S, typename D>
+void copyLayout(const CopyLayout& layout, int d, const S* src, D* dst, const ConvertOp<S, D>& op)
+{
+    const int last = layout.nbDims - 1;
+    if (last < 0)
+    {
+        *dst = op(*src);
+        return;
+    }
+    if (d == last - 1 && layout.src[d] == 1 && layout.dst[last] == 1)
+    {
+        const int64_t kTILE = 32;
+        const int64_t rows = layout.dims[d], cols = layout.dims[last];
+        const int64_t srcCol = layout.src[last], dstRow = layout.dst[d];
+        for (int64_t r0 = 0; r0 < rows; r0 += kTILE)
+        {
+            const int64_t r1 = std::min(rows, r0 + kTILE);
+            for (int64_t c0 = 0; c0 < cols; c0 += kTILE)
+            {
+                const int64_t c1 = std::min(cols, c0 + kTILE);
+                for (int64_t r = r0; r < r1; r++)
+                {
+                    for (int64_t c = c0; c < c1; c++)
+                        dst[r * dstRow + c] = op(src[r + c * srcCol]);
+                }
+            }
+        }
+        return;
+    }
+    if (d == last)
+    {
+        const int64_t n = layout.dims[d];
+        if (layout.src[d] == 1 && layout.dst[d] == 1)
+        {
+            convertRun(src, dst, n, op);
+            return;
+        }
+        for (int64_t i = 0; i < n; i++)
+            dst[i * layout.dst[d]] = op(src[i * layout.src[d]]);
+        return;
+    }
+    for (int64_t i = 0; i < layout.dims[d]; i++)
+        copyLayout(layout, d + 1, src + i * layout.src[d], dst + i * layout.dst[d], op);
+}
+
+//! Below this many elements a copy runs on the calling thread only.
+constexpr int64_t kPARALLEL_COPY_ELEMENTS = int64_t(1) << 20;
+
+template <typename S, typename D>
+bool convertTensor(const TensorView<S>& src, const TensorView<D>& dst, const ConvertOp<typename std::remove_const<S>::type, D>& op, int nbThreads)
+{
+    static_assert(!std::is_const<D>::value, "the destination of a copy must be writable");
+    if (!src.sameShape(dst) || (!src.valid() && src.volume() > 0) || (!dst.valid() && dst.volume() > 0))
+        return false;
+    const int64_t volume = dst.volume();
+    if (volume == 0)
+        return true;
+
+    CopyLayout layout = makeCopyLayout(src, dst);
+    if (nbThreads <= 0)
+    {
+        int64_t wanted = volume / kPARALLEL_COPY_ELEMENTS;
+        nbThreads = static_cast<int>(std::min<int64_t>(std::max<int64_t>(wanted, 1), std::max(1u, std::thread::hardware_concurrency())));
+    }
+    // Split the largest dimension into one range per thread; the copy loops work on any part of the layout.
+    int split = 0;
+    for (int i = 1; i < layout.nbDims; i++)
+    {
+        if (layout.dims[i] > layout.dims[split])
+            split = i;
+    }
+    const int64_t extent = layout.nbDims ? layout.dims[split] : 1;
+    nbThreads = static_cast<int>(std::min<int64_t>(nbThreads, extent));
+
+    if (nbThreads <= 1)
+    {
+        copyLayout(layout, 0, src.data(), dst.data(), op);
+        return true;
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nbThreads; t++)
+    {
+        const int64_t begin = extent * t / nbThreads, end = extent * (t + 1) / nbThreads;
+        threads.emplace_back([&layout, &src, &dst, &op, split, begin, end]() {
+            CopyLayout part = layout;
+            part.dims[split] = end - begin;
+            copyLayout(part, 0, src.data() + begin * layout.src[split], dst.data() + begin * layout.dst[split], op);
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    return true;
+}
+
+} // namespace detail
+
+//!
+//! \brief Copy src into dst, which must have the same shape but may have a different layout (e.g. an NHWC view
+//!        permuted to NCHW) and a different element type.
+//!
+//! \param nbThreads Number of threads to split the copy over, or 0 to use one per 2^20 elements, up to the
+//!        number of hardware threads.
+//!
+//! \return false if the shapes differ.
+//!
+template <typename S, typename D>
+bool copyTensor(const TensorView<S>& src, const TensorView<D>& dst, int nbThreads = 0)
+{
+    return detail::convertTensor(src, dst, detail::ConvertOp<typename std::remove_const<S>::type, D>{1.0f, 0.0f, false}, nbThreads);
+}
+
+//!
+//! \brief Like copyTensor, but stores scale * x + shift, computed in float, for every element x of src. This is
+//!        the usual normalization of images, e.g. scale = 2 / 255 and shift = -1.
+//!
+template <typename S, typename D>
+bool convertTensor(const TensorView<S>& src, const TensorView<D>& dst, float scale, float shift, int nbThreads = 0)
+{
+    return detail::convertTensor(src, dst, detail::ConvertOp<typename std::remove_const<S>::type, D>{scale, shift, true}, nbThreads);
+}
+
+} // namespace samplesCommon
+
+#endif // TENSORRT_TENSOR_VIEW_H
@@ -64,6 +64,7 @@
 #include "common.h"
 #include "logger.h"
 #include "argsParser.h"
+#include "tensorView.h"
 
 const std::string gSampleName = "TensorRT.sample_fasterRCNN";
 
@@ -322,7 +323,8 @@ void printHelp(const char* name)
     std::cout << "Usage: " << name << "\n"
         << "Optional Parameters:\n"
         << "  -h, --help        Display help information.\n"
-        << "  --useDLACore=N    Specify the DLA engine to run on.\n";
+        << "  --useDLACore=N    Specify the DLA engine to run on.\n"
+        << "  --engineCache=<dir> Reuse the engine built by an earlier run with the same model and settings.\n";
 }
 
 
@@ -339,16 +341,30 @@ int main(int argc, char** argv)
 
     gLogger.reportTestStart(sampleTest);
 
-    IHostMemory* trtModelStream{nullptr};
     initLibNvInferPlugins(&gLogger.getTRTLogger(), "");
 
     // Batch size
     const int N = 5;
-    // Create a TensorRT model from the caffe model and serialize it to a stream
-    caffeToTRTModel("faster_rcnn_test_iplugin.prototxt",
-                    "VGG16_faster_rcnn_final.caffemodel",
-                    std::vector<std::string>{OUTPUT_BLOB_NAME0, OUTPUT_BLOB_NAME1, OUTPUT_BLOB_NAME2},
-                    N, &trtModelStream);
+
+    samplesCommon::EngineCache engineCache(gArgs.engineCache);
+    samplesCommon::EngineCacheKey cacheKey = samplesCommon::createEngineCacheKey();
+    if (engineCache.isEnabled())
+    {
+        cacheKey.addFile(locateFile("faster_rcnn_test_iplugin.prototxt"))
+            .addFile(locateFile("VGG16_faster_rcnn_final.caffemodel"))
+            .addSetting("batch", N)
+            .addSetting("useDLACore", gArgs.useDLACore);
+    }
+
+    // Create a TensorRT model from the caffe model and serialize it to a stream, unless it is already cached
+    IHostMemory* trtModelStream = samplesCommon::loadOrBuildPlan(engineCache, cacheKey, [&]() {
+        IHostMemory* stream{nullptr};
+        caffeToTRTModel("faster_rcnn_test_iplugin.prototxt",
+                        "VGG16_faster_rcnn_final.caffemodel",
+                        std::vector<std::string>{OUTPUT_BLOB_NAME0, OUTPUT_BLOB_NAME1, OUTPUT_BLOB_NAME2},
+                        N, &stream);
+        return stream;
+    });
     assert(trtModelStream != nullptr);
 
     // Available images
@@ -368,14 +384,13 @@ int main(int argc, char** argv)
     float* data = new float[N * INPUT_C * INPUT_H * INPUT_W];
     // Pixel mean used by the Faster R-CNN's author
     float pixelMean[3]{102.9801f, 115.9465f, 122.7717f}; // Also in BGR order
-    for (int i = 0, volImg = INPUT_C * INPUT_H * INPUT_W; i < N; ++i)
+    samplesCommon::TensorView<float> input(data, {N, INPUT_C, INPUT_H, INPUT_W});
+    for (int i = 0; i < N; ++i)
     {
+        // The PPM is HWC in RGB order, and the color image to input should be CHW in BGR order
+        auto image = samplesCommon::TensorView<const uint8_t>(ppms[i].buffer, {INPUT_H, INPUT_W, INPUT_C}).permute({2, 0, 1}).flip(0);
         for (int c = 0; c < INPUT_C; ++c)
-        {
-            // The color image to input should be in BGR order
-            for (unsigned j = 0, volChl = INPUT_H * INPUT_W; j < volChl; ++j)
-                data[i * volImg + c * volChl + j] = float(ppms[i].buffer[j * INPUT_C + 2 - c]) - pixelMean[c];
-        }
+            samplesCommon::convertTensor(image[c], input[i][c], 1.0f, -pixelMean[c]);
     }
 
     // Deserialize the engine
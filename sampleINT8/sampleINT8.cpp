@@ -48,6 +48,7 @@
  */
 
 #include <cassert>
+#include <cctype>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -66,7 +67,11 @@
 
 #include "NvInfer.h"
 #include "NvCaffeParser.h"
+#include "benchmarkResults.h"
+#include "buffers.h"
+#include "buildOrchestrator.h"
 #include "common.h"
+#include "hashUtils.h"
 
 #include "logger.h"
 #include "BatchStream.h"
@@ -80,12 +85,17 @@ const std::string gSampleName = "TensorRT.sample_int8";
 
 static int gUseDLACore = -1;
 
+static samplesCommon::BenchmarkResults gResults{gSampleName};
+
 // stuff we know about the network and the caffe input/output blobs
 
 const char* INPUT_BLOB_NAME = "data";
 const char* OUTPUT_BLOB_NAME = "prob";
 const char* gNetworkName{nullptr};
 
+// builder workspace of every engine, which is also the memory estimate used to schedule concurrent builds
+const size_t kBUILD_WORKSPACE = size_t(1) << 30;
+
 struct SkipThePrecision : public std::exception
 {
     const char* what() const noexcept
@@ -110,6 +120,7 @@ bool caffeToTRTModel(const std::string& deployFile,           // name for caffe
                      int& maxBatchSize,                       // batch size - NB must be at least as large as the batch we want to run with)
                      DataType dataType,
                      IInt8Calibrator* calibrator,
+                     int dlaCore,
                      nvinfer1::IHostMemory*& trtModelStream)
 {
     // create the builder
@@ -153,20 +164,21 @@ bool caffeToTRTModel(const std::string& deployFile,           // name for caffe
     }
 
     // Build the engine
-    builder->setMaxWorkspaceSize(1 << 30);
+    builder->setMaxWorkspaceSize(kBUILD_WORKSPACE);
     builder->setAverageFindIterations(1);
     builder->setMinFindIterations(1);
     builder->setDebugSync(true);
     builder->setInt8Mode(dataType == DataType::kINT8);
     builder->setFp16Mode(dataType == DataType::kHALF);
     builder->setInt8Calibrator(calibrator);
-    if (gUseDLACore >= 0)
+    if (dlaCore >= 0)
     {
-        samplesCommon::enableDLA(builder, gUseDLACore);
+        samplesCommon::enableDLA(builder, dlaCore);
         if (maxBatchSize > builder->getMaxDLABatchSize())
         {
-            gLogError << "Requested batch size " << maxBatchSize << " is greater than the max DLA batch size of "
-                      << builder->getMaxDLABatchSize() << ". Reducing batch size accordingly." << std::endl;
+            // Builds run concurrently: log through a stream of our own, not the buffer shared by all gLogError users.
+            LOG_ERROR(gLogger) << "Requested batch size " << maxBatchSize << " is greater than the max DLA batch size of "
+                               << builder->getMaxDLABatchSize() << ". Reducing batch size accordingly." << std::endl;
             maxBatchSize = builder->getMaxDLABatchSize();
         }
     }
@@ -174,7 +186,7 @@ bool caffeToTRTModel(const std::string& deployFile,           // name for caffe
     ICudaEngine* engine = builder->buildCudaEngine(*network);
     if (engine == nullptr)
     {
-        gLogError << "Unable to build engine." << std::endl;
+        LOG_ERROR(gLogger) << "Unable to build engine." << std::endl;
     }
 
     // we don't need the network any more, and we can destroy the parser
@@ -191,7 +203,11 @@ bool caffeToTRTModel(const std::string& deployFile,           // name for caffe
     return true;
 }
 
-float doInference(IExecutionContext& context, float* input, float* output, int batchSize)
+//!
+//! \brief Run one batch and return the time spent in the engine. The device buffers come from pool, so scoring
+//!        thousands of batches does not call cudaMalloc and cudaFree for every one of them.
+//!
+float doInference(IExecutionContext& context, float* input, float* output, int batchSize, samplesCommon::DeviceMemoryPool& pool)
 {
     const ICudaEngine& engine = context.getEngine();
     // input and output buffer pointers that we pass to the engine - the engine requires exactly IEngine::getNbBindings(),
@@ -209,8 +225,10 @@ float doInference(IExecutionContext& context, float* input, float* output, int b
     Dims3 outputDims = static_cast<Dims3&&>(context.getEngine().getBindingDimensions(context.getEngine().getBindingIndex(OUTPUT_BLOB_NAME)));
 
     size_t inputSize = batchSize * inputDims.d[0] * inputDims.d[1] * inputDims.d[2] * sizeof(float), outputSize = batchSize * outputDims.d[0] * outputDims.d[1] * outputDims.d[2] * sizeof(float);
-    CHECK(cudaMalloc(&buffers[inputIndex], inputSize));
-    CHECK(cudaMalloc(&buffers[outputIndex], outputSize));
+    samplesCommon::DeviceBuffer inputBuffer(inputSize, samplesCommon::DeviceAllocator(&pool), samplesCommon::DeviceFree(&pool));
+    samplesCommon::DeviceBuffer outputBuffer(outputSize, samplesCommon::DeviceAllocator(&pool), samplesCommon::DeviceFree(&pool));
+    buffers[inputIndex] = inputBuffer.data();
+    buffers[outputIndex] = outputBuffer.data();
 
     CHECK(cudaMemcpy(buffers[inputIndex], input, inputSize, cudaMemcpyHostToDevice));
 
@@ -228,8 +246,6 @@ float doInference(IExecutionContext& context, float* input, float* output, int b
     cudaEventDestroy(end);
 
     CHECK(cudaMemcpy(output, buffers[outputIndex], outputSize, cudaMemcpyDeviceToHost));
-    CHECK(cudaFree(buffers[inputIndex]));
-    CHECK(cudaFree(buffers[outputIndex]));
     CHECK(cudaStreamDestroy(stream));
     return ms;
 }
@@ -257,47 +273,62 @@ int calculateScore(float* batchProb, float* labels, int batchSize, int outputSiz
     return success;
 }
 
-std::pair<float, float> scoreModel(int batchSize, int firstBatch, int nbScoreBatches, DataType datatype, IInt8Calibrator* calibrator, bool quiet = false)
+//!
+//! \brief Build the engine of gNetworkName at one precision. batchSize is reduced if DLA cannot run it.
+//!
+//! \return false if the engine could not be built; throws SkipThePrecision if the platform lacks fast kernels for it.
+//!
+bool buildModel(int& batchSize, DataType datatype, IInt8Calibrator* calibrator, int dlaCore, IHostMemory*& trtModelStream)
 {
-    IHostMemory* trtModelStream{nullptr};
+    trtModelStream = nullptr;
     bool valid = false;
     if (gNetworkName == std::string("mnist"))
     {
-        valid = caffeToTRTModel("deploy.prototxt", "mnist_lenet.caffemodel", std::vector<std::string>{OUTPUT_BLOB_NAME}, batchSize, datatype, calibrator, trtModelStream);
+        valid = caffeToTRTModel("deploy.prototxt", "mnist_lenet.caffemodel", std::vector<std::string>{OUTPUT_BLOB_NAME}, batchSize, datatype, calibrator, dlaCore, trtModelStream);
     }
     else
     {
-        valid = caffeToTRTModel("deploy.prototxt", std::string(gNetworkName) + ".caffemodel", std::vector<std::string>{OUTPUT_BLOB_NAME}, batchSize, datatype, calibrator, trtModelStream);
+        valid = caffeToTRTModel("deploy.prototxt", std::string(gNetworkName) + ".caffemodel", std::vector<std::string>{OUTPUT_BLOB_NAME}, batchSize, datatype, calibrator, dlaCore, trtModelStream);
     }
 
     if (!valid)
     {
-        gLogError << "Engine could not be created at this precision" << std::endl;
-        return std::pair<float, float>(0, 0);
+        LOG_ERROR(gLogger) << "Engine could not be created at this precision" << std::endl;
+        return false;
     }
     if (trtModelStream == nullptr)
     {
-        gLogError << "Network deserialization error." << std::endl;
-        return std::make_pair(0.0f, 0.0f);
+        LOG_ERROR(gLogger) << "Network deserialization error." << std::endl;
+        return false;
     }
+    return true;
+}
 
+//!
+//! \brief Deserialize a plan built by buildModel and score its top-1 and top-5 accuracy. Takes ownership of the plan.
+//!
+std::pair<float, float> scoreEngine(IHostMemory* trtModelStream, int batchSize, int firstBatch, int nbScoreBatches, DataType datatype, int dlaCore, bool quiet = false)
+{
     // Create engine and deserialize model.
     IRuntime* infer = createInferRuntime(gLogger.getTRTLogger());
     if (infer == nullptr)
     {
         gLogError << "Unable to create inference runtime." << std::endl;
+        trtModelStream->destroy();
         return std::make_pair(0.0f, 0.0f);
     }
-    if (gUseDLACore >= 0)
+    if (dlaCore >= 0)
     {
-        infer->setDLACore(gUseDLACore);
+        infer->setDLACore(dlaCore);
     }
     ICudaEngine* engine = infer->deserializeCudaEngine(trtModelStream->data(), trtModelStream->size(), nullptr);
     if (engine == nullptr)
     {
         gLogError << "Unable to deserializeCudaEngine." << std::endl;
+        trtModelStream->destroy();
         return std::make_pair(0.0f, 0.0f);
     }
+    gResults.setEngineHash(samplesCommon::hashBytes(trtModelStream->data(), trtModelStream->size()));
     trtModelStream->destroy();
     IExecutionContext* context = engine->createExecutionContext();
     if (context == nullptr)
@@ -314,10 +345,14 @@ std::pair<float, float> scoreModel(int batchSize, int firstBatch, int nbScoreBat
     int top1{0}, top5{0};
     float totalTime{0.0f};
     std::vector<float> prob(batchSize * outputSize, 0);
+    const std::string precision = datatype == DataType::kINT8 ? "int8" : datatype == DataType::kHALF ? "fp16" : "fp32";
+    samplesCommon::DeviceMemoryPool pool;
 
     while (stream.next())
     {
-        totalTime += doInference(*context, stream.getBatch(), &prob[0], batchSize);
+        float batchTime = doInference(*context, stream.getBatch(), &prob[0], batchSize, pool);
+        totalTime += batchTime;
+        gResults.addSample(precision + ".inferenceTime", "ms", batchTime);
 
         top1 += calculateScore(&prob[0], stream.getLabels(), batchSize, outputSize, 1);
         top5 += calculateScore(&prob[0], stream.getLabels(), batchSize, outputSize, 5);
@@ -336,6 +371,8 @@ std::pair<float, float> scoreModel(int batchSize, int firstBatch, int nbScoreBat
     }
     int imagesRead = stream.getBatchesRead() * batchSize;
     float t1 = float(top1) / float(imagesRead), t5 = float(top5) / float(imagesRead);
+    gResults.addSample(precision + ".top1", "fraction", t1);
+    gResults.addSample(precision + ".top5", "fraction", t5);
 
     if (quiet)
     {
@@ -347,6 +384,7 @@ std::pair<float, float> scoreModel(int batchSize, int firstBatch, int nbScoreBat
         gLogInfo << "Top1: " << t1 << ", Top5: " << t5 << std::endl;
         gLogInfo << "Processing " << imagesRead << " images averaged " << totalTime / imagesRead << " ms/image and " << totalTime / stream.getBatchesRead() << " ms/batch." << std::endl;
     }
+    gLogVerbose << "Device buffer pool: " << pool.getStats() << std::endl;
 
     context->destroy();
     engine->destroy();
@@ -354,24 +392,133 @@ std::pair<float, float> scoreModel(int batchSize, int firstBatch, int nbScoreBat
     return std::make_pair(t1, t5);
 }
 
-std::pair<float, float> scoreModel(int batchSize, int firstScoreBatch, int nbScoreBatches, CalibrationAlgoType calibrationAlgo, bool search)
+std::pair<float, float> scoreModel(int batchSize, int firstBatch, int nbScoreBatches, DataType datatype, IInt8Calibrator* calibrator, bool quiet = false)
+{
+    IHostMemory* trtModelStream{nullptr};
+    if (!buildModel(batchSize, datatype, calibrator, gUseDLACore, trtModelStream))
+    {
+        return std::make_pair(0.0f, 0.0f);
+    }
+    return scoreEngine(trtModelStream, batchSize, firstBatch, nbScoreBatches, datatype, gUseDLACore, quiet);
+}
+
+//!
+//! \brief Create the INT8 calibrator reading calibrationStream. legacyParameters are the cutoff and quantile of the
+//!        legacy calibrator, from getQuantileAndCutoff.
+//!
+std::unique_ptr<IInt8Calibrator> createCalibrator(BatchStream& calibrationStream, CalibrationAlgoType calibrationAlgo, std::pair<double, double> legacyParameters)
 {
     std::unique_ptr<IInt8Calibrator> calibrator;
-    BatchStream calibrationStream(CAL_BATCH_SIZE, NB_CAL_BATCHES);
     if (calibrationAlgo == CalibrationAlgoType::kENTROPY_CALIBRATION)
     {
         calibrator.reset(new Int8EntropyCalibrator(calibrationStream, FIRST_CAL_BATCH, gNetworkName, INPUT_BLOB_NAME));
     }
     else if (calibrationAlgo == CalibrationAlgoType::kLEGACY_CALIBRATION)
     {
-        std::pair<double, double> parameters = getQuantileAndCutoff(gNetworkName, search);
-        calibrator.reset(new Int8LegacyCalibrator(calibrationStream, FIRST_CAL_BATCH, parameters.first, parameters.second));
+        calibrator.reset(new Int8LegacyCalibrator(calibrationStream, FIRST_CAL_BATCH, legacyParameters.first, legacyParameters.second));
     }
     else
     {
         calibrator.reset(new Int8EntropyCalibrator2(calibrationStream, FIRST_CAL_BATCH, gNetworkName, INPUT_BLOB_NAME));
     }
-    return scoreModel(batchSize, firstScoreBatch, nbScoreBatches, DataType::kINT8, calibrator.get());
+    return calibrator;
+}
+
+//!
+//! \brief One precision of the network: how it is built, and the plan once it is.
+//!
+struct PrecisionBuild
+{
+    PrecisionBuild(DataType type, const std::string& name, int dlaCore, int batchSize)
+        : type(type)
+        , name(name)
+        , dlaCore(dlaCore)
+        , batchSize(batchSize)
+    {
+    }
+
+    DataType type;
+    std::string name;
+    int dlaCore;
+    int batchSize;
+    IHostMemory* plan{nullptr};
+    bool skipped{false};
+};
+
+//!
+//! \brief Build every precision on up to buildJobs worker threads, each with its own builder, and report the build times.
+//!
+//! \details Builds are limited to as many 1 GB workspaces as fit into the free device memory. With savePlans, every
+//!          plan is also written to <savePlans>/<network>_<precision>.plan.
+//!
+bool buildPrecisions(std::vector<PrecisionBuild>& builds, int buildJobs, CalibrationAlgoType calibrationAlgo, bool search, const std::string& savePlans)
+{
+    // The legacy search builds and scores engines itself, so it runs before the concurrent builds.
+    std::pair<double, double> legacyParameters;
+    if (calibrationAlgo == CalibrationAlgoType::kLEGACY_CALIBRATION)
+    {
+        legacyParameters = getQuantileAndCutoff(gNetworkName, search);
+    }
+
+    std::vector<samplesCommon::BuildJob> jobs;
+    for (auto& build : builds)
+    {
+        samplesCommon::BuildJob job;
+        job.name = build.name;
+        job.memoryBytes = kBUILD_WORKSPACE;
+        job.build = [&build, calibrationAlgo, legacyParameters, &savePlans](samplesCommon::BuildRecord& record) {
+            std::unique_ptr<BatchStream> calibrationStream;
+            std::unique_ptr<IInt8Calibrator> calibrator;
+            if (build.type == DataType::kINT8)
+            {
+                calibrationStream.reset(new BatchStream(CAL_BATCH_SIZE, NB_CAL_BATCHES));
+                calibrator = createCalibrator(*calibrationStream, calibrationAlgo, legacyParameters);
+            }
+            try
+            {
+                if (!buildModel(build.batchSize, build.type, calibrator.get(), build.dlaCore, build.plan))
+                {
+                    return samplesCommon::BuildStatus::kFAILED;
+                }
+            }
+            catch (const SkipThePrecision& e)
+            {
+                build.skipped = true;
+                record.message = e.what();
+                return samplesCommon::BuildStatus::kSKIPPED;
+            }
+            record.planBytes = build.plan->size();
+
+            if (!savePlans.empty())
+            {
+                std::string fileName = savePlans + "/" + gNetworkName + "_" + build.name + ".plan";
+                std::ofstream p(fileName, std::ios::binary);
+                p.write(static_cast<const char*>(build.plan->data()), build.plan->size());
+                if (!p)
+                {
+                    record.message = "could not write " + fileName;
+                    return samplesCommon::BuildStatus::kFAILED;
+                }
+                record.message = "saved to " + fileName;
+            }
+            return samplesCommon::BuildStatus::kSUCCESS;
+        };
+        jobs.push_back(job);
+    }
+
+    size_t freeMemory{0}, totalMemory{0};
+    CHECK(cudaMemGetInfo(&freeMemory, &totalMemory));
+    samplesCommon::BuildOrchestrator orchestrator(buildJobs, freeMemory);
+    bool pass = orchestrator.run(jobs);
+
+    gLogInfo << "Engine builds:" << std::endl;
+    orchestrator.writeTable(gLogInfo);
+    for (const auto& record : orchestrator.getRecords())
+    {
+        gResults.addSample(record.name + ".buildTime", "ms", record.buildMs);
+    }
+    gResults.addSample("buildWalltime", "ms", orchestrator.getWallMs());
+    return pass;
 }
 
 static void printUsage()
@@ -386,6 +533,9 @@ static void printUsage()
     std::cout << "  --legacy             Use legacy calibration algorithm." << std::endl;
     std::cout << "  --useLegacyEntropy   Use legacy Entropy calibration algorithm." << std::endl;
     std::cout << "  --useDLACore=N       Enable execution on DLA for all layers that support dla. Value can range from 0 to n-1, where n is the number of DLA engines on the platform." << std::endl;
+    std::cout << "  --exportTimes=<file> Export per-batch timings and scores as CSV (.csv) or JSON Lines." << std::endl;
+    std::cout << "  --buildJobs=N        Build up to N of the FP32, FP16 and INT8 engines concurrently (default = 3)." << std::endl;
+    std::cout << "  --savePlans=<dir>    Save the engine of each precision to <dir>/<network>_<precision>.plan." << std::endl;
     std::cout << "  -h --help            Print this help menu." << std::endl;
 }
 
@@ -407,6 +557,8 @@ int main(int argc, char** argv)
     // by default we score over 40000 images starting at 10000, so we don't score those used to search calibration
     int batchSize = 100, firstScoreBatch = 100, nbScoreBatches = 400;
     bool search = false, batchSizeProvided = false;
+    std::string exportTimes, savePlans;
+    int buildJobs = 3;
     CalibrationAlgoType calibrationAlgo = CalibrationAlgoType::kENTROPY_CALIBRATION_2;
 
     for (int i = 2; i < argc; i++)
@@ -445,6 +597,18 @@ int main(int argc, char** argv)
         {
             gUseDLACore = stoi(argv[i] + 13);
         }
+        else if (!strncmp(argv[i], "--exportTimes=", 14))
+        {
+            exportTimes = argv[i] + 14;
+        }
+        else if (!strncmp(argv[i], "--buildJobs=", 12))
+        {
+            buildJobs = atoi(argv[i] + 12);
+        }
+        else if (!strncmp(argv[i], "--savePlans=", 12))
+        {
+            savePlans = argv[i] + 12;
+        }
         else
         {
             gLogError << "Unrecognized argument " << argv[i] << std::endl;
@@ -452,6 +616,12 @@ int main(int argc, char** argv)
         }
     }
 
+    if (buildJobs < 1)
+    {
+        gLogError << "--buildJobs must be at least 1" << std::endl;
+        pass = false;
+    }
+
     if (batchSize > 128)
     {
         gLogError << "Please provide batch size <= 128" << std::endl;
@@ -474,8 +644,7 @@ int main(int argc, char** argv)
     gLogError.precision(6);
     int dla{gUseDLACore};
 
-    // Set gUseDLACore to -1 here since FP16 mode is not enabled.
-    if (gUseDLACore >= 0)
+    if (dla >= 0)
     {
         if (!batchSizeProvided)
         {
@@ -483,29 +652,16 @@ int main(int argc, char** argv)
             batchSize = 16;
         }
         gLogInfo << "DLA requested. Disabling for FP32 run since its not supported." << std::endl;
-        gUseDLACore = -1;
     }
 
-    std::pair<float, float> fp32Score, fp16Score, int8Score;
-    gLogInfo << "FP32 run:" << nbScoreBatches << " batches of size " << batchSize << " starting at " << firstScoreBatch << std::endl;
-    fp32Score = scoreModel(batchSize, firstScoreBatch, nbScoreBatches, DataType::kFLOAT, nullptr);
+    gResults.setParameter("network", gNetworkName);
+    gResults.setParameter("batch", batchSize);
+    gResults.setParameter("firstScoreBatch", firstScoreBatch);
+    gResults.setParameter("scoreBatches", nbScoreBatches);
+    gResults.setParameter("useDLACore", dla);
 
-    // Set gUseDLACore correctly to enable DLA if requested.
-    gUseDLACore = dla;
-    bool fp16Skipped = false;
-    gLogInfo << "FP16 run:" << nbScoreBatches << " batches of size " << batchSize << " starting at " << firstScoreBatch << std::endl;
-    try
-    {
-        fp16Score = scoreModel(batchSize, firstScoreBatch, nbScoreBatches, DataType::kHALF, nullptr);
-    }
-    catch (SkipThePrecision e)
-    {
-        gLogInfo << e.what() << std::endl;
-        fp16Skipped = true;
-    }
-
-    // Use gUseDLACore correctly with INT8 mode if DLA is requested.
-    if (gUseDLACore >= 0)
+    // Only kENTROPY_CALIBRATION_2 is supported on DLA.
+    if (dla >= 0)
     {
         if (calibrationAlgo != CalibrationAlgoType::kENTROPY_CALIBRATION_2)
         {
@@ -514,17 +670,38 @@ int main(int argc, char** argv)
         gLogInfo << "\nDLA requested. Setting Calibrator to use kENTROPY_CALIBRATOR_2." << std::endl;
         calibrationAlgo = CalibrationAlgoType::kENTROPY_CALIBRATION_2;
     }
-    gLogInfo << "\nINT8 run:" << nbScoreBatches << " batches of size " << batchSize << " starting at " << firstScoreBatch << std::endl;
-    bool int8Skipped = false;
-    try
+
+    // FP32 never runs on DLA; FP16 and INT8 do if requested.
+    std::vector<PrecisionBuild> builds{{DataType::kFLOAT, "fp32", -1, batchSize},
+                                       {DataType::kHALF, "fp16", dla, batchSize},
+                                       {DataType::kINT8, "int8", dla, batchSize}};
+    if (!buildPrecisions(builds, buildJobs, calibrationAlgo, search, savePlans))
     {
-        int8Score = scoreModel(batchSize, firstScoreBatch, nbScoreBatches, calibrationAlgo, search);
+        pass = false;
     }
-    catch (SkipThePrecision e)
+
+    // The engines are scored one after another so that their inference times do not disturb each other.
+    std::pair<float, float> scores[3];
+    for (size_t i = 0; i < builds.size(); i++)
     {
-        gLogInfo << e.what() << std::endl;
-        int8Skipped = true;
+        const PrecisionBuild& build = builds[i];
+        if (build.skipped)
+        {
+            continue;
+        }
+        std::string label = build.name;
+        std::transform(label.begin(), label.end(), label.begin(), ::toupper);
+        gLogInfo << "\n" << label << " run:" << nbScoreBatches << " batches of size " << build.batchSize << " starting at " << firstScoreBatch << std::endl;
+        if (build.plan)
+        {
+            scores[i] = scoreEngine(build.plan, build.batchSize, firstScoreBatch, nbScoreBatches, build.type, build.dlaCore);
+        }
     }
+    const std::pair<float, float>& fp32Score = scores[0];
+    const std::pair<float, float>& fp16Score = scores[1];
+    const std::pair<float, float>& int8Score = scores[2];
+    const bool fp16Skipped = builds[1].skipped;
+    const bool int8Skipped = builds[2].skipped;
 
     auto isApproximatelyEqual = [](float a, float b, double tolerance)
     {
@@ -560,5 +737,11 @@ int main(int argc, char** argv)
 
     shutdownProtobufLibrary();
 
+    if (!exportTimes.empty() && !gResults.write(exportTimes))
+    {
+        gLogError << "Could not write timings to " << exportTimes << std::endl;
+        pass = false;
+    }
+
     return gLogger.reportTest(sampleTest, pass);
 }
@@ -244,6 +244,7 @@ void transposeWeights(nvinfer1::Weights& wts, int hiddenSize)
     {
         *((uint32_t*) wts.values + k) = trans_wts[k];
     }
+    delete[] trans_wts;
 }
 
 // Create the Engine using only the API and not any parser.
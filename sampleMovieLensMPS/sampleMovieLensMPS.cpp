@@ -82,6 +82,7 @@
 #include "NvUffParser.h"
 #include "logger.h"
 #include "common.h"
+#include "multiProcess.h"
 
 using namespace nvinfer1;
 using namespace nvuffparser;
@@ -109,76 +110,6 @@ static const std::vector<std::string> directories{"data/samples/movielens/", "da
 template <typename T>
 using SampleUniquePtr = std::unique_ptr<T, samplesCommon::InferDeleter>;
 
-class Semaphore
-{
-public:
-    Semaphore(const char* semName) : mSemName(semName)
-    {
-    }
-
-    ~Semaphore()
-    {
-        sem_unlink(mSemName);
-        sem_close(mSemEngine);
-    }
-
-    void wait()
-    {
-        sem_wait(mSemEngine);
-    }
-
-    void post()
-    {
-        sem_post(mSemEngine);
-    }
-
-    void open()
-    {
-        mSemEngine = sem_open(mSemName, O_CREAT | O_EXCL, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP, 0);
-        if (mSemEngine == SEM_FAILED)
-        {
-            throw std::runtime_error("Could not create semaphore");
-        }
-    }
-private:
-    const char* mSemName;
-    sem_t* mSemEngine;
-};
-
-class SharedMemory
-{
-public:
-    SharedMemory(const char* modelStreamFd) : mModelStreamFd(modelStreamFd)
-    {
-    }
-
-    ~SharedMemory()
-    {
-        shm_unlink(mModelStreamFd);
-    }
-
-    int open_ro()
-    {
-        return open(O_RDONLY, 0666);
-    }
-
-    int open_rw()
-    {
-        return open(O_RDWR | O_CREAT, 0666);
-    }
-private:
-    int open(int flag, mode_t mode)
-    {
-        int fd = shm_open(mModelStreamFd, flag, mode);
-        if (fd <= 0)
-        {
-            throw std::runtime_error("Could not create file descriptor: /dev/shm" + std::string(mModelStreamFd));
-        }
-        return fd;
-    }
-    const char* mModelStreamFd;
-};
-
 // The OutptutArgs struct holds intermediate/final outputs generated by the MovieLens structure per user.
 struct OutputArgs
 {
@@ -617,7 +548,7 @@ int mainMovieLensMPS(Args& args, OutputArgs& pargs)
     auto parser = SampleUniquePtr<nvuffparser::IUffParser>(nvuffparser::createUffParser());
 
     // All nbProcesses should wait until the parent is done building the engine.
-    Semaphore sem("/engine_built");
+    samplesCommon::Semaphore sem("/engine_built");
     sem.open();
 
     pid_t pid{};
@@ -638,7 +569,7 @@ int mainMovieLensMPS(Args& args, OutputArgs& pargs)
     // Every process needs to know if it's a child or not.
     bool isParentProcess = (pid != 0);
 
-    SharedMemory shm("/sampleMovieLens.modelStream");
+    samplesCommon::SharedMemory shm("/sampleMovieLens.modelStream");
 
     if (isParentProcess)
     {
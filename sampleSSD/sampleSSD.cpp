@@ -59,6 +59,7 @@
 #include "logger.h"
 #include "common.h"
 #include "argsParser.h"
+#include "tensorView.h"
 
 using namespace nvinfer1;
 using namespace nvcaffeparser1;
@@ -402,7 +403,8 @@ void printHelp(const char* name)
         << "  -h, --help        Display help information.\n"
         << "  --useDLACore=N    Specify the DLA engine to run on.\n"
         << "  --fp16            Specify to run in fp16 mode.\n"
-        << "  --int8            Specify to run in int8 mode." << std::endl;
+        << "  --int8            Specify to run in int8 mode.\n"
+        << "  --engineCache=<dir> Reuse the engine built by an earlier run with the same model and settings." << std::endl;
 }
 
 int main(int argc, char** argv)
@@ -431,15 +433,31 @@ int main(int argc, char** argv)
 
     initLibNvInferPlugins(&gLogger.getTRTLogger(), "");
 
-    IHostMemory* trtModelStream{nullptr};
-    // Create a TensorRT model from the caffe model and serialize it to a stream
+    // Create a TensorRT model from the caffe model and serialize it to a stream, unless it is already cached
 
     const int N = 1; // Batch size
 
-    caffeToTRTModel("ssd.prototxt",
-                    "VGG_VOC0712_SSD_300x300_iter_120000.caffemodel",
-                    std::vector<std::string>{kOUTPUT_BLOB_NAME0, kOUTPUT_BLOB_NAME1},
-                    N, params.modelType, &trtModelStream);
+    samplesCommon::EngineCache engineCache(gArgs.engineCache);
+    samplesCommon::EngineCacheKey cacheKey = samplesCommon::createEngineCacheKey();
+    if (engineCache.isEnabled())
+    {
+        cacheKey.addFile(locateFile("ssd.prototxt"))
+            .addFile(locateFile("VGG_VOC0712_SSD_300x300_iter_120000.caffemodel"))
+            .addSetting("batch", N)
+            .addSetting("mode", params.modelType)
+            .addSetting("useDLACore", gArgs.useDLACore);
+        if (params.modelType == kINT8)
+            cacheKey.addFile(std::string("CalibrationTable") + gNetworkName);
+    }
+
+    IHostMemory* trtModelStream = samplesCommon::loadOrBuildPlan(engineCache, cacheKey, [&]() {
+        IHostMemory* stream{nullptr};
+        caffeToTRTModel("ssd.prototxt",
+                        "VGG_VOC0712_SSD_300x300_iter_120000.caffemodel",
+                        std::vector<std::string>{kOUTPUT_BLOB_NAME0, kOUTPUT_BLOB_NAME1},
+                        N, params.modelType, &stream);
+        return stream;
+    });
 
     std::vector<std::string> imageList = {"bus.ppm"}; // Input image list
     std::vector<samplesCommon::PPM<kINPUT_C, kINPUT_H, kINPUT_W>> ppms(N);
@@ -452,15 +470,14 @@ int main(int argc, char** argv)
     // Host memory for input buffer
     float* data = new float[N * kINPUT_C * kINPUT_H * kINPUT_W];
 
-    for (int i = 0, volImg = kINPUT_C * kINPUT_H * kINPUT_W; i < N; ++i)
+    samplesCommon::TensorView<float> input(data, {N, kINPUT_C, kINPUT_H, kINPUT_W});
+    for (int i = 0; i < N; ++i)
     {
+        // The PPM is HWC in RGB order, and the color image to input should be CHW in BGR order
+        auto image = samplesCommon::TensorView<const uint8_t>(ppms[i].buffer, {kINPUT_H, kINPUT_W, kINPUT_C}).permute({2, 0, 1}).flip(0);
         for (int c = 0; c < kINPUT_C; ++c)
         {
-            // The color image to input should be in BGR order
-            for (unsigned j = 0, volChl = kINPUT_H * kINPUT_W; j < volChl; ++j)
-            {
-                data[i * volImg + c * volChl + j] = float(ppms[i].buffer[j * kINPUT_C + 2 - c]) - pixelMean[c];
-            }
+            samplesCommon::convertTensor(image[c], input[i][c], 1.0f, -pixelMean[c]);
         }
     }
 
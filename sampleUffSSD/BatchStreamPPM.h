@@ -57,6 +57,7 @@
 #include "NvInfer.h"
 #include "logger.h"
 #include "common.h"
+#include "tensorView.h"
 
 std::string locateFile(const std::string& input);
 
@@ -161,17 +162,12 @@ private:
         }
         std::vector<float> data(samplesCommon::volume(mDims));
 
-        long int volChl = mDims.h() * mDims.w();
-
-        for (int i = 0, volImg = mDims.c() * mDims.h() * mDims.w(); i < mBatchSize; ++i)
+        samplesCommon::TensorView<float> batch(data.data(), {mDims.n(), mDims.c(), mDims.h(), mDims.w()});
+        for (int i = 0; i < mBatchSize; ++i)
         {
-            for (int c = 0; c < mDims.c(); ++c)
-            {
-                for (int j = 0; j < volChl; ++j)
-                {
-                    data[i * volImg + c * volChl + j] = (2.0 / 255.0) * float(ppms[i].buffer[j * mDims.c() + c]) - 1.0;
-                }
-            }
+            // The PPM is HWC, the input CHW, and both in RGB order
+            samplesCommon::TensorView<const uint8_t> image(ppms[i].buffer, {mDims.h(), mDims.w(), mDims.c()});
+            samplesCommon::convertTensor(image.permute({2, 0, 1}), batch[i], 2.0f / 255.0f, -1.0f);
         }
 
         std::copy_n(data.data(), mDims.n() * mImageSize, getFileBatch());
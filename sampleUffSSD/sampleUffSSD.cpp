@@ -63,6 +63,8 @@
 #include "logger.h"
 #include "common.h"
 #include "argsParser.h"
+#include "benchmarkResults.h"
+#include "hashUtils.h"
 #include "NvInferPlugin.h"
 #include "EntropyCalibrator.h"
 
@@ -73,6 +75,8 @@ const std::string gSampleName = "TensorRT.sample_uff_ssd";
 
 static samplesCommon::Args gArgs;
 
+static samplesCommon::BenchmarkResults gResults{gSampleName};
+
 static constexpr int OUTPUT_CLS_SIZE = 91;
 
 const char* OUTPUT_BLOB_NAME0 = "NMS";
@@ -259,6 +263,7 @@ void doInference(IExecutionContext& context, float* inputData, float* detectionO
     float total = std::chrono::duration<float, std::milli>(t_end - t_start).count();
 
     gLogInfo << "Time taken for inference is " << total << " ms." << std::endl;
+    gResults.addSample("inferenceTime", "ms", total);
 
     for (int bindingIdx = 0; bindingIdx < nbBindings; ++bindingIdx)
     {
@@ -562,7 +567,9 @@ void printHelp(const char* name)
         << "  -h, --help Display help information.\n"
         << "  --useDLACore=N    Specify the DLA engine to run on.\n"
         << "  --fp16            Specify to run in fp16 mode.\n"
-        << "  --int8            Specify to run in int8 mode." << std::endl;
+        << "  --int8            Specify to run in int8 mode.\n"
+        << "  --exportTimes=<file> Export timings as CSV (.csv) or JSON Lines.\n"
+        << "  --engineCache=<dir> Reuse the engine built by an earlier run with the same model and settings." << std::endl;
 }
 
 int main(int argc, char* argv[])
@@ -592,23 +599,46 @@ int main(int argc, char* argv[])
     gLogInfo << fileName << std::endl;
 
     const int N = 1;
-    auto parser = createUffParser();
 
-    BatchStream calibrationStream(CAL_BATCH_SIZE, NB_CAL_BATCHES);
+    samplesCommon::EngineCache engineCache(gArgs.engineCache);
+    samplesCommon::EngineCacheKey cacheKey = samplesCommon::createEngineCacheKey();
+    if (engineCache.isEnabled())
+    {
+        cacheKey.addFile(fileName)
+            .addSetting("batch", N)
+            .addSetting("fp16", gArgs.runInFp16)
+            .addSetting("int8", gArgs.runInInt8)
+            .addSetting("useDLACore", gArgs.useDLACore);
+        if (gArgs.runInInt8)
+            cacheKey.addFile("CalibrationTableUffSSD");
+    }
+
+    IHostMemory* trtModelStream = samplesCommon::loadOrBuildPlan(engineCache, cacheKey, [&]() {
+        auto parser = createUffParser();
 
-    parser->registerInput("Input", DimsCHW(3, 300, 300), UffInputOrder::kNCHW);
-    // MarkOutput_0 is a node created by the UFF converter when we specify an ouput with -O.
-    parser->registerOutput("MarkOutput_0");
+        BatchStream calibrationStream(CAL_BATCH_SIZE, NB_CAL_BATCHES);
 
-    IHostMemory* trtModelStream{nullptr};
+        parser->registerInput("Input", DimsCHW(3, 300, 300), UffInputOrder::kNCHW);
+        // MarkOutput_0 is a node created by the UFF converter when we specify an ouput with -O.
+        parser->registerOutput("MarkOutput_0");
 
-    std::unique_ptr<IInt8Calibrator> calibrator;
-    calibrator.reset(new Int8EntropyCalibrator2(calibrationStream, FIRST_CAL_BATCH, "UffSSD", INPUT_BLOB_NAME));
+        IHostMemory* stream{nullptr};
 
-    ICudaEngine* tmpEngine = loadModelAndCreateEngine(fileName.c_str(), N, parser, calibrator.get(), trtModelStream);
-    assert(tmpEngine != nullptr);
+        std::unique_ptr<IInt8Calibrator> calibrator;
+        calibrator.reset(new Int8EntropyCalibrator2(calibrationStream, FIRST_CAL_BATCH, "UffSSD", INPUT_BLOB_NAME));
+
+        ICudaEngine* tmpEngine = loadModelAndCreateEngine(fileName.c_str(), N, parser, calibrator.get(), stream);
+        assert(tmpEngine != nullptr);
+        tmpEngine->destroy();
+        return stream;
+    });
     assert(trtModelStream != nullptr);
-    tmpEngine->destroy();
+
+    gResults.setParameter("batch", N);
+    gResults.setParameter("fp16", gArgs.runInFp16);
+    gResults.setParameter("int8", gArgs.runInInt8);
+    gResults.setParameter("useDLACore", gArgs.useDLACore);
+    gResults.setEngineHash(samplesCommon::hashBytes(trtModelStream->data(), trtModelStream->size()));
 
     // Available images.
     std::vector<std::string> imageList = {"dog.ppm", "bus.ppm"};
@@ -623,15 +653,12 @@ int main(int argc, char* argv[])
 
     vector<float> data(N * INPUT_C * INPUT_H * INPUT_W);
 
-    for (int i = 0, volImg = INPUT_C * INPUT_H * INPUT_W; i < N; ++i)
+    samplesCommon::TensorView<float> input(data.data(), {N, INPUT_C, INPUT_H, INPUT_W});
+    for (int i = 0; i < N; ++i)
     {
-        for (int c = 0; c < INPUT_C; ++c)
-        {
-            for (unsigned j = 0, volChl = INPUT_H * INPUT_W; j < volChl; ++j)
-            {
-                data[i * volImg + c * volChl + j] = (2.0 / 255.0) * float(ppms[i].buffer[j * INPUT_C + c]) - 1.0;
-            }
-        }
+        // The PPM is HWC, the input CHW, and both in RGB order
+        samplesCommon::TensorView<const uint8_t> image(ppms[i].buffer, {INPUT_H, INPUT_W, INPUT_C});
+        samplesCommon::convertTensor(image.permute({2, 0, 1}), input[i], 2.0f / 255.0f, -1.0f);
     }
     gLogInfo << " Data Size  " << data.size() << std::endl;
 
@@ -701,5 +728,11 @@ int main(int argc, char* argv[])
     engine->destroy();
     runtime->destroy();
 
+    if (!gArgs.exportTimes.empty() && !gResults.write(gArgs.exportTimes))
+    {
+        gLogError << "Could not write timings to " << gArgs.exportTimes << std::endl;
+        pass = false;
+    }
+
     return gLogger.reportTest(sampleTest, pass);
 }
@@ -0,0 +1,207 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "batchSweep.h"
+#include "testing.h"
+#include <limits>
+#include <sstream>
+
+using namespace samplesCommon;
+
+namespace
+{
+
+BatchSweepPoint point(double imagesPerSecond, double p99Ms)
+{
+    BatchSweepPoint p;
+    p.imagesPerSecond = imagesPerSecond;
+    p.p50Ms = p99Ms / 2;
+    p.p99Ms = p99Ms;
+    return p;
+}
+
+//! A benchmark whose throughput and p99 grow with the batch size and that fails at failBatch.
+BatchSweep::Benchmark fakeBenchmark(int failBatch = -1)
+{
+    return [failBatch](int batchSize, BatchSweepPoint& p) {
+        if (batchSize == failBatch)
+        {
+            return false;
+        }
+        p.imagesPerSecond = 100.0 * batchSize;
+        p.p50Ms = 0.5 * batchSize;
+        p.p99Ms = 1.0 * batchSize;
+        return true;
+    };
+}
+
+} // namespace
+
+TEST(ParetoFrontier, dropsDominatedPoints)
+{
+    // The second point is slower and has a higher p99 than the first; the third only ties on p99 but is slower.
+    std::vector<BatchSweepPoint> points{point(1000, 5), point(800, 6), point(900, 5)};
+    markParetoFrontier(points);
+    EXPECT_TRUE(points[0].paretoOptimal);
+    EXPECT_FALSE(points[1].paretoOptimal);
+    EXPECT_FALSE(points[2].paretoOptimal);
+}
+
+TEST(ParetoFrontier, keepsThroughputLatencyTradeoffs)
+{
+    // Each point buys throughput with p99 latency, so none dominates another.
+    std::vector<BatchSweepPoint> points{point(100, 1), point(400, 3), point(900, 8), point(1000, 20)};
+    markParetoFrontier(points);
+    for (const auto& p : points)
+    {
+        EXPECT_TRUE(p.paretoOptimal);
+    }
+}
+
+TEST(ParetoFrontier, keepsAllIdenticalPoints)
+{
+    std::vector<BatchSweepPoint> points{point(500, 4), point(500, 4), point(400, 4), point(500, 4)};
+    markParetoFrontier(points);
+    EXPECT_TRUE(points[0].paretoOptimal);
+    EXPECT_TRUE(points[1].paretoOptimal);
+    EXPECT_FALSE(points[2].paretoOptimal);
+    EXPECT_TRUE(points[3].paretoOptimal);
+}
+
+TEST(BatchSweep, measuresEveryBatchSize)
+{
+    BatchSweep sweep({1, 2, 4});
+    EXPECT_TRUE(sweep.run(fakeBenchmark()));
+    const auto& points = sweep.getPoints();
+    ASSERT_EQ(points.size(), 3u);
+    EXPECT_EQ(points[0].batchSize, 1);
+    EXPECT_EQ(points[1].batchSize, 2);
+    EXPECT_EQ(points[2].batchSize, 4);
+    EXPECT_NEAR(points[2].imagesPerSecond, 400.0, 1e-9);
+    for (const auto& p : points)
+    {
+        EXPECT_TRUE(p.paretoOptimal);
+    }
+}
+
+TEST(BatchSweep, abortKeepsMeasuredPointsAndMarksFrontier)
+{
+    int calls{0};
+    BatchSweep sweep({1, 2, 4, 8});
+    auto benchmark = fakeBenchmark(4);
+    EXPECT_FALSE(sweep.run([&](int batchSize, BatchSweepPoint& p) {
+        ++calls;
+        bool ok = benchmark(batchSize, p);
+        if (batchSize == 2)
+        {
+            // Batch 2 is dominated by batch 1 here, which the frontier must reflect despite the abort.
+            p.imagesPerSecond = 50.0;
+        }
+        return ok;
+    }));
+    EXPECT_EQ(calls, 3);
+    const auto& points = sweep.getPoints();
+    ASSERT_EQ(points.size(), 2u);
+    EXPECT_EQ(points[0].batchSize, 1);
+    EXPECT_EQ(points[1].batchSize, 2);
+    EXPECT_TRUE(points[0].paretoOptimal);
+    EXPECT_FALSE(points[1].paretoOptimal);
+}
+
+TEST(BatchSweep, rerunReplacesPoints)
+{
+    BatchSweep sweep({1, 2});
+    EXPECT_TRUE(sweep.run(fakeBenchmark()));
+    EXPECT_FALSE(sweep.run(fakeBenchmark(1)));
+    EXPECT_TRUE(sweep.getPoints().empty());
+}
+
+TEST(BatchSweep, writesTable)
+{
+    BatchSweep sweep({1, 2});
+    sweep.run([](int batchSize, BatchSweepPoint& p) {
+        p.imagesPerSecond = batchSize == 1 ? 100 : 90;
+        p.p50Ms = 1;
+        p.p99Ms = 2;
+        return true;
+    });
+    std::ostringstream out;
+    sweep.writeTable(out);
+    EXPECT_EQ(out.str(),
+        "   batch      images/s      p50 ms      p99 ms  pareto\n"
+        "       1           100           1           2       *\n"
+        "       2            90           1           2        \n");
+}
+
+TEST(BatchSweep, writesJson)
+{
+    BatchSweep sweep({1, 2});
+    sweep.run([](int batchSize, BatchSweepPoint& p) {
+        p.imagesPerSecond = batchSize == 1 ? 100 : 150.5;
+        p.p50Ms = batchSize == 1 ? 0.25 : std::numeric_limits<double>::quiet_NaN();
+        p.p99Ms = batchSize;
+        return true;
+    });
+    std::ostringstream out;
+    sweep.writeJson(out);
+    EXPECT_EQ(out.str(),
+        "[\n"
+        "{\"batch\":1,\"imagesPerSecond\":100,\"p50Ms\":0.25,\"p99Ms\":1,\"paretoOptimal\":true},\n"
+        "{\"batch\":2,\"imagesPerSecond\":150.5,\"p50Ms\":null,\"p99Ms\":2,\"paretoOptimal\":true}\n"
+        "]\n");
+}
+
+TEST(BatchSweep, writesEmptyJson)
+{
+    BatchSweep sweep({});
+    EXPECT_TRUE(sweep.run(fakeBenchmark()));
+    std::ostringstream out;
+    sweep.writeJson(out);
+    EXPECT_EQ(out.str(), "[\n]\n");
+}
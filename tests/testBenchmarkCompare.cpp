@@ -0,0 +1,338 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "benchmarkCompare.h"
+#include "benchmarkResults.h"
+#include "testing.h"
+#include <fstream>
+
+using namespace samplesCommon;
+
+namespace
+{
+
+//! n samples spread evenly over [scale, 1.05 * scale) in a shuffled, reproducible order.
+std::vector<double> latencies(size_t n, double scale)
+{
+    std::vector<double> v(n);
+    std::mt19937 rng(7);
+    for (size_t i = 0; i < n; i++)
+        v[i] = scale * (1 + 0.05 * i / n);
+    std::shuffle(v.begin(), v.end(), rng);
+    return v;
+}
+
+MetricMap metrics(const std::string& name, const std::string& unit, const std::vector<double>& samples)
+{
+    MetricMap m;
+    m[name] = MetricSamples{unit, samples};
+    return m;
+}
+
+const MetricComparison* find(const std::vector<MetricComparison>& comparisons, const std::string& statistic)
+{
+    for (const auto& c : comparisons)
+    {
+        if (c.statistic == statistic)
+            return &c;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST(MannWhitney, SeparatedSamples)
+{
+    const std::vector<double> a{1, 2, 3, 4, 5};
+    const std::vector<double> b{6, 7, 8, 9, 10};
+    // U = 0, sigma = sqrt(25 * 11 / 12), z = 12 / sigma with continuity correction.
+    EXPECT_NEAR(mannWhitneyP(a, b), 0.01219, 1e-4);
+    EXPECT_NEAR(mannWhitneyP(b, a), mannWhitneyP(a, b), 1e-12);
+}
+
+TEST(MannWhitney, Ties)
+{
+    const std::vector<double> a{1, 2, 2, 3, 3, 3};
+    EXPECT_NEAR(mannWhitneyP(a, a), 1.0, 1e-12);
+    // Ties shrink the variance, so the same ranks give a smaller p-value than without the tie correction.
+    const std::vector<double> low{1, 1, 1, 1, 2};
+    const std::vector<double> high{2, 3, 3, 3, 3};
+    const double p = mannWhitneyP(low, high);
+    EXPECT_TRUE(p > 0 && p < 0.05);
+    EXPECT_TRUE(p < mannWhitneyP(std::vector<double>{1, 2, 3, 4, 5}, std::vector<double>{5.5, 7, 8, 9, 10}));
+}
+
+TEST(MannWhitney, AllTiedOrEmpty)
+{
+    EXPECT_EQ(mannWhitneyP({4, 4, 4}, {4, 4}), 1.0);
+    EXPECT_EQ(mannWhitneyP({}, {1, 2, 3}), 1.0);
+    EXPECT_EQ(mannWhitneyP({1, 2, 3}, {}), 1.0);
+    EXPECT_EQ(mannWhitneyP({}, {}), 1.0);
+}
+
+TEST(Quantile, Interpolates)
+{
+    std::vector<double> empty;
+    EXPECT_EQ(quantile(empty, 0.5), 0.0);
+    std::vector<double> one{3};
+    EXPECT_EQ(quantile(one, 0.0), 3.0);
+    EXPECT_EQ(quantile(one, 0.99), 3.0);
+    std::vector<double> v{4, 1, 3, 2};
+    EXPECT_NEAR(quantile(v, 0.5), 2.5, 1e-12);
+    EXPECT_NEAR(quantile(v, 0.0), 1.0, 1e-12);
+    EXPECT_NEAR(quantile(v, 1.0), 4.0, 1e-12);
+    EXPECT_NEAR(quantile(v, 0.25), 1.75, 1e-12);
+}
+
+TEST(Bootstrap, IdenticalInputsContainZero)
+{
+    const std::vector<double> a = latencies(50, 10);
+    for (double stat : {0.5, 0.99, -1.0})
+    {
+        double low{1}, high{-1};
+        bootstrapRelativeChange(a, a, stat, 500, 0.95, low, high);
+        EXPECT_TRUE(low <= 0 && high >= 0);
+        EXPECT_TRUE(low <= high);
+    }
+}
+
+TEST(Bootstrap, ShiftedInputs)
+{
+    const std::vector<double> a = latencies(50, 10);
+    std::vector<double> b = a;
+    for (auto& x : b)
+        x *= 1.1;
+    double low{0}, high{0};
+    bootstrapRelativeChange(a, b, 0.5, 500, 0.95, low, high);
+    EXPECT_TRUE(low > 0.05 && high < 0.15);
+
+    // The seed is fixed, so the interval is reproducible.
+    double low2{0}, high2{0};
+    bootstrapRelativeChange(a, b, 0.5, 500, 0.95, low2, high2);
+    EXPECT_EQ(low, low2);
+    EXPECT_EQ(high, high2);
+}
+
+TEST(LoadBenchmarkResults, JsonLinesAndCsvRoundTrip)
+{
+    samplesTest::TempDir dir;
+    BenchmarkResults results("trtexec");
+    results.setParameter("batch", "4");
+    for (double v : {1.5, 2.25, 3.0})
+        results.addSample("latency", "ms", v);
+    results.addSample("throughput", "qps/s", 1234.5);
+    results.addSample("name, quoted", "ms", 7);
+
+    for (const std::string name : {"results.json", "results.csv"})
+    {
+        ASSERT_TRUE(results.write(dir.path(name)));
+        MetricMap m;
+        std::string error;
+        ASSERT_TRUE(loadBenchmarkResults(dir.path(name), m, error));
+        EXPECT_EQ(m.size(), 3u);
+        EXPECT_EQ(m["latency"].unit, std::string("ms"));
+        EXPECT_TRUE((m["latency"].samples == std::vector<double>{1.5, 2.25, 3.0}));
+        EXPECT_EQ(m["throughput"].unit, std::string("qps/s"));
+        EXPECT_TRUE((m["throughput"].samples == std::vector<double>{1234.5}));
+        EXPECT_TRUE((m["name, quoted"].samples == std::vector<double>{7}));
+    }
+}
+
+TEST(LoadBenchmarkResults, SkipsNullSamples)
+{
+    samplesTest::TempDir dir;
+    dir.write("nulls.json",
+        "{\"benchmark\":\"b\",\"metric\":\"latency\",\"unit\":\"ms\",\"samples\":[1,null,2.5, null ,3e0]}\n"
+        "\n"
+        "{\"benchmark\":\"b\",\"metric\":\"empty\",\"unit\":\"ms\",\"samples\":[]}\n");
+    MetricMap m;
+    std::string error;
+    ASSERT_TRUE(loadBenchmarkResults(dir.path("nulls.json"), m, error));
+    EXPECT_TRUE((m["latency"].samples == std::vector<double>{1, 2.5, 3}));
+    EXPECT_TRUE(m["empty"].samples.empty());
+}
+
+TEST(LoadBenchmarkResults, Errors)
+{
+    samplesTest::TempDir dir;
+    MetricMap m;
+    std::string error;
+    EXPECT_FALSE(loadBenchmarkResults(dir.path("missing.json"), m, error));
+    EXPECT_TRUE(error.find("cannot open") != std::string::npos);
+
+    dir.write("empty.json", "");
+    EXPECT_FALSE(loadBenchmarkResults(dir.path("empty.json"), m, error));
+    EXPECT_TRUE(error.find("is empty") != std::string::npos);
+
+    dir.write("header.csv", "benchmark,metric,unit,engineHash,index,value\n");
+    EXPECT_FALSE(loadBenchmarkResults(dir.path("header.csv"), m, error));
+    EXPECT_TRUE(error.find("holds no metrics") != std::string::npos);
+
+    dir.write("short.csv", "benchmark,metric,unit,engineHash,index,value\nb,latency,ms\n");
+    EXPECT_FALSE(loadBenchmarkResults(dir.path("short.csv"), m, error));
+    EXPECT_TRUE(error.find(":2:") != std::string::npos);
+
+    dir.write("other.json", "{\"hello\":\"world\"}\n");
+    EXPECT_FALSE(loadBenchmarkResults(dir.path("other.json"), m, error));
+    EXPECT_TRUE(error.find(":1: not a benchmark result") != std::string::npos);
+}
+
+TEST(CompareBenchmarkResults, LatencyVerdicts)
+{
+    using Verdict = MetricComparison::Verdict;
+    const std::vector<double> base = latencies(100, 10);
+    std::vector<double> slower = base, faster = base, slightly = base;
+    for (size_t i = 0; i < base.size(); i++)
+    {
+        slower[i] *= 1.1;
+        faster[i] *= 0.9;
+        slightly[i] *= 1.02;
+    }
+    CompareOptions options;
+    options.resamples = 500;
+
+    auto same = compareBenchmarkResults(metrics("latency", "ms", base), metrics("latency", "ms", base), options);
+    ASSERT_EQ(same.size(), 2u);
+    EXPECT_TRUE(find(same, "p50") && find(same, "p99"));
+    EXPECT_EQ(countVerdicts(same, Verdict::kUNCHANGED), 2);
+    EXPECT_NEAR(same[0].pValue, 1.0, 1e-12);
+
+    auto regressed = compareBenchmarkResults(metrics("latency", "ms", base), metrics("latency", "ms", slower), options);
+    ASSERT_TRUE(find(regressed, "p50") != nullptr);
+    EXPECT_NEAR(find(regressed, "p50")->change, 0.1, 1e-9);
+    EXPECT_TRUE(find(regressed, "p50")->hasInterval);
+    EXPECT_TRUE(find(regressed, "p50")->verdict == Verdict::kREGRESSED);
+    EXPECT_EQ(countVerdicts(regressed, Verdict::kREGRESSED), 2);
+
+    auto improved = compareBenchmarkResults(metrics("latency", "ms", base), metrics("latency", "ms", faster), options);
+    EXPECT_EQ(countVerdicts(improved, Verdict::kIMPROVED), 2);
+
+    // Significant but below the 5% threshold.
+    auto small = compareBenchmarkResults(metrics("latency", "ms", base), metrics("latency", "ms", slightly), options);
+    EXPECT_EQ(countVerdicts(small, Verdict::kUNCHANGED), 2);
+    options.threshold = 0.01;
+    small = compareBenchmarkResults(metrics("latency", "ms", base), metrics("latency", "ms", slightly), options);
+    EXPECT_EQ(countVerdicts(small, Verdict::kREGRESSED), 2);
+}
+
+TEST(CompareBenchmarkResults, RatesAreBetterHigher)
+{
+    using Verdict = MetricComparison::Verdict;
+    const std::vector<double> base = latencies(50, 1000);
+    std::vector<double> higher = base;
+    for (auto& x : higher)
+        x *= 1.2;
+    CompareOptions options;
+    options.resamples = 500;
+
+    auto c = compareBenchmarkResults(metrics("throughput", "qps/s", base), metrics("throughput", "qps/s", higher), options);
+    ASSERT_EQ(c.size(), 1u);
+    EXPECT_EQ(c[0].statistic, std::string("mean"));
+    EXPECT_TRUE(c[0].higherIsBetter);
+    EXPECT_TRUE(c[0].verdict == Verdict::kIMPROVED);
+
+    c = compareBenchmarkResults(metrics("throughput", "qps/s", higher), metrics("throughput", "qps/s", base), options);
+    EXPECT_TRUE(c[0].verdict == Verdict::kREGRESSED);
+}
+
+TEST(CompareBenchmarkResults, SingleValuesUseTheThresholdAlone)
+{
+    using Verdict = MetricComparison::Verdict;
+    CompareOptions options;
+
+    auto c = compareBenchmarkResults(metrics("stream0.p99", "ms", {10}), metrics("stream0.p99", "ms", {10.6}), options);
+    ASSERT_EQ(c.size(), 1u);
+    EXPECT_EQ(c[0].statistic, std::string("value"));
+    EXPECT_FALSE(c[0].hasInterval);
+    EXPECT_TRUE(c[0].verdict == Verdict::kREGRESSED);
+
+    c = compareBenchmarkResults(metrics("stream0.p50", "ms", {10}), metrics("stream0.p50", "ms", {10.4}), options);
+    ASSERT_EQ(c.size(), 1u);
+    EXPECT_TRUE(c[0].verdict == Verdict::kUNCHANGED);
+
+    c = compareBenchmarkResults(metrics("qps", "queries/s", {100}), metrics("qps", "queries/s", {90}), options);
+    ASSERT_EQ(c.size(), 1u);
+    EXPECT_TRUE(c[0].verdict == Verdict::kREGRESSED);
+
+    // Other single-valued statistics such as the mean or max of a summary are not compared.
+    EXPECT_TRUE(compareBenchmarkResults(metrics("stream0.max", "ms", {10}), metrics("stream0.max", "ms", {20}), options)
+                    .empty());
+}
+
+TEST(CompareBenchmarkResults, SkipsOtherUnitsAndUnmatchedMetrics)
+{
+    CompareOptions options;
+    options.resamples = 100;
+    MetricMap baseline = metrics("latency", "ms", latencies(20, 10));
+    baseline["memory"] = MetricSamples{"MiB", {100, 200}};
+    baseline["onlyInBaseline"] = MetricSamples{"ms", {1, 2}};
+    MetricMap candidate = metrics("latency", "ms", latencies(20, 10));
+    candidate["memory"] = MetricSamples{"MiB", {300, 400}};
+    candidate["onlyInCandidate"] = MetricSamples{"ms", {1, 2}};
+    candidate["emptyLatency"] = MetricSamples{"ms", {}};
+    baseline["emptyLatency"] = MetricSamples{"ms", {1, 2}};
+
+    auto c = compareBenchmarkResults(baseline, candidate, options);
+    ASSERT_EQ(c.size(), 2u);
+    EXPECT_EQ(c[0].metric, std::string("latency"));
+    EXPECT_EQ(c[1].metric, std::string("latency"));
+}
+
+TEST(CompareBenchmarkResults, ExitDecision)
+{
+    using Verdict = MetricComparison::Verdict;
+    std::vector<MetricComparison> comparisons(4);
+    EXPECT_EQ(countVerdicts(comparisons, Verdict::kREGRESSED), 0);
+    comparisons[1].verdict = Verdict::kIMPROVED;
+    comparisons[3].verdict = Verdict::kREGRESSED;
+    EXPECT_EQ(countVerdicts(comparisons, Verdict::kREGRESSED), 1);
+    EXPECT_EQ(countVerdicts(comparisons, Verdict::kIMPROVED), 1);
+    EXPECT_EQ(countVerdicts(comparisons, Verdict::kUNCHANGED), 2);
+    EXPECT_EQ(countVerdicts({}, Verdict::kREGRESSED), 0);
+}
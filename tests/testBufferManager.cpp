@@ -0,0 +1,307 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "buffers.h"
+#include "testing.h"
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+using namespace samplesCommon;
+
+namespace
+{
+
+//! Blocks handed out by the fake CUDA runtime below, by pointer, with their size.
+std::map<void*, size_t> gDeviceBlocks;
+std::map<void*, size_t> gPinnedBlocks;
+
+void* fakeAlloc(std::map<void*, size_t>& blocks, size_t size)
+{
+    void* ptr = std::malloc(size);
+    blocks[ptr] = size;
+    return ptr;
+}
+
+void fakeFree(std::map<void*, size_t>& blocks, void* ptr)
+{
+    if (ptr)
+    {
+        blocks.erase(ptr);
+        std::free(ptr);
+    }
+}
+
+//! A network with an input of [3, 4] floats and an output of [10] int32s, for batches of up to 8.
+class FakeEngine : public nvinfer1::ICudaEngine
+{
+public:
+    int getNbBindings() const override { return 2; }
+    int getBindingIndex(const char* name) const override
+    {
+        return !std::strcmp(name, "input") ? 0 : !std::strcmp(name, "output") ? 1 : -1;
+    }
+    const char* getBindingName(int bindingIndex) const override { return bindingIndex ? "output" : "input"; }
+    bool bindingIsInput(int bindingIndex) const override { return bindingIndex == 0; }
+    nvinfer1::Dims getBindingDimensions(int bindingIndex) const override
+    {
+        nvinfer1::Dims dims{};
+        if (bindingIndex == 0)
+        {
+            dims.nbDims = 2;
+            dims.d[0] = 3;
+            dims.d[1] = 4;
+        }
+        else
+        {
+            dims.nbDims = 1;
+            dims.d[0] = 10;
+        }
+        return dims;
+    }
+    nvinfer1::DataType getBindingDataType(int bindingIndex) const override
+    {
+        return bindingIndex ? nvinfer1::DataType::kINT32 : nvinfer1::DataType::kFLOAT;
+    }
+    int getMaxBatchSize() const override { return 8; }
+    int getNbLayers() const override { return 1; }
+    std::size_t getWorkspaceSize() const override { return 0; }
+    nvinfer1::IHostMemory* serialize() const override { return nullptr; }
+    nvinfer1::IExecutionContext* createExecutionContext() override { return nullptr; }
+    void destroy() override {}
+    nvinfer1::TensorLocation getLocation(int) const override { return nvinfer1::TensorLocation::kDEVICE; }
+    nvinfer1::IExecutionContext* createExecutionContextWithoutDeviceMemory() override { return nullptr; }
+    size_t getDeviceMemorySize() const override { return 0; }
+    bool isRefittable() const override { return false; }
+};
+
+//! A shared_ptr to engine that does not own it, as BufferManager expects.
+std::shared_ptr<nvinfer1::ICudaEngine> share(FakeEngine& engine)
+{
+    return std::shared_ptr<nvinfer1::ICudaEngine>(std::shared_ptr<nvinfer1::ICudaEngine>(), &engine);
+}
+
+const size_t kINPUT_SAMPLE_BYTES = 3 * 4 * sizeof(float);
+const size_t kOUTPUT_SAMPLE_BYTES = 10 * sizeof(int32_t);
+
+} // namespace
+
+// The host tests link no CUDA library: BufferManager allocates and copies through these instead.
+extern "C" {
+
+cudaError_t cudaMalloc(void** ptr, size_t size)
+{
+    *ptr = fakeAlloc(gDeviceBlocks, size);
+    return cudaSuccess;
+}
+
+cudaError_t cudaFree(void* ptr)
+{
+    fakeFree(gDeviceBlocks, ptr);
+    return cudaSuccess;
+}
+
+cudaError_t cudaMallocHost(void** ptr, size_t size)
+{
+    *ptr = fakeAlloc(gPinnedBlocks, size);
+    return cudaSuccess;
+}
+
+cudaError_t cudaFreeHost(void* ptr)
+{
+    fakeFree(gPinnedBlocks, ptr);
+    return cudaSuccess;
+}
+
+cudaError_t cudaMemcpy(void* dst, const void* src, size_t count, cudaMemcpyKind)
+{
+    std::memcpy(dst, src, count);
+    return cudaSuccess;
+}
+
+cudaError_t cudaMemcpyAsync(void* dst, const void* src, size_t count, cudaMemcpyKind, cudaStream_t)
+{
+    std::memcpy(dst, src, count);
+    return cudaSuccess;
+}
+
+} // extern "C"
+
+TEST(BufferManager, EagerAllocation)
+{
+    FakeEngine engine;
+    {
+        BufferManager buffers(share(engine), 4, HostMemoryType::kPINNED);
+        EXPECT_EQ(gDeviceBlocks.size(), 2u);
+        EXPECT_EQ(gPinnedBlocks.size(), 2u);
+        EXPECT_EQ(gDeviceBlocks[buffers.getDeviceBuffer("input")], 4 * kINPUT_SAMPLE_BYTES);
+        EXPECT_EQ(gPinnedBlocks[buffers.getHostBuffer("output")], 4 * kOUTPUT_SAMPLE_BYTES);
+        EXPECT_EQ(buffers.size("input"), 4 * kINPUT_SAMPLE_BYTES);
+        EXPECT_TRUE(buffers.size("missing") == BufferManager::kINVALID_SIZE_VALUE);
+        EXPECT_TRUE(buffers.getHostBuffer("missing") == nullptr);
+        EXPECT_TRUE(buffers.getDeviceBuffer("missing") == nullptr);
+    }
+    EXPECT_TRUE(gDeviceBlocks.empty());
+    EXPECT_TRUE(gPinnedBlocks.empty());
+}
+
+TEST(BufferManager, LazyAllocation)
+{
+    FakeEngine engine;
+    BufferManager buffers(share(engine), 2, HostMemoryType::kPINNED, nullptr, AllocationPolicy::kLAZY);
+    EXPECT_TRUE(gDeviceBlocks.empty());
+    EXPECT_TRUE(gPinnedBlocks.empty());
+
+    // Copying the inputs allocates both buffers of the input, and nothing of the output.
+    buffers.copyInputToDevice();
+    EXPECT_EQ(gDeviceBlocks.size(), 1u);
+    EXPECT_EQ(gPinnedBlocks.size(), 1u);
+    EXPECT_EQ(gPinnedBlocks.count(buffers.getHostBuffer("input")), 1u);
+
+    // The bindings need every device buffer, but no further host buffer.
+    std::vector<void*>& bindings = buffers.getDeviceBindings();
+    EXPECT_EQ(bindings.size(), 2u);
+    EXPECT_EQ(gDeviceBlocks.size(), 2u);
+    EXPECT_EQ(gPinnedBlocks.size(), 1u);
+    EXPECT_TRUE(bindings[1] == buffers.getDeviceBuffer("output"));
+
+    buffers.allocate();
+    EXPECT_EQ(gPinnedBlocks.size(), 2u);
+}
+
+TEST(BufferManager, CopiesAndViews)
+{
+    FakeEngine engine;
+    BufferManager buffers(share(engine), 2);
+    TensorView<float> input = buffers.getHostTensor<float>("input");
+    ASSERT_TRUE(input.valid());
+    EXPECT_EQ(input.getNbDims(), 3);
+    EXPECT_EQ(input.dim(0), 2);
+    EXPECT_EQ(input.dim(2), 4);
+    EXPECT_FALSE(buffers.getHostTensor<int32_t>("input").valid());
+    for (int64_t i = 0; i < input.volume(); i++)
+        input.data()[i] = static_cast<float>(i);
+    buffers.copyInputToDevice();
+    EXPECT_EQ(std::memcmp(buffers.getDeviceBuffer("input"), input.data(), buffers.size("input")), 0);
+
+    int32_t* deviceOutput = static_cast<int32_t*>(buffers.getDeviceBuffer("output"));
+    for (int i = 0; i < 20; i++)
+        deviceOutput[i] = i * i;
+    buffers.copyOutputToHost();
+    EXPECT_EQ(buffers.getHostTensor<int32_t>("output")(1, 9), 19 * 19);
+
+    std::ostringstream dump;
+    ASSERT_TRUE(buffers.dumpBuffer(dump, "input"));
+    EXPECT_EQ(dump.str().substr(0, 23), std::string("[2, 3, 4]\n0 1 2 3\n4 5 6"));
+}
+
+TEST(BufferManager, DeviceOnlyBindings)
+{
+    FakeEngine engine;
+    BufferManager buffers(share(engine), 2, HostMemoryType::kPINNED);
+    EXPECT_FALSE(buffers.setDeviceOnly("missing"));
+    ASSERT_TRUE(buffers.setDeviceOnly("output"));
+    EXPECT_TRUE(buffers.isDeviceOnly("output"));
+    EXPECT_FALSE(buffers.isDeviceOnly("input"));
+    // The host mirror is freed and stays away through copies.
+    EXPECT_EQ(gPinnedBlocks.size(), 1u);
+    EXPECT_TRUE(buffers.getHostBuffer("output") == nullptr);
+    EXPECT_FALSE(buffers.getHostTensor<int32_t>("output").valid());
+    buffers.copyOutputToHost();
+    EXPECT_EQ(gPinnedBlocks.size(), 1u);
+    std::ostringstream dump;
+    EXPECT_FALSE(buffers.dumpBuffer(dump, "output"));
+    EXPECT_TRUE(buffers.getDeviceBuffer("output") != nullptr);
+
+    ASSERT_TRUE(buffers.setDeviceOnly("output", false));
+    EXPECT_TRUE(buffers.getHostBuffer("output") != nullptr);
+    EXPECT_EQ(gPinnedBlocks.size(), 2u);
+}
+
+TEST(BufferManager, ResizeWithinAndBeyondCapacity)
+{
+    FakeEngine engine;
+    BufferManager buffers(share(engine), 4, HostMemoryType::kPINNED, nullptr, AllocationPolicy::kLAZY);
+    void* device = buffers.getDeviceBuffer("input");
+    float* host = static_cast<float*>(buffers.getHostBuffer("input"));
+    host[0] = 42.0f;
+
+    // Shrinking and growing back within the capacity keep the buffers and their contents.
+    ASSERT_TRUE(buffers.resize(2));
+    EXPECT_EQ(buffers.getBatchSize(), 2);
+    EXPECT_EQ(buffers.getCapacity(), 4);
+    EXPECT_EQ(buffers.size("input"), 2 * kINPUT_SAMPLE_BYTES);
+    EXPECT_EQ(buffers.getHostTensor<float>("input").dim(0), 2);
+    ASSERT_TRUE(buffers.resize(4));
+    EXPECT_TRUE(buffers.getDeviceBuffer("input") == device);
+    EXPECT_TRUE(buffers.getHostBuffer("input") == host);
+    EXPECT_EQ(host[0], 42.0f);
+    EXPECT_EQ(gDeviceBlocks[device], 4 * kINPUT_SAMPLE_BYTES);
+
+    // Growing beyond it reallocates the buffers that were allocated, and only those.
+    ASSERT_TRUE(buffers.resize(6));
+    EXPECT_EQ(buffers.getCapacity(), 6);
+    EXPECT_EQ(gDeviceBlocks.size(), 1u);
+    EXPECT_EQ(gPinnedBlocks.size(), 1u);
+    EXPECT_EQ(gDeviceBlocks[buffers.getDeviceBuffer("input")], 6 * kINPUT_SAMPLE_BYTES);
+    EXPECT_EQ(gPinnedBlocks[buffers.getHostBuffer("input")], 6 * kINPUT_SAMPLE_BYTES);
+    EXPECT_EQ(buffers.getDeviceBindings()[0], buffers.getDeviceBuffer("input"));
+    // Buffers allocated later get the new capacity too, while size() follows the batch size.
+    EXPECT_EQ(gDeviceBlocks[buffers.getDeviceBuffer("output")], 6 * kOUTPUT_SAMPLE_BYTES);
+    ASSERT_TRUE(buffers.resize(1));
+    EXPECT_EQ(buffers.size("output"), kOUTPUT_SAMPLE_BYTES);
+    EXPECT_EQ(buffers.getCapacity(), 6);
+
+    // Outside [1, max batch size] nothing changes.
+    EXPECT_FALSE(buffers.resize(0));
+    EXPECT_FALSE(buffers.resize(9));
+    EXPECT_EQ(buffers.getBatchSize(), 1);
+    EXPECT_EQ(buffers.getCapacity(), 6);
+    EXPECT_TRUE(buffers.resize(8));
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "bufferPool.h"
+#include "testing.h"
+#include <cstdlib>
+#include <map>
+#include <set>
+
+using namespace samplesCommon;
+
+namespace
+{
+
+//! Backing allocator shared by the functors of a pool, which copies them.
+struct Backend
+{
+    int allocations{0};
+    int failures{0};  //!< Number of the next allocations to fail
+    std::set<void*> live;
+    std::vector<size_t> freedSizes;
+    std::map<void*, size_t> sizes;
+};
+
+struct FakeAlloc
+{
+    Backend* backend;
+    bool operator()(void** ptr, size_t size) const
+    {
+        if (backend->failures > 0)
+        {
+            --backend->failures;
+            return false;
+        }
+        ++backend->allocations;
+        *ptr = malloc(size);
+        backend->live.insert(*ptr);
+        backend->sizes[*ptr] = size;
+        return true;
+    }
+};
+
+struct FakeFree
+{
+    Backend* backend;
+    void operator()(void* ptr) const
+    {
+        backend->live.erase(ptr);
+        backend->freedSizes.push_back(backend->sizes[ptr]);
+        free(ptr);
+    }
+};
+
+using Pool = BufferPool<FakeAlloc, FakeFree>;
+
+} // namespace
+
+TEST(BufferPool, SizeClasses)
+{
+    EXPECT_EQ(Pool::sizeClass(0), 256u);
+    EXPECT_EQ(Pool::sizeClass(1), 256u);
+    EXPECT_EQ(Pool::sizeClass(256), 256u);
+    EXPECT_EQ(Pool::sizeClass(257), 320u);
+    EXPECT_EQ(Pool::sizeClass(320), 320u);
+    EXPECT_EQ(Pool::sizeClass(321), 384u);
+    EXPECT_EQ(Pool::sizeClass(512), 512u);
+    EXPECT_EQ(Pool::sizeClass(513), 640u);
+    EXPECT_EQ(Pool::sizeClass(1000), 1024u);
+    EXPECT_EQ(Pool::sizeClass(1025), 1280u);
+    // At most a quarter of a block is wasted.
+    for (size_t size = 257; size < 100000; size += 37)
+    {
+        EXPECT_TRUE(Pool::sizeClass(size) >= size && Pool::sizeClass(size) - size < Pool::sizeClass(size) / 4);
+    }
+}
+
+TEST(BufferPool, HitsAndMisses)
+{
+    Backend backend;
+    {
+        Pool pool(Pool::kUNLIMITED, FakeAlloc{&backend}, FakeFree{&backend});
+        void* a = pool.allocate(300);
+        void* b = pool.allocate(300);
+        EXPECT_TRUE(a != b);
+        pool.release(a);
+        // Same size class, so the free block is reused.
+        EXPECT_TRUE(pool.allocate(260) == a);
+        void* c = pool.allocate(600);
+        BufferPoolStats stats = pool.getStats();
+        EXPECT_EQ(stats.allocations, 4u);
+        EXPECT_EQ(stats.hits, 1u);
+        EXPECT_NEAR(stats.hitRate(), 0.25, 1e-12);
+        EXPECT_EQ(stats.bytesInUse, 320u + 320u + 640u);
+        EXPECT_EQ(stats.bytesCached, 0u);
+        EXPECT_EQ(backend.allocations, 3);
+
+        pool.release(a);
+        pool.release(b);
+        pool.release(c);
+        stats = pool.getStats();
+        EXPECT_EQ(stats.bytesInUse, 0u);
+        EXPECT_EQ(stats.bytesCached, 1280u);
+        EXPECT_EQ(stats.peakBytesInUse, 1280u);
+        EXPECT_EQ(stats.peakBytesReserved, 1280u);
+    }
+    // The pool frees its cached blocks when destroyed.
+    EXPECT_TRUE(backend.live.empty());
+}
+
+TEST(BufferPool, CapTrimsLargestFirst)
+{
+    Backend backend;
+    Pool pool(1000, FakeAlloc{&backend}, FakeFree{&backend});
+    void* small = pool.allocate(256);
+    void* medium = pool.allocate(512);
+    void* large = pool.allocate(1024);
+    pool.release(small);
+    pool.release(medium);
+    EXPECT_TRUE(backend.freedSizes.empty());
+    // 256 + 512 + 1024 cached is above the cap: the 1024 byte block goes first and is enough.
+    pool.release(large);
+    EXPECT_TRUE((backend.freedSizes == std::vector<size_t>{1024}));
+    EXPECT_EQ(pool.getStats().bytesCached, 768u);
+    EXPECT_EQ(pool.getStats().blocksFreed, 1u);
+
+    pool.setMaxCachedBytes(300);
+    EXPECT_EQ(pool.getMaxCachedBytes(), 300u);
+    EXPECT_TRUE((backend.freedSizes == std::vector<size_t>{1024, 512}));
+    EXPECT_EQ(pool.getStats().bytesCached, 256u);
+
+    pool.trim();
+    EXPECT_TRUE(backend.live.empty());
+    EXPECT_EQ(pool.getStats().blocksFreed, 3u);
+}
+
+TEST(BufferPool, RetriesAfterTrimming)
+{
+    Backend backend;
+    Pool pool(Pool::kUNLIMITED, FakeAlloc{&backend}, FakeFree{&backend});
+    pool.release(pool.allocate(1024));
+    EXPECT_EQ(pool.getStats().bytesCached, 1024u);
+
+    // The first attempt fails, the free blocks are returned and the second attempt succeeds.
+    backend.failures = 1;
+    void* ptr = pool.allocate(4096);
+    EXPECT_TRUE(ptr != nullptr);
+    EXPECT_EQ(pool.getStats().bytesCached, 0u);
+    EXPECT_TRUE((backend.freedSizes == std::vector<size_t>{1024}));
+
+    // Both attempts fail.
+    backend.failures = 2;
+    EXPECT_TRUE(pool.allocate(8192) == nullptr);
+    EXPECT_EQ(pool.getStats().allocations, 2u);
+    EXPECT_EQ(pool.getStats().bytesInUse, 4096u);
+    pool.release(ptr);
+}
+
+TEST(BufferPool, IgnoresNullAndUnknownPointers)
+{
+    Backend backend;
+    Pool pool(Pool::kUNLIMITED, FakeAlloc{&backend}, FakeFree{&backend});
+    void* ptr = pool.allocate(100);
+    pool.release(nullptr);
+    int unknown{0};
+    pool.release(&unknown);
+    BufferPoolStats stats = pool.getStats();
+    EXPECT_EQ(stats.bytesInUse, 256u);
+    EXPECT_EQ(stats.bytesCached, 0u);
+
+    pool.release(ptr);
+    // A second release of the same block is ignored as well.
+    pool.release(ptr);
+    EXPECT_EQ(pool.getStats().bytesCached, 256u);
+    EXPECT_TRUE(pool.allocate(100) == ptr);
+    void* other = pool.allocate(100);
+    EXPECT_TRUE(other != ptr);
+    pool.release(ptr);
+    pool.release(other);
+}
+
+TEST(BufferPool, ResetStatsKeepsCurrentUsage)
+{
+    Backend backend;
+    Pool pool(Pool::kUNLIMITED, FakeAlloc{&backend}, FakeFree{&backend});
+    void* a = pool.allocate(1024);
+    void* b = pool.allocate(1024);
+    pool.release(b);
+    pool.resetStats();
+    BufferPoolStats stats = pool.getStats();
+    EXPECT_EQ(stats.allocations, 0u);
+    EXPECT_EQ(stats.hits, 0u);
+    EXPECT_EQ(stats.bytesInUse, 1024u);
+    EXPECT_EQ(stats.peakBytesInUse, 1024u);
+    EXPECT_EQ(stats.bytesCached, 1024u);
+    EXPECT_EQ(stats.peakBytesReserved, 2048u);
+    pool.release(a);
+}
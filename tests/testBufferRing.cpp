@@ -0,0 +1,267 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "bufferRing.h"
+#include "testing.h"
+#include <ostream>
+#include <set>
+
+namespace samplesCommon
+{
+
+//! Lets EXPECT_EQ print slot states; found by argument-dependent lookup.
+std::ostream& operator<<(std::ostream& os, SlotState state)
+{
+    const char* names[] = {"kFREE", "kFILLING", "kIN_FLIGHT", "kDRAINING"};
+    return os << names[static_cast<int>(state)];
+}
+
+} // namespace samplesCommon
+
+using namespace samplesCommon;
+
+namespace
+{
+
+//! Backend whose work completes when the test says so, and that fails on demand.
+class FakeBackend : public IRingBackend
+{
+public:
+    bool enqueue(int slot) override
+    {
+        if (failEnqueue)
+            return false;
+        enqueued.push_back(slot);
+        completed.erase(slot);
+        return true;
+    }
+
+    bool query(int slot) override { return completed.count(slot) != 0; }
+
+    bool synchronize(int slot) override
+    {
+        synchronized.push_back(slot);
+        completed.insert(slot);
+        return failing.count(slot) == 0;
+    }
+
+    bool failEnqueue{false};
+    std::set<int> failing;   //!< Slots whose work fails
+    std::set<int> completed; //!< Slots whose last enqueued work has completed
+    std::vector<int> enqueued;
+    std::vector<int> synchronized;
+};
+
+std::vector<SlotState> states(const BufferRing& ring)
+{
+    std::vector<SlotState> result;
+    for (int i = 0; i < ring.getNbSlots(); i++)
+        result.push_back(ring.getState(i));
+    return result;
+}
+
+} // namespace
+
+TEST(BufferRing, AcquireWaitsForRelease)
+{
+    FakeBackend backend;
+    BufferRing ring(2, backend);
+    EXPECT_EQ(ring.getNbSlots(), 2);
+    EXPECT_EQ(ring.acquire(), 0);
+    EXPECT_TRUE(ring.submit(0));
+    EXPECT_EQ(ring.acquire(), 1);
+    EXPECT_TRUE(ring.submit(1));
+    // Slot 0 is in flight and then drained: neither can be handed out again.
+    EXPECT_EQ(ring.acquire(), -1);
+    EXPECT_EQ(ring.drain(), 0);
+    EXPECT_EQ(ring.acquire(), -1);
+    EXPECT_TRUE(ring.release(0));
+    EXPECT_EQ(ring.acquire(), 0);
+    EXPECT_EQ(ring.count(SlotState::kFILLING), 1);
+    EXPECT_EQ(ring.count(SlotState::kIN_FLIGHT), 1);
+}
+
+TEST(BufferRing, DrainsInSubmissionOrder)
+{
+    FakeBackend backend;
+    BufferRing ring(3, backend);
+    for (int i = 0; i < 3; i++)
+        EXPECT_EQ(ring.acquire(), i);
+    // Submitted out of acquisition order.
+    EXPECT_TRUE(ring.submit(2));
+    EXPECT_TRUE(ring.submit(0));
+    EXPECT_TRUE(ring.submit(1));
+    EXPECT_EQ(ring.drain(), 2);
+    EXPECT_EQ(ring.drain(), 0);
+    EXPECT_EQ(ring.drain(), 1);
+    EXPECT_EQ(ring.drain(), -1);
+    EXPECT_TRUE((backend.synchronized == std::vector<int>{2, 0, 1}));
+    EXPECT_EQ(ring.count(SlotState::kDRAINING), 3);
+}
+
+TEST(BufferRing, WrongStateCallsChangeNothing)
+{
+    FakeBackend backend;
+    BufferRing ring(2, backend);
+    // Nothing acquired yet.
+    EXPECT_FALSE(ring.submit(0));
+    EXPECT_FALSE(ring.cancel(0));
+    EXPECT_FALSE(ring.release(0));
+    EXPECT_FALSE(ring.submit(-1));
+    EXPECT_FALSE(ring.submit(2));
+    EXPECT_FALSE(ring.release(7));
+    EXPECT_TRUE((states(ring) == std::vector<SlotState>{SlotState::kFREE, SlotState::kFREE}));
+
+    EXPECT_EQ(ring.acquire(), 0);
+    EXPECT_FALSE(ring.release(0));
+    EXPECT_TRUE(ring.submit(0));
+    EXPECT_FALSE(ring.submit(0));
+    EXPECT_FALSE(ring.cancel(0));
+    EXPECT_FALSE(ring.release(0));
+    EXPECT_EQ(ring.getState(0), SlotState::kIN_FLIGHT);
+    EXPECT_TRUE((backend.enqueued == std::vector<int>{0}));
+
+    EXPECT_EQ(ring.drain(), 0);
+    EXPECT_FALSE(ring.submit(0));
+    EXPECT_FALSE(ring.cancel(0));
+    EXPECT_EQ(ring.getState(0), SlotState::kDRAINING);
+    EXPECT_TRUE(ring.release(0));
+    EXPECT_FALSE(ring.release(0));
+    EXPECT_EQ(ring.getState(0), SlotState::kFREE);
+    // The failed calls did not move the ring position either.
+    EXPECT_EQ(ring.acquire(), 1);
+}
+
+TEST(BufferRing, FailedEnqueueKeepsTheSlotFilling)
+{
+    FakeBackend backend;
+    BufferRing ring(2, backend);
+    EXPECT_EQ(ring.acquire(), 0);
+    backend.failEnqueue = true;
+    EXPECT_FALSE(ring.submit(0));
+    EXPECT_EQ(ring.getState(0), SlotState::kFILLING);
+    EXPECT_EQ(ring.drain(), -1);
+
+    // It can be submitted again...
+    backend.failEnqueue = false;
+    EXPECT_TRUE(ring.submit(0));
+    EXPECT_EQ(ring.getState(0), SlotState::kIN_FLIGHT);
+
+    // ...or cancelled.
+    EXPECT_EQ(ring.acquire(), 1);
+    backend.failEnqueue = true;
+    EXPECT_FALSE(ring.submit(1));
+    EXPECT_TRUE(ring.cancel(1));
+    EXPECT_EQ(ring.getState(1), SlotState::kFREE);
+}
+
+TEST(BufferRing, FailedSynchronize)
+{
+    FakeBackend backend;
+    backend.failing.insert(1);
+    BufferRing ring(2, backend);
+    ring.acquire();
+    ring.submit(0);
+    ring.acquire();
+    ring.submit(1);
+    EXPECT_EQ(ring.drain(), 0);
+    EXPECT_FALSE(ring.hasFailed(0));
+    EXPECT_EQ(ring.drain(), 1);
+    EXPECT_TRUE(ring.hasFailed(1));
+    // The failed slot is drained all the same and can be reused.
+    EXPECT_EQ(ring.getState(1), SlotState::kDRAINING);
+    EXPECT_TRUE(ring.release(1));
+    EXPECT_TRUE(ring.release(0));
+
+    // synchronize() drains everything in flight and reports the failure.
+    ring.acquire();
+    ring.submit(0);
+    ring.acquire();
+    ring.submit(1);
+    EXPECT_FALSE(ring.synchronize());
+    EXPECT_EQ(ring.count(SlotState::kDRAINING), 2);
+
+    backend.failing.clear();
+    ring.release(0);
+    ring.release(1);
+    ring.acquire();
+    ring.submit(0);
+    EXPECT_TRUE(ring.synchronize());
+    EXPECT_FALSE(ring.hasFailed(0));
+}
+
+TEST(BufferRing, TryDrainWaitsForTheFence)
+{
+    FakeBackend backend;
+    BufferRing ring(2, backend);
+    EXPECT_EQ(ring.tryDrain(), -1);
+    ring.acquire();
+    ring.submit(0);
+    ring.acquire();
+    ring.submit(1);
+    // Slot 1 completed first, but slot 0 is the oldest and is still running.
+    backend.completed.insert(1);
+    EXPECT_EQ(ring.tryDrain(), -1);
+    EXPECT_EQ(ring.getState(0), SlotState::kIN_FLIGHT);
+    EXPECT_TRUE(backend.synchronized.empty());
+
+    backend.completed.insert(0);
+    EXPECT_EQ(ring.tryDrain(), 0);
+    EXPECT_EQ(ring.tryDrain(), 1);
+    EXPECT_EQ(ring.tryDrain(), -1);
+}
+
+TEST(BufferRing, AtLeastOneSlot)
+{
+    FakeBackend backend;
+    BufferRing ring(0, backend);
+    EXPECT_EQ(ring.getNbSlots(), 1);
+    EXPECT_EQ(ring.acquire(), 0);
+    EXPECT_EQ(ring.acquire(), -1);
+}
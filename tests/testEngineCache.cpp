@@ -0,0 +1,174 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "engineCache.h"
+#include "testing.h"
+#include <algorithm>
+#include <sys/time.h>
+
+using namespace samplesCommon;
+
+namespace
+{
+
+//! Set the modification time of path to seconds after the epoch, so that tests control the LRU order.
+void setMtime(const std::string& path, time_t seconds)
+{
+    timespec times[2];
+    times[0].tv_sec = times[1].tv_sec = seconds;
+    times[0].tv_nsec = times[1].tv_nsec = 0;
+    utimensat(AT_FDCWD, path.c_str(), times, 0);
+}
+
+std::vector<std::string> keys(const EngineCache& cache)
+{
+    std::vector<std::string> result;
+    for (const auto& e : cache.list())
+        result.push_back(e.key);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+const std::string kPLAN(100, 'p');
+
+} // namespace
+
+TEST(Fnv1aHash, knownDigests)
+{
+    EXPECT_EQ(Fnv1aHash().hexDigest(), "cbf29ce484222325");
+    EXPECT_EQ(hashBytes("a", 1), "af63dc4c8601ec8c");
+    EXPECT_EQ(hashBytes("foobar", 6), "85944171f73967e8");
+    EXPECT_EQ(Fnv1aHash().update("foo").update("bar").hexDigest(), "85944171f73967e8");
+}
+
+TEST(EngineCacheKey, hashesFileContentNotName)
+{
+    samplesTest::TempDir dir;
+    std::string a = dir.write("a.prototxt", "layer {}");
+    std::string b = dir.write("b.prototxt", "layer {}");
+    std::string c = dir.write("c.prototxt", "layer { }");
+
+    EXPECT_EQ(EngineCacheKey().addFile(a).str(), EngineCacheKey().addFile(b).str());
+    EXPECT_FALSE(EngineCacheKey().addFile(a).str() == EngineCacheKey().addFile(c).str());
+    EXPECT_FALSE(EngineCacheKey().addFile(a).str() == EngineCacheKey().addFile(dir.path("missing")).str());
+}
+
+TEST(EngineCacheKey, settingsAreOrderedNameValuePairs)
+{
+    std::string ab = EngineCacheKey().addSetting("batch", 8).addSetting("fp16", true).str();
+    std::string ba = EngineCacheKey().addSetting("fp16", true).addSetting("batch", 8).str();
+    EXPECT_EQ(ab.size(), 16u);
+    EXPECT_FALSE(ab == ba);
+    EXPECT_EQ(ab, EngineCacheKey().addSetting("batch", 8).addSetting("fp16", true).str());
+    EXPECT_FALSE(EngineCacheKey().addSetting("batch", 8).str() == EngineCacheKey().addSetting("batch", 16).str());
+}
+
+TEST(EngineCache, disabledWithoutDirectory)
+{
+    EngineCache cache("");
+    MappedFile plan;
+    EXPECT_FALSE(cache.isEnabled());
+    EXPECT_FALSE(cache.store("k", kPLAN.data(), kPLAN.size()));
+    EXPECT_FALSE(cache.load("k", plan));
+}
+
+TEST(EngineCache, storeAndLoadInNestedDirectory)
+{
+    samplesTest::TempDir dir;
+    const std::string root = dir.path("cache");
+    const std::string nested = root + "/engines";
+    EngineCache cache(nested);
+    MappedFile plan;
+    EXPECT_FALSE(cache.load("k", plan));
+    ASSERT_TRUE(cache.store("k", kPLAN.data(), kPLAN.size()));
+    ASSERT_TRUE(cache.load("k", plan));
+    EXPECT_EQ(std::string(static_cast<const char*>(plan.data()), plan.size()), kPLAN);
+    EXPECT_TRUE((keys(cache) == std::vector<std::string>{"k"}));
+
+    plan.close();
+    std::remove(cache.getPath("k").c_str());
+    rmdir(nested.c_str());
+    rmdir(root.c_str());
+}
+
+TEST(EngineCache, evictsLeastRecentlyUsedFirst)
+{
+    samplesTest::TempDir dir;
+    const std::string root = dir.path("cache");
+    EngineCache cache(root, 250);
+    ASSERT_TRUE(cache.store("a", kPLAN.data(), kPLAN.size()));
+    ASSERT_TRUE(cache.store("b", kPLAN.data(), kPLAN.size()));
+    setMtime(cache.getPath("a"), 1000);
+    setMtime(cache.getPath("b"), 2000);
+
+    // Loading a refreshes it, so b is now the least recently used plan and makes room for c.
+    MappedFile plan;
+    ASSERT_TRUE(cache.load("a", plan));
+    ASSERT_TRUE(cache.store("c", kPLAN.data(), kPLAN.size()));
+    EXPECT_TRUE((keys(cache) == std::vector<std::string>{"a", "c"}));
+
+    for (const std::string key : {"a", "c"})
+        std::remove(cache.getPath(key).c_str());
+    rmdir(root.c_str());
+}
+
+TEST(EngineCache, keepsThePlanJustStored)
+{
+    samplesTest::TempDir dir;
+    const std::string root = dir.path("cache");
+    EngineCache cache(root, 50);
+    ASSERT_TRUE(cache.store("old", kPLAN.data(), kPLAN.size()));
+    setMtime(cache.getPath("old"), 1000);
+    ASSERT_TRUE(cache.store("new", kPLAN.data(), kPLAN.size()));
+    // Over the limit on its own, but the plan just stored is never evicted.
+    EXPECT_TRUE((keys(cache) == std::vector<std::string>{"new"}));
+    EXPECT_EQ(cache.evict(), 1);
+    EXPECT_TRUE(keys(cache).empty());
+    rmdir(root.c_str());
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "hostMemory.h"
+#include "testing.h"
+#include <cstdint>
+#include <cstring>
+
+using namespace samplesCommon;
+
+namespace
+{
+
+bool isAligned(const void* ptr, size_t alignment)
+{
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+} // namespace
+
+TEST(HostMemory, RoundUp)
+{
+    EXPECT_EQ(roundUp(0, 64), 64u);
+    EXPECT_EQ(roundUp(1, 64), 64u);
+    EXPECT_EQ(roundUp(64, 64), 64u);
+    EXPECT_EQ(roundUp(65, 64), 128u);
+    EXPECT_EQ(roundUp(1, 1), 1u);
+    EXPECT_EQ(roundUp(kHUGE_PAGE_SIZE + 1, kHUGE_PAGE_SIZE), 2 * kHUGE_PAGE_SIZE);
+}
+
+TEST(HostMemory, AlignedAlloc)
+{
+    for (size_t size : {0, 1, 63, 64, 100, 4097})
+    {
+        void* ptr = alignedAlloc(size);
+        ASSERT_TRUE(ptr != nullptr);
+        EXPECT_TRUE(isAligned(ptr, kHOST_ALIGNMENT));
+        // The whole rounded-up block is usable.
+        std::memset(ptr, 0xab, roundUp(size, kHOST_ALIGNMENT));
+        free(ptr);
+    }
+    for (size_t alignment : {sizeof(void*), size_t(128), size_t(4096)})
+    {
+        void* ptr = alignedAlloc(10, alignment);
+        ASSERT_TRUE(ptr != nullptr);
+        EXPECT_TRUE(isAligned(ptr, alignment));
+        free(ptr);
+    }
+    // Not a power of two multiple of sizeof(void*).
+    EXPECT_TRUE(alignedAlloc(10, 3) == nullptr);
+}
+
+TEST(HostMemory, HugePageAlloc)
+{
+    for (size_t size : {1, 3 << 20})
+    {
+        void* ptr = hugePageAlloc(size);
+        ASSERT_TRUE(ptr != nullptr);
+        EXPECT_TRUE(isAligned(ptr, kHUGE_PAGE_SIZE));
+        std::memset(ptr, 0, roundUp(size, kHUGE_PAGE_SIZE));
+        free(ptr);
+    }
+}
+
+TEST(HostMemory, AlignedHostAllocator)
+{
+    void* ptr = nullptr;
+    AlignedHostAllocator allocate;
+    ASSERT_TRUE(allocate(&ptr, 1000));
+    EXPECT_TRUE(isAligned(ptr, kHOST_ALIGNMENT));
+    AlignedHostFree()(ptr);
+
+    HostMemoryPool pool;
+    void* block = pool.allocate(300);
+    ASSERT_TRUE(block != nullptr);
+    EXPECT_TRUE(isAligned(block, kHOST_ALIGNMENT));
+    pool.release(block);
+    EXPECT_TRUE(pool.allocate(300) == block);
+    pool.release(block);
+}
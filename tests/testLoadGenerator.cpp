@@ -0,0 +1,234 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "loadGenerator.h"
+#include "testing.h"
+
+using namespace samplesCommon;
+
+namespace
+{
+
+//! A stream that takes serviceMs per inference and fails on call number failAt.
+class FakeStream : public IInferenceStream
+{
+public:
+    explicit FakeStream(double serviceMs, int failAt = -1)
+        : mServiceMs(serviceMs)
+        , mFailAt(failAt)
+    {
+    }
+
+    bool infer(float& gpuMs) override
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(mServiceMs));
+        gpuMs = -1.0f;
+        return mCalls++ != mFailAt;
+    }
+
+    int getCalls() const { return mCalls; }
+
+private:
+    double mServiceMs;
+    int mFailAt;
+    std::atomic<int> mCalls{0};
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+TEST(ArrivalSchedule, uniformGaps)
+{
+    ArrivalSchedule schedule(4.0, ArrivalProcess::kUNIFORM);
+    EXPECT_NEAR(schedule.next(), 0.25, 1e-12);
+    EXPECT_NEAR(schedule.next(), 0.5, 1e-12);
+    EXPECT_NEAR(schedule.next(), 0.75, 1e-12);
+}
+
+TEST(ArrivalSchedule, poissonMeanGap)
+{
+    ArrivalSchedule schedule(100.0, ArrivalProcess::kPOISSON, 7);
+    double previous{0.0};
+    bool increasing{true};
+    const int n = 100000;
+    for (int i = 0; i < n; i++)
+    {
+        double t = schedule.next();
+        increasing = increasing && t > previous;
+        previous = t;
+    }
+    EXPECT_TRUE(increasing);
+    EXPECT_NEAR(previous / n, 0.01, 0.0002);
+}
+
+TEST(BoundedQueue, rejectsWhenFullAndDrainsAfterClose)
+{
+    BoundedQueue<int> queue(2);
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_FALSE(queue.push(3));
+    queue.close();
+    EXPECT_FALSE(queue.push(4));
+
+    int item{0};
+    EXPECT_TRUE(queue.pop(item));
+    EXPECT_EQ(item, 1);
+    EXPECT_TRUE(queue.pop(item));
+    EXPECT_EQ(item, 2);
+    EXPECT_FALSE(queue.pop(item));
+}
+
+TEST(OpenLoopRunner, servesEveryRequestUnderLightLoad)
+{
+    FakeStream a(0.1), b(0.1);
+    OpenLoopRunner runner({&a, &b}, 16, ArrivalProcess::kUNIFORM);
+    LoadPointStats stats;
+    EXPECT_TRUE(runner.run(1000.0, 50, stats));
+    EXPECT_EQ(stats.completed, 50u);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.total.count(), 50u);
+    EXPECT_TRUE(stats.service.min() >= 0.1);
+    EXPECT_TRUE(stats.total.mean() >= stats.service.mean());
+}
+
+TEST(OpenLoopRunner, countsDropsUnderOverload)
+{
+    FakeStream stream(20.0);
+    OpenLoopRunner runner({&stream}, 1, ArrivalProcess::kUNIFORM);
+    LoadPointStats stats;
+    EXPECT_TRUE(runner.run(1000.0, 40, stats));
+    EXPECT_TRUE(stats.dropped > 0);
+    EXPECT_EQ(stats.completed + stats.dropped, 40u);
+}
+
+TEST(OpenLoopRunner, failureEndsTheRunEarly)
+{
+    // 200 requests at 20 qps would take 10 s; the first inference fails, so the run must end long before.
+    FakeStream stream(1.0, 0);
+    OpenLoopRunner runner({&stream}, 4, ArrivalProcess::kUNIFORM);
+    LoadPointStats stats;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(runner.run(20.0, 200, stats));
+    EXPECT_TRUE(secondsSince(start) < 1.0);
+    EXPECT_EQ(stats.completed, 0u);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stream.getCalls(), 1);
+}
+
+TEST(OpenLoopRunner, preparesOutsideTheServiceTime)
+{
+    class StagingStream : public IInferenceStream
+    {
+    public:
+        void prepare() override
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            prepared = true;
+        }
+        bool infer(float& gpuMs) override
+        {
+            gpuMs = -1.0f;
+            unprepared += !prepared;
+            prepared = false;
+            return true;
+        }
+        bool prepared{false};
+        int unprepared{0};
+    } stream;
+
+    OpenLoopRunner runner({&stream}, 4, ArrivalProcess::kUNIFORM);
+    LoadPointStats stats;
+    EXPECT_TRUE(runner.run(50.0, 10, stats));
+    EXPECT_EQ(stats.completed, 10u);
+    EXPECT_EQ(stream.unprepared, 0);
+    EXPECT_TRUE(stats.service.max() < 2.5);
+}
+
+namespace
+{
+//! Stands in for the current CUDA device, which every new thread starts at 0.
+thread_local int tCurrentDevice{0};
+} // namespace
+
+TEST(OpenLoopRunner, bindsEveryWorkerThread)
+{
+    class DeviceStream : public IInferenceStream
+    {
+    public:
+        void bindThread() override
+        {
+            tCurrentDevice = 1;
+            ++binds;
+        }
+        void prepare() override
+        {
+            wrongDevice += tCurrentDevice != 1;
+        }
+        bool infer(float& gpuMs) override
+        {
+            gpuMs = -1.0f;
+            wrongDevice += tCurrentDevice != 1;
+            return true;
+        }
+        std::atomic<int> binds{0};
+        std::atomic<int> wrongDevice{0};
+    } a, b;
+
+    OpenLoopRunner runner({&a, &b}, 16, ArrivalProcess::kUNIFORM);
+    LoadPointStats stats;
+    EXPECT_TRUE(runner.run(1000.0, 20, stats));
+    EXPECT_EQ(stats.completed, 20u);
+    EXPECT_EQ(a.binds.load(), 1);
+    EXPECT_EQ(b.binds.load(), 1);
+    EXPECT_EQ(a.wrongDevice.load() + b.wrongDevice.load(), 0);
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "multiProcess.h"
+#include "testing.h"
+
+using namespace samplesCommon;
+
+namespace
+{
+
+std::string uniqueName(const char* what)
+{
+    return std::string("/trtexec_test.") + what + "." + std::to_string(getpid());
+}
+
+} // namespace
+
+TEST(Semaphore, PostAndWait)
+{
+    Semaphore semaphore(uniqueName("sem"));
+    semaphore.open();
+    EXPECT_FALSE(semaphore.waitFor(10));
+    semaphore.post();
+    EXPECT_TRUE(semaphore.waitFor(10));
+    semaphore.post();
+    semaphore.wait();
+    EXPECT_FALSE(semaphore.waitFor(0));
+}
+
+TEST(Semaphore, OpenThrowsWhenTheNameIsTaken)
+{
+    // This is how a second --processes run with a stale or clashing name fails.
+    Semaphore first(uniqueName("taken"));
+    first.open();
+    Semaphore second(uniqueName("taken"));
+    bool threw{false};
+    try
+    {
+        second.open();
+    }
+    catch (const std::runtime_error& e)
+    {
+        threw = std::string(e.what()).find("Could not create semaphore") != std::string::npos;
+    }
+    EXPECT_TRUE(threw);
+}
+
+TEST(SharedMemory, OpenReadOnlyThrowsWhenMissing)
+{
+    SharedMemory memory(uniqueName("missing"));
+    bool threw{false};
+    try
+    {
+        memory.open_ro();
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+
+    int fd = memory.open_rw();
+    EXPECT_TRUE(fd >= 0);
+    close(fd);
+    fd = memory.open_ro();
+    EXPECT_TRUE(fd >= 0);
+    close(fd);
+}
+
+TEST(ProcessGroup, ChildrenShareTheArrayAndReportFailures)
+{
+    SharedArray<int> values(4);
+    ProcessGroup children;
+    ASSERT_TRUE(children.spawn(4, [&values](int index) {
+        values[index] = 10 + index;
+        return index % 2 == 0;
+    }));
+    EXPECT_EQ(children.size(), 4u);
+    EXPECT_EQ(children.waitAll(), 2);
+    EXPECT_EQ(children.poll(), 0);
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(values[i], 10 + i);
+        EXPECT_FALSE(children.isRunning(i));
+    }
+}
+
+TEST(ProcessGroup, MergesCompletedResults)
+{
+    SharedArray<ProcessResult> results(3);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        results[i].stats.inferences = 100;
+        results[i].stats.host.record(1.0 + i);
+        results[i].wallMs = 1000;
+    }
+    results[0].state = ProcessResult::kDONE;
+    results[1].state = ProcessResult::kFAILED;
+    results[2].state = ProcessResult::kDONE;
+
+    StreamStats merged;
+    double inferencesPerSecond{0};
+    EXPECT_EQ(mergeProcessResults(results, merged, inferencesPerSecond), 2);
+    EXPECT_EQ(merged.inferences, 200u);
+    EXPECT_EQ(merged.host.count(), 2u);
+    EXPECT_NEAR(inferencesPerSecond, 200.0, 1e-9);
+}
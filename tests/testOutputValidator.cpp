@@ -0,0 +1,331 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "outputValidator.h"
+#include "testing.h"
+#include <random>
+
+using namespace samplesCommon;
+using nvinfer1::DataType;
+
+namespace
+{
+
+const float kNAN = std::numeric_limits<float>::quiet_NaN();
+const float kINF = std::numeric_limits<float>::infinity();
+
+uint16_t toHalfBits(float v)
+{
+    half_float::half h(v);
+    uint16_t bits;
+    std::memcpy(&bits, &h, sizeof(bits));
+    return bits;
+}
+
+float fromHalfBits(uint16_t bits)
+{
+    half_float::half h;
+    std::memcpy(static_cast<void*>(&h), &bits, sizeof(bits));
+    return static_cast<float>(h);
+}
+
+//!
+//! \brief validateTensor written out element by element on values already converted to float, as the reference the
+//!        blocked and vectorized implementation has to agree with.
+//!
+ValidationReport naiveValidate(const std::vector<float>& out, const std::vector<float>& ref, DataType outputType,
+    const ValidationTolerance& tol, size_t maxMismatches)
+{
+    ValidationReport report;
+    report.nbElements = out.size();
+    double sum{0};
+    for (size_t i = 0; i < out.size(); i++)
+    {
+        float err = std::fabs(out[i] - ref[i]);
+        float absRef = std::fabs(ref[i]);
+        if (!std::isnan(err))
+        {
+            sum += err;
+            if (err > report.maxAbsError)
+            {
+                report.maxAbsError = err;
+                report.maxAbsErrorIndex = i;
+            }
+            report.maxRelError = std::max(report.maxRelError, static_cast<double>(err / std::max(absRef, FLT_MIN)));
+        }
+        bool bothInfinite = std::isinf(out[i]) && std::isinf(ref[i]);
+        if (bothInfinite ? out[i] == ref[i] : err <= tol.absTol + tol.relTol * absRef)
+            continue;
+        int64_t ulps = ulpDistance(out[i], ref[i], outputType);
+        if (ulps <= tol.ulpTol)
+            continue;
+        if (report.mismatches.size() < maxMismatches)
+            report.mismatches.push_back(ValidationMismatch{i, out[i], ref[i], ulps});
+        report.nbMismatches++;
+    }
+    report.meanAbsError = out.empty() ? 0 : sum / out.size();
+    return report;
+}
+
+bool sameFloat(float a, float b)
+{
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+void expectSameReport(const ValidationReport& actual, const ValidationReport& expected)
+{
+    EXPECT_EQ(actual.nbElements, expected.nbElements);
+    EXPECT_EQ(actual.nbMismatches, expected.nbMismatches);
+    EXPECT_TRUE(actual.maxAbsError == expected.maxAbsError);
+    EXPECT_EQ(actual.maxAbsErrorIndex, expected.maxAbsErrorIndex);
+    EXPECT_TRUE(actual.maxRelError == expected.maxRelError);
+    // Blocks are summed in float, so the mean only agrees to float precision.
+    if (std::isinf(expected.meanAbsError))
+        EXPECT_TRUE(actual.meanAbsError == expected.meanAbsError);
+    else
+        EXPECT_NEAR(actual.meanAbsError, expected.meanAbsError, 1e-5 * expected.meanAbsError + 1e-12);
+    ASSERT_EQ(actual.mismatches.size(), expected.mismatches.size());
+    for (size_t i = 0; i < actual.mismatches.size(); i++)
+    {
+        EXPECT_EQ(actual.mismatches[i].index, expected.mismatches[i].index);
+        EXPECT_TRUE(sameFloat(actual.mismatches[i].output, expected.mismatches[i].output));
+        EXPECT_TRUE(sameFloat(actual.mismatches[i].reference, expected.mismatches[i].reference));
+        EXPECT_EQ(actual.mismatches[i].ulps, expected.mismatches[i].ulps);
+    }
+}
+
+//! A float reference of n values and an output close to it, with every 97th element pushed out of tolerance.
+void makeFloatData(size_t n, std::vector<float>& out, std::vector<float>& ref)
+{
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> value(-4.0f, 4.0f);
+    std::uniform_real_distribution<float> noise(-2e-4f, 2e-4f);
+    out.resize(n);
+    ref.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        ref[i] = value(rng);
+        out[i] = ref[i] * (1.0f + noise(rng)) + (i % 97 == 5 ? 0.5f : 0.0f);
+    }
+}
+
+} // namespace
+
+TEST(OutputValidator, compareBlockMatchesScalarLoopForEveryTail)
+{
+    std::vector<float> out, ref;
+    makeFloatData(37, out, ref);
+    out[2] = kNAN;
+    out[9] = -ref[9];
+    ValidationTolerance tol;
+    for (size_t n = 0; n <= out.size(); n++)
+    {
+        detail::BlockStats expected;
+        float sum{0};
+        detail::compareScalar(out.data(), ref.data(), n, tol, sum, expected);
+        detail::BlockStats actual = detail::compareBlock(out.data(), ref.data(), n, tol);
+        EXPECT_EQ(actual.nbCandidates, expected.nbCandidates);
+        EXPECT_TRUE(actual.maxAbsError == expected.maxAbsError);
+        EXPECT_TRUE(actual.maxRelError == expected.maxRelError);
+        EXPECT_NEAR(actual.sumAbsError, sum, 1e-5 * sum + 1e-12);
+    }
+}
+
+TEST(OutputValidator, matchesNaiveReferenceAcrossBlocks)
+{
+    // Not a multiple of 4 and spread over three blocks, the last one partial.
+    const size_t n = 2 * detail::kVALIDATION_BLOCK + 7;
+    std::vector<float> out, ref;
+    makeFloatData(n, out, ref);
+    ValidationTolerance tol;
+    ValidationReport report = validateTensor(out.data(), DataType::kFLOAT, ref.data(), DataType::kFLOAT, n, tol, 1000);
+    EXPECT_TRUE(report.nbMismatches > 40);
+    expectSameReport(report, naiveValidate(out, ref, DataType::kFLOAT, tol, 1000));
+}
+
+TEST(OutputValidator, largestErrorInTheTailIsFound)
+{
+    const size_t n = detail::kVALIDATION_BLOCK + 3;
+    std::vector<float> out(n, 1.0f), ref(n, 1.0f);
+    out[n - 1] = 3.0f;
+    ValidationReport report = validateTensor(out.data(), DataType::kFLOAT, ref.data(), DataType::kFLOAT, n, {});
+    EXPECT_EQ(report.maxAbsErrorIndex, n - 1);
+    EXPECT_NEAR(report.maxAbsError, 2.0, 0);
+    EXPECT_EQ(report.nbMismatches, 1u);
+}
+
+TEST(OutputValidator, nanAndInfinityPairs)
+{
+    // NaN/NaN, NaN/value, value/NaN, Inf/Inf, -Inf/Inf and Inf/value, then Inf/-Inf in the scalar tail.
+    std::vector<float> out{kNAN, kNAN, 1.0f, kINF, -kINF, kINF, 2.0f, 2.0f, kINF};
+    std::vector<float> ref{kNAN, 1.0f, kNAN, kINF, kINF, 1.0f, 2.0f, 2.0f, -kINF};
+    ValidationTolerance tol;
+    ValidationReport report
+        = validateTensor(out.data(), DataType::kFLOAT, ref.data(), DataType::kFLOAT, out.size(), tol);
+    EXPECT_EQ(report.nbMismatches, 5u);
+    ASSERT_EQ(report.mismatches.size(), 5u);
+    EXPECT_EQ(report.mismatches[0].index, 1u);
+    EXPECT_EQ(report.mismatches[1].index, 2u);
+    EXPECT_EQ(report.mismatches[2].index, 4u);
+    EXPECT_EQ(report.mismatches[3].index, 5u);
+    EXPECT_EQ(report.mismatches[4].index, 8u);
+    EXPECT_TRUE(report.mismatches[0].ulps == std::numeric_limits<int64_t>::max());
+    EXPECT_TRUE(std::isinf(report.maxAbsError));
+    EXPECT_FALSE(report.passed());
+    expectSameReport(report, naiveValidate(out, ref, DataType::kFLOAT, tol, 10));
+}
+
+TEST(OutputValidator, signedZerosMatch)
+{
+    std::vector<float> out{0.0f, -0.0f, -0.0f, 0.0f, 0.0f};
+    std::vector<float> ref{-0.0f, 0.0f, -0.0f, 0.0f, -0.0f};
+    ValidationTolerance tol;
+    tol.absTol = 0;
+    tol.relTol = 0;
+    ValidationReport report
+        = validateTensor(out.data(), DataType::kFLOAT, ref.data(), DataType::kFLOAT, out.size(), tol);
+    EXPECT_TRUE(report.passed());
+    EXPECT_NEAR(report.maxAbsError, 0.0, 0);
+    EXPECT_EQ(ulpDistance(0.0f, -0.0f, DataType::kFLOAT), 0);
+    EXPECT_EQ(ulpDistance(0.0f, -0.0f, DataType::kHALF), 0);
+    // The smallest denormals on either side of zero are one ulp from it and two from each other.
+    const float tiny = std::numeric_limits<float>::denorm_min();
+    EXPECT_EQ(ulpDistance(tiny, -0.0f, DataType::kFLOAT), 1);
+    EXPECT_EQ(ulpDistance(tiny, -tiny, DataType::kFLOAT), 2);
+}
+
+TEST(OutputValidator, halfOutputAgainstFloatReference)
+{
+    const size_t n = detail::kVALIDATION_BLOCK + 5;
+    std::vector<float> out, ref;
+    makeFloatData(n, out, ref);
+    std::vector<uint16_t> halfOut(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        halfOut[i] = toHalfBits(out[i]);
+        out[i] = fromHalfBits(halfOut[i]);
+    }
+    ValidationTolerance tol;
+    tol.ulpTol = 1;
+    ValidationReport report = validateTensor(halfOut.data(), DataType::kHALF, ref.data(), DataType::kFLOAT, n, tol, 50);
+    EXPECT_TRUE(report.nbMismatches > 0);
+    expectSameReport(report, naiveValidate(out, ref, DataType::kHALF, tol, 50));
+}
+
+TEST(OutputValidator, int8OutputAgainstFloatReference)
+{
+    const size_t n = 1001;
+    std::vector<int8_t> int8Out(n);
+    std::vector<float> out(n), ref(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        ref[i] = static_cast<float>(static_cast<int>(i % 255) - 127) + (i % 3 == 0 ? 0.4f : 0.0f);
+        int8Out[i] = static_cast<int8_t>(static_cast<int>(i % 255) - 127 + (i % 50 == 7 ? 2 : 0));
+        out[i] = int8Out[i];
+    }
+    ValidationTolerance tol;
+    tol.absTol = 0.5f;
+    tol.relTol = 0;
+    ValidationReport report = validateTensor(int8Out.data(), DataType::kINT8, ref.data(), DataType::kFLOAT, n, tol);
+    EXPECT_TRUE(report.nbMismatches > 0);
+    EXPECT_EQ(report.mismatches[0].index, 7u);
+    EXPECT_EQ(report.mismatches[0].ulps, 2);
+    expectSameReport(report, naiveValidate(out, ref, DataType::kINT8, tol, 10));
+}
+
+TEST(OutputValidator, ulpToleranceAcceptsNearbyValues)
+{
+    ValidationTolerance tol;
+    tol.absTol = 0;
+    tol.relTol = 0;
+    tol.ulpTol = 2;
+    std::vector<float> ref(6, 1000.0f);
+    std::vector<float> out(ref);
+    for (size_t i = 1; i < out.size(); i++)
+        out[i] = std::nextafter(out[i - 1], kINF);
+    ValidationReport report
+        = validateTensor(out.data(), DataType::kFLOAT, ref.data(), DataType::kFLOAT, out.size(), tol);
+    EXPECT_EQ(report.nbMismatches, 3u);
+    ASSERT_EQ(report.mismatches.size(), 3u);
+    EXPECT_EQ(report.mismatches[0].index, 3u);
+    EXPECT_EQ(report.mismatches[0].ulps, 3);
+    EXPECT_EQ(report.mismatches[2].ulps, 5);
+
+    // Half ulps are counted in the output type: 1 + 3 * 2^-10 is three half ulps above 1.
+    std::vector<uint16_t> halfOut{toHalfBits(1.0f + 3.0f / 1024), toHalfBits(1.0f + 2.0f / 1024)};
+    std::vector<float> halfRef{1.0f, 1.0f};
+    report = validateTensor(halfOut.data(), DataType::kHALF, halfRef.data(), DataType::kFLOAT, 2, tol);
+    EXPECT_EQ(report.nbMismatches, 1u);
+    EXPECT_EQ(report.mismatches[0].ulps, 3);
+}
+
+TEST(OutputValidator, truncatesMismatchListButCountsAll)
+{
+    const size_t n = 3 * detail::kVALIDATION_BLOCK + 1;
+    std::vector<float> out, ref;
+    makeFloatData(n, out, ref);
+    ValidationTolerance tol;
+    ValidationReport report = validateTensor(out.data(), DataType::kFLOAT, ref.data(), DataType::kFLOAT, n, tol, 3);
+    ValidationReport expected = naiveValidate(out, ref, DataType::kFLOAT, tol, 3);
+    EXPECT_TRUE(report.nbMismatches > 3);
+    EXPECT_EQ(report.mismatches.size(), 3u);
+    expectSameReport(report, expected);
+
+    report = validateTensor(out.data(), DataType::kFLOAT, ref.data(), DataType::kFLOAT, n, tol, 0);
+    EXPECT_EQ(report.nbMismatches, expected.nbMismatches);
+    EXPECT_TRUE(report.mismatches.empty());
+}
+
+TEST(OutputValidator, emptyTensorPasses)
+{
+    ValidationReport report = validateTensor(nullptr, DataType::kFLOAT, nullptr, DataType::kFLOAT, 0, {});
+    EXPECT_TRUE(report.passed());
+    EXPECT_EQ(report.nbElements, 0u);
+    EXPECT_NEAR(report.meanAbsError, 0.0, 0);
+}
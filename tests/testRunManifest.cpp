@@ -0,0 +1,239 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "runManifest.h"
+#include "testing.h"
+
+using namespace samplesCommon;
+
+namespace
+{
+
+bool parseJson(const std::string& text, std::vector<ManifestRun>& runs, std::string& error)
+{
+    return detail::ManifestJsonParser(text).parse(runs, error);
+}
+
+std::vector<std::string> args(std::initializer_list<const char*> list)
+{
+    return std::vector<std::string>(list.begin(), list.end());
+}
+
+void expectArgs(const std::vector<std::string>& actual, const std::vector<std::string>& expected)
+{
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); i++)
+    {
+        EXPECT_EQ(actual[i], expected[i]);
+    }
+}
+
+} // namespace
+
+TEST(RunManifest, jsonDefaultsPrecedeRunOptions)
+{
+    // The defaults come after the runs in the text but still precede each run's own options, which override them.
+    const std::string text = R"({"runs": [{"name": "a", "batch": 8}, {"name": "b", "fp16": true}],
+                                 "defaults": {"batch": 1, "iterations": "20"}})";
+    std::vector<ManifestRun> runs;
+    std::string error;
+    ASSERT_TRUE(parseJson(text, runs, error));
+    ASSERT_EQ(runs.size(), 2u);
+    EXPECT_EQ(runs[0].name, std::string("a"));
+    expectArgs(runs[0].args, args({"--batch=1", "--iterations=20", "--batch=8"}));
+    EXPECT_EQ(runs[1].name, std::string("b"));
+    expectArgs(runs[1].args, args({"--batch=1", "--iterations=20", "--fp16"}));
+}
+
+TEST(RunManifest, jsonArraysRepeatTheOption)
+{
+    const std::string text = R"([{"output": ["prob", "bbox"], "shape": [], "batch": 4, "scale": [-1.5e3]}])";
+    std::vector<ManifestRun> runs;
+    std::string error;
+    ASSERT_TRUE(parseJson(text, runs, error));
+    ASSERT_EQ(runs.size(), 1u);
+    expectArgs(runs[0].args, args({"--output=prob", "--output=bbox", "--batch=4", "--scale=-1.5e3"}));
+
+    runs.clear();
+    EXPECT_FALSE(parseJson(R"([{"output": [true]}])", runs, error));
+    EXPECT_TRUE(error.find("arrays may only hold strings and numbers") != std::string::npos);
+}
+
+TEST(RunManifest, jsonFalseAndNullLeaveTheOptionOut)
+{
+    const std::string text = R"({"defaults": {"fp16": false, "int8": null, "verbose": true},
+                                 "runs": [{"fp16": true, "int8": false, "calib": null}]})";
+    std::vector<ManifestRun> runs;
+    std::string error;
+    ASSERT_TRUE(parseJson(text, runs, error));
+    ASSERT_EQ(runs.size(), 1u);
+    expectArgs(runs[0].args, args({"--verbose", "--fp16"}));
+}
+
+TEST(RunManifest, jsonStringEscapes)
+{
+    const std::string text = R"([{"name": "a \"quoted\" run", "engine": "dir\/plan\\x"}])";
+    std::vector<ManifestRun> runs;
+    std::string error;
+    ASSERT_TRUE(parseJson(text, runs, error));
+    EXPECT_EQ(runs[0].name, std::string("a \"quoted\" run"));
+    expectArgs(runs[0].args, args({"--engine=dir/plan\\x"}));
+
+    runs.clear();
+    EXPECT_FALSE(parseJson(R"([{"name": "\u0041"}])", runs, error));
+    EXPECT_TRUE(error.find("\\u escapes are not supported") == 0);
+}
+
+TEST(RunManifest, jsonErrorOffsets)
+{
+    std::vector<ManifestRun> runs;
+    std::string error;
+    const std::string unterminated = R"([{"batch": "8)";
+    EXPECT_FALSE(parseJson(unterminated, runs, error));
+    EXPECT_EQ(error, "unterminated string at offset " + std::to_string(unterminated.size()));
+
+    runs.clear();
+    const std::string trailing = R"([{"batch": 8}]  x)";
+    EXPECT_FALSE(parseJson(trailing, runs, error));
+    EXPECT_EQ(error, "trailing characters at offset " + std::to_string(trailing.find('x')));
+
+    runs.clear();
+    const std::string unknown = R"({"run": []})";
+    EXPECT_FALSE(parseJson(unknown, runs, error));
+    EXPECT_EQ(error,
+        "unknown key \"run\", expected \"defaults\" or \"runs\" at offset " + std::to_string(unknown.find(':') + 1));
+
+    runs.clear();
+    EXPECT_FALSE(parseJson(R"([{"batch": 8x}])", runs, error));
+    EXPECT_TRUE(error.find("invalid value 8x") == 0);
+}
+
+TEST(RunManifest, iniDefaultsAndSections)
+{
+    const std::string text = "# shared\n"
+                             "iterations = 20\n"
+                             "  verbose  \n"
+                             "[fp16]\n"
+                             "onnx = model.onnx\n"
+                             "; a comment\n"
+                             "fp16\n"
+                             "\n"
+                             "[ int8 ]\n"
+                             "int8\n"
+                             "calib = a=b.cache\n";
+    std::vector<ManifestRun> runs;
+    std::string error;
+    ASSERT_TRUE(detail::parseIniManifest(text, runs, error));
+    ASSERT_EQ(runs.size(), 2u);
+    EXPECT_EQ(runs[0].name, std::string("fp16"));
+    expectArgs(runs[0].args, args({"--iterations=20", "--verbose", "--onnx=model.onnx", "--fp16"}));
+    EXPECT_EQ(runs[1].name, std::string("int8"));
+    expectArgs(runs[1].args, args({"--iterations=20", "--verbose", "--int8", "--calib=a=b.cache"}));
+}
+
+TEST(RunManifest, iniErrorsNameTheLine)
+{
+    std::vector<ManifestRun> runs;
+    std::string error;
+    EXPECT_FALSE(detail::parseIniManifest("[a]\nbatch = 2\n[b\n", runs, error));
+    EXPECT_EQ(error, std::string("line 3: malformed section header"));
+
+    runs.clear();
+    EXPECT_FALSE(detail::parseIniManifest("[a]\n= 2\n", runs, error));
+    EXPECT_EQ(error, std::string("line 2: missing option name"));
+}
+
+TEST(RunManifest, unnamedRunsAreNumbered)
+{
+    samplesTest::TempDir dir;
+    std::vector<ManifestRun> runs;
+    std::string error;
+    ASSERT_TRUE(loadRunManifest(
+        dir.write("m.json", R"([{"batch": 1}, {"name": "big", "batch": 64}, {"batch": 2}])"), runs, error));
+    ASSERT_EQ(runs.size(), 3u);
+    EXPECT_EQ(runs[0].name, std::string("run1"));
+    EXPECT_EQ(runs[1].name, std::string("big"));
+    EXPECT_EQ(runs[2].name, std::string("run3"));
+
+    // An INI section with a blank name is numbered by its position as well.
+    ASSERT_TRUE(loadRunManifest(dir.write("m.ini", "[x]\nbatch = 4\n[ ]\nbatch = 8\n"), runs, error));
+    ASSERT_EQ(runs.size(), 2u);
+    EXPECT_EQ(runs[0].name, std::string("x"));
+    EXPECT_EQ(runs[1].name, std::string("run2"));
+    expectArgs(runs[1].args, args({"--batch=8"}));
+}
+
+TEST(RunManifest, leadingBracketDetection)
+{
+    samplesTest::TempDir dir;
+    std::vector<ManifestRun> runs;
+    std::string error;
+
+    // An array of objects is JSON, even with whitespace before the first object.
+    ASSERT_TRUE(loadRunManifest(dir.write("a", "\n  [\n  {\"batch\": 2}]\n"), runs, error));
+    ASSERT_EQ(runs.size(), 1u);
+    expectArgs(runs[0].args, args({"--batch=2"}));
+
+    // A section header is INI.
+    ASSERT_TRUE(loadRunManifest(dir.write("b", "[fp16]\nfp16\n"), runs, error));
+    ASSERT_EQ(runs.size(), 1u);
+    EXPECT_EQ(runs[0].name, std::string("fp16"));
+    expectArgs(runs[0].args, args({"--fp16"}));
+
+    // An empty JSON array parses but holds no runs.
+    EXPECT_FALSE(loadRunManifest(dir.write("c", "[ ]"), runs, error));
+    EXPECT_EQ(error, dir.path("c") + ": no runs");
+
+    // A JSON parse error is reported with the file name and offset.
+    EXPECT_FALSE(loadRunManifest(dir.write("d", "[{\"batch\": 2}"), runs, error));
+    EXPECT_EQ(error, dir.path("d") + ": expected ',' at offset 13");
+
+    EXPECT_FALSE(loadRunManifest(dir.path("missing"), runs, error));
+    EXPECT_EQ(error, "cannot open " + dir.path("missing"));
+}
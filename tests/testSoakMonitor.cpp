@@ -0,0 +1,202 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "soakMonitor.h"
+#include "testing.h"
+#include <thread>
+
+using namespace samplesCommon;
+
+TEST(RollingWindow, KeepsTheLastWindow)
+{
+    RollingWindow window(1000, 10);
+    EXPECT_EQ(window.getWindowMs(), 1000.0);
+    window.record(50, 1.0);
+    window.record(150, 2.0);
+    LatencyHistogram h = window.latency(200);
+    EXPECT_EQ(h.count(), 2u);
+    EXPECT_EQ(h.min(), 1.0);
+    EXPECT_EQ(h.max(), 2.0);
+
+    // The first slice, [0, 100) ms, leaves the window once the slice of 1000 ms starts.
+    EXPECT_EQ(window.latency(999).count(), 2u);
+    EXPECT_EQ(window.latency(1050).count(), 1u);
+    EXPECT_EQ(window.latency(1050).min(), 2.0);
+    EXPECT_EQ(window.latency(5000).count(), 0u);
+}
+
+TEST(RollingWindow, ReusesSlots)
+{
+    RollingWindow window(1000, 10);
+    window.record(50, 1.0);
+    // Same slot, next lap: the old slice is discarded.
+    window.record(1050, 5.0);
+    LatencyHistogram h = window.latency(1050);
+    EXPECT_EQ(h.count(), 1u);
+    EXPECT_EQ(h.min(), 5.0);
+
+    // A late sample for a slice that has already been recycled is dropped.
+    window.record(60, 1.0);
+    EXPECT_EQ(window.latency(1050).count(), 1u);
+
+    // Negative times count towards the first slice.
+    RollingWindow early(1000, 10);
+    early.record(-5, 3.0);
+    EXPECT_EQ(early.latency(0).count(), 1u);
+}
+
+TEST(RollingWindow, Throughput)
+{
+    RollingWindow window(1000, 10);
+    EXPECT_EQ(window.throughput(0), 0.0);
+    // One sample every 10 ms is 100 samples/s.
+    for (int t = 0; t < 500; t += 10)
+        window.record(t, 1.0);
+    // Before a whole window has passed the rate is over the run so far.
+    EXPECT_NEAR(window.throughput(500), 100.0, 1e-9);
+    for (int t = 500; t < 1500; t += 10)
+        window.record(t, 1.0);
+    // At 1500 ms the window holds the slices from 600 ms on.
+    EXPECT_NEAR(window.throughput(1500), 100.0, 1e-9);
+}
+
+TEST(RollingWindow, ConcurrentRecords)
+{
+    RollingWindow window(1000, 4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&window, t]() {
+            for (int i = 0; i < 1000; i++)
+                window.record(i % 900, 0.5 + t);
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    EXPECT_EQ(window.latency(999).count(), 4000u);
+}
+
+TEST(RollingWindow, AtLeastOneSlice)
+{
+    RollingWindow window(100, 0);
+    window.record(10, 1.0);
+    EXPECT_EQ(window.getWindowMs(), 100.0);
+    EXPECT_EQ(window.latency(50).count(), 1u);
+    EXPECT_EQ(window.latency(150).count(), 0u);
+}
+
+TEST(MemoryGrowthDetector, SteadyGrowth)
+{
+    MemoryGrowthDetector detector(4, 100);
+    EXPECT_FALSE(detector.add(0, 0));
+    EXPECT_FALSE(detector.add(1000, 100));
+    EXPECT_FALSE(detector.add(2000, 200));
+    EXPECT_TRUE(detector.add(3000, 300));
+    EXPECT_EQ(detector.growth(), 300);
+    EXPECT_NEAR(detector.slope(), 100.0, 1e-9);
+    EXPECT_TRUE(detector.add(4000, 400));
+    EXPECT_EQ(detector.growth(), 300);
+}
+
+TEST(MemoryGrowthDetector, DipsAndPlateaus)
+{
+    MemoryGrowthDetector detector(4, 100);
+    detector.add(0, 0);
+    detector.add(1000, 100);
+    EXPECT_FALSE(detector.add(2000, 50));
+    EXPECT_FALSE(detector.add(3000, 200));
+    EXPECT_FALSE(detector.add(4000, 300));
+    // The dip has left the window: 50, 200, 300, 400.
+    EXPECT_TRUE(detector.add(5000, 400));
+
+    // A cache that grows once and levels off, wherever the step falls in the window.
+    MemoryGrowthDetector plateau(4, 100);
+    plateau.add(0, 0);
+    for (int i = 1; i <= 4; i++)
+        EXPECT_FALSE(plateau.add(i * 1000, 1000));
+    EXPECT_EQ(plateau.growth(), 0);
+    EXPECT_NEAR(plateau.slope(), 0.0, 1e-9);
+
+    MemoryGrowthDetector lateStep(4, 100);
+    for (int64_t bytes : {0, 0, 0, 1000})
+        EXPECT_FALSE(lateStep.add(0, bytes));
+    // Growth in both halves of the window, even with flat steps in between.
+    EXPECT_FALSE(lateStep.add(0, 1000));
+    EXPECT_TRUE(lateStep.add(0, 2000));
+
+    // Non-decreasing but below the minimum growth.
+    MemoryGrowthDetector small(4, 100);
+    for (int64_t bytes : {0, 0, 0, 50})
+        EXPECT_FALSE(small.add(0, bytes));
+}
+
+TEST(MemoryGrowthDetector, Limits)
+{
+    MemoryGrowthDetector detector(0, 1);
+    EXPECT_EQ(detector.getWindowSize(), 3u);
+    EXPECT_EQ(detector.growth(), 0);
+    EXPECT_EQ(detector.slope(), 0.0);
+    EXPECT_FALSE(detector.add(0, 10));
+    EXPECT_EQ(detector.slope(), 0.0);
+    EXPECT_FALSE(detector.add(250, 15));
+    EXPECT_TRUE(detector.add(500, 20));
+    EXPECT_NEAR(detector.slope(), 20.0, 1e-9);
+
+    // Samples taken at the same time have no slope.
+    MemoryGrowthDetector sameTime(3, 1);
+    sameTime.add(100, 10);
+    sameTime.add(100, 20);
+    sameTime.add(100, 30);
+    EXPECT_EQ(sameTime.slope(), 0.0);
+}
+
+TEST(SoakMonitor, ResidentSetBytes)
+{
+    EXPECT_TRUE(residentSetBytes() > 0);
+}
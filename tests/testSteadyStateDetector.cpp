@@ -0,0 +1,172 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "steadyStateDetector.h"
+#include "testing.h"
+#include <random>
+
+using namespace samplesCommon;
+
+namespace
+{
+
+//! Feed series to detector and return the index of the first sample after which it is steady, or -1.
+template <typename Series>
+int firstSteady(SteadyStateDetector& detector, int nbSamples, Series series)
+{
+    for (int i = 0; i < nbSamples; i++)
+    {
+        if (detector.add(series(i)))
+            return i;
+    }
+    return -1;
+}
+
+} // namespace
+
+TEST(SteadyStateDetector, flatSeriesIsSteadyOnceTheWindowIsFull)
+{
+    SteadyStateDetector detector(10, 0.01);
+    EXPECT_EQ(firstSteady(detector, 100, [](int) { return 2.5; }), 9);
+    EXPECT_NEAR(detector.cv(), 0.0, 1e-12);
+    EXPECT_NEAR(detector.mean(), 2.5, 1e-12);
+}
+
+TEST(SteadyStateDetector, noiseBelowAndAboveTheThreshold)
+{
+    std::mt19937 generator(1);
+    std::normal_distribution<double> quiet(10.0, 0.05);
+    std::normal_distribution<double> loud(10.0, 1.0);
+
+    SteadyStateDetector a(50, 0.02);
+    EXPECT_TRUE(firstSteady(a, 1000, [&](int) { return quiet(generator); }) == 49);
+    EXPECT_NEAR(a.cv(), 0.005, 0.002);
+
+    SteadyStateDetector b(50, 0.02);
+    EXPECT_EQ(firstSteady(b, 1000, [&](int) { return loud(generator); }), -1);
+    EXPECT_NEAR(b.cv(), 0.1, 0.03);
+}
+
+TEST(SteadyStateDetector, driftKeepsTheSeriesUnsteady)
+{
+    // A linear ramp, like a clock that keeps ramping up: every window spans ~10% of its mean.
+    SteadyStateDetector detector(20, 0.01);
+    EXPECT_EQ(firstSteady(detector, 200, [](int i) { return 100.0 + 0.5 * i; }), -1);
+}
+
+TEST(SteadyStateDetector, settlesAfterTheRamp)
+{
+    // An exponential decay towards 5 ms: steady only once the window no longer sees the ramp.
+    SteadyStateDetector detector(20, 0.01);
+    auto series = [](int i) { return 5.0 + 5.0 * std::exp(-i / 10.0); };
+    int steady = firstSteady(detector, 1000, series);
+    // Not while the window still holds the steep part of the ramp, and not long after it is over.
+    EXPECT_TRUE(steady > 40);
+    EXPECT_TRUE(steady < 60);
+    EXPECT_TRUE(series(steady) < 5.0 * 1.01);
+    EXPECT_TRUE(detector.mean() < 5.0 * 1.02);
+}
+
+TEST(SteadyStateDetector, slidingWindowForgetsOldSamples)
+{
+    SteadyStateDetector detector(4, 0.01);
+    for (double v : {1.0, 100.0, 1.0, 100.0})
+        detector.add(v);
+    EXPECT_FALSE(detector.isSteady());
+    for (int i = 0; i < 4; i++)
+        detector.add(7.0);
+    EXPECT_TRUE(detector.isSteady());
+    EXPECT_NEAR(detector.mean(), 7.0, 1e-12);
+
+    detector.reset();
+    EXPECT_FALSE(detector.isSteady());
+    EXPECT_EQ(detector.mean(), 0.0);
+}
+
+TEST(SteadyStateDetector, windowIsAtLeastTwo)
+{
+    SteadyStateDetector detector(0, 0.1);
+    EXPECT_EQ(detector.getWindowSize(), 2u);
+    EXPECT_FALSE(detector.add(1.0));
+    EXPECT_TRUE(detector.add(1.0));
+}
+
+TEST(WarmUpController, fixedWarmUpEndsAtMinimumTime)
+{
+    WarmUpController controller(200, 0, 10, 1000);
+    EXPECT_TRUE(controller.status(0) == WarmUpStatus::kRUNNING);
+    EXPECT_TRUE(controller.status(199.9) == WarmUpStatus::kRUNNING);
+    EXPECT_TRUE(controller.status(200) == WarmUpStatus::kDONE);
+}
+
+TEST(WarmUpController, steadySeriesStillRunsTheMinimumTime)
+{
+    WarmUpController controller(200, 0.01, 10, 1000);
+    for (int i = 0; i < 10; i++)
+        controller.add(3.0);
+    EXPECT_TRUE(controller.getDetector().isSteady());
+    EXPECT_TRUE(controller.status(100) == WarmUpStatus::kRUNNING);
+    EXPECT_TRUE(controller.status(200) == WarmUpStatus::kSTEADY);
+}
+
+TEST(WarmUpController, budgetExpiresWhenTheSeriesNeverConverges)
+{
+    // Alternating 1 and 3 ms has a CV of 0.5 whatever the window: one sample per simulated millisecond.
+    WarmUpController controller(200, 0.05, 20, 1000);
+    double elapsed{0};
+    WarmUpStatus status;
+    while ((status = controller.status(elapsed)) == WarmUpStatus::kRUNNING)
+    {
+        controller.add(static_cast<int>(elapsed) % 2 ? 3.0 : 1.0);
+        elapsed += 1.0;
+    }
+    EXPECT_TRUE(status == WarmUpStatus::kBUDGET_EXPIRED);
+    EXPECT_EQ(elapsed, 1000.0);
+    EXPECT_NEAR(controller.getDetector().cv(), 0.5 * std::sqrt(20.0 / 19.0), 1e-9);
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "streamRunner.h"
+#include "testing.h"
+
+using namespace samplesCommon;
+
+namespace
+{
+
+//! A stream whose inferences take a fixed host time and report a fixed device time.
+class FakeStream : public IInferenceStream
+{
+public:
+    FakeStream(float gpuMs, int failAt = -1)
+        : mGpuMs(gpuMs)
+        , mFailAt(failAt)
+    {
+    }
+
+    bool infer(float& gpuMs) override
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        gpuMs = mGpuMs;
+        return mCalls++ != mFailAt;
+    }
+
+    int getCalls() const { return mCalls; }
+
+private:
+    float mGpuMs;
+    int mFailAt;
+    std::atomic<int> mCalls{0};
+};
+
+} // namespace
+
+TEST(MultiStreamRunner, countsEveryStream)
+{
+    FakeStream a(1.0f), b(2.0f), c(3.0f);
+    MultiStreamRunner runner({&a, &b, &c});
+    EXPECT_TRUE(runner.run(10));
+    EXPECT_TRUE(runner.run(5));
+
+    const std::vector<StreamStats>& stats = runner.getStreamStats();
+    ASSERT_EQ(stats.size(), 3u);
+    for (const StreamStats& s : stats)
+    {
+        EXPECT_EQ(s.inferences, 15u);
+        EXPECT_EQ(s.host.count(), 15u);
+        EXPECT_TRUE(s.host.min() >= 0.2);
+    }
+    EXPECT_NEAR(stats[1].gpu.mean(), 2.0, 1e-9);
+
+    StreamStats total = runner.getAggregateStats();
+    EXPECT_EQ(total.inferences, 45u);
+    EXPECT_NEAR(total.gpu.mean(), 2.0, 1e-9);
+    EXPECT_NEAR(runner.getInferencesPerSecond(), 45 * 1000.0 / runner.getWallMs(), 1e-6);
+}
+
+TEST(MultiStreamRunner, skipsMissingDeviceTimes)
+{
+    FakeStream stream(-1.0f);
+    MultiStreamRunner runner({&stream});
+    EXPECT_TRUE(runner.run(4));
+    EXPECT_EQ(runner.getStreamStats()[0].gpu.count(), 0u);
+    EXPECT_EQ(runner.getStreamStats()[0].host.count(), 4u);
+}
+
+TEST(MultiStreamRunner, failureStopsAllStreams)
+{
+    FakeStream good(1.0f), bad(1.0f, 2);
+    MultiStreamRunner runner({&good, &bad});
+    EXPECT_FALSE(runner.run(1000));
+    // The failed inference is not counted, and the other stream stops long before its 1000 runs.
+    EXPECT_EQ(runner.getStreamStats()[1].inferences, 2u);
+    EXPECT_TRUE(good.getCalls() < 1000);
+}
+
+namespace
+{
+
+//! A stream that records whether each inference was prepared, and how long preparing takes.
+class StagingStream : public IInferenceStream
+{
+public:
+    void prepare() override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        mPrepared = true;
+    }
+
+    bool infer(float& gpuMs) override
+    {
+        gpuMs = -1.0f;
+        mUnprepared += !mPrepared;
+        mPrepared = false;
+        return true;
+    }
+
+    int getUnprepared() const { return mUnprepared; }
+
+private:
+    bool mPrepared{false};
+    int mUnprepared{0};
+};
+
+} // namespace
+
+TEST(MultiStreamRunner, preparesOutsideTheTimedCall)
+{
+    StagingStream stream;
+    MultiStreamRunner runner({&stream});
+    EXPECT_TRUE(runner.run(5));
+    EXPECT_EQ(stream.getUnprepared(), 0);
+    // Each prepare() sleeps 5 ms; none of it may show up in the host latency.
+    EXPECT_TRUE(runner.getStreamStats()[0].host.max() < 2.5);
+}
+
+namespace
+{
+
+//! Stands in for the current CUDA device, which every new thread starts at 0.
+thread_local int tCurrentDevice{0};
+
+//! A stream on device 1 that counts the calls made while another device is current.
+class DeviceStream : public IInferenceStream
+{
+public:
+    void bindThread() override
+    {
+        tCurrentDevice = 1;
+        ++mBinds;
+    }
+
+    void prepare() override { mWrongDevice += tCurrentDevice != 1; }
+
+    bool infer(float& gpuMs) override
+    {
+        gpuMs = -1.0f;
+        mWrongDevice += tCurrentDevice != 1;
+        return true;
+    }
+
+    int getBinds() const { return mBinds; }
+    int getWrongDevice() const { return mWrongDevice; }
+
+private:
+    std::atomic<int> mBinds{0};
+    std::atomic<int> mWrongDevice{0};
+};
+
+} // namespace
+
+TEST(MultiStreamRunner, bindsEveryWorkerThread)
+{
+    DeviceStream a, b, c;
+    MultiStreamRunner runner({&a, &b, &c});
+    EXPECT_TRUE(runner.run(5));
+    EXPECT_TRUE(runner.run(5));
+    for (DeviceStream* s : {&a, &b, &c})
+    {
+        // Each run() uses new threads, and each of them has to bind before its first call.
+        EXPECT_EQ(s->getBinds(), 2);
+        EXPECT_EQ(s->getWrongDevice(), 0);
+    }
+}
@@ -0,0 +1,259 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "tensorFile.h"
+#include "testing.h"
+#include <cfloat>
+#include <climits>
+#include <limits>
+#include <random>
+
+using namespace samplesCommon;
+
+namespace
+{
+
+//! The text the writer has to reproduce: every element streamed on its own, as the dumps used to be written.
+template <typename T, typename Print = T>
+std::string streamed(const std::vector<T>& values, size_t rowCount, int precision)
+{
+    std::ostringstream os;
+    os.precision(precision);
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        os << static_cast<Print>(values[i]);
+        const bool rowEnd = (i + 1) % rowCount == 0;
+        if (rowEnd && (rowCount != 1 || i + 1 != values.size()))
+            os << "\n";
+        else if (!rowEnd && i + 1 != values.size())
+            os << " ";
+    }
+    return os.str();
+}
+
+template <typename T>
+std::string written(const std::vector<T>& values, size_t rowCount, int precision, size_t bufferSize = 1 << 16)
+{
+    std::ostringstream os;
+    os.precision(precision);
+    {
+        TensorTextWriter writer(os, bufferSize);
+        writer.write(values.data(), values.size(), rowCount);
+    }
+    return os.str();
+}
+
+std::vector<float> interestingFloats()
+{
+    std::vector<float> v{0.0f, -0.0f, 1.0f, -1.0f, 0.5f, 0.1f, 1e-5f, 1e-4f, 9.9999e-5f, 123456.0f, 1234567.0f,
+        999999.5f, 9.9999995f, 0.00012345f, 2.5f, 0.125f, 1e10f, 1e-10f, 3.4028235e38f, FLT_MIN, std::numeric_limits<float>::denorm_min(),
+        std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+        std::numeric_limits<float>::quiet_NaN()};
+    // Decimal ties and values just around them.
+    for (float base : {0.5f, 1.5f, 2.5f, 0.15f, 1234565.0f, 0.000123455f})
+    {
+        v.push_back(base);
+        v.push_back(std::nextafter(base, 0.0f));
+        v.push_back(std::nextafter(base, 1e30f));
+    }
+    // Random bit patterns cover every exponent; random values in [-10, 10) are what activations look like.
+    std::mt19937 rng(42);
+    for (int i = 0; i < 20000; i++)
+    {
+        uint32_t bits = static_cast<uint32_t>(rng());
+        float x;
+        std::memcpy(&x, &bits, sizeof(x));
+        if (std::isfinite(x))
+            v.push_back(x);
+        v.push_back(std::uniform_real_distribution<float>(-10.0f, 10.0f)(rng));
+    }
+    return v;
+}
+
+} // namespace
+
+TEST(TensorTextWriter, FloatsMatchIostream)
+{
+    const std::vector<float> values = interestingFloats();
+    for (int precision : {0, 1, 3, 6, 9, 12})
+    {
+        const std::string expected = streamed<float, float>(values, 10, precision);
+        EXPECT_TRUE(written(values, 10, precision) == expected);
+    }
+}
+
+TEST(TensorTextWriter, IntegersMatchIostream)
+{
+    const std::vector<int32_t> ints{0, 1, -1, 9, 10, -10, 99, 100, 123456789, INT_MAX, INT_MIN};
+    EXPECT_EQ(written(ints, 4, 6), streamed(ints, 4, 6));
+    // int8_t prints as a number, not as a character.
+    const std::vector<int8_t> bytes{0, 1, -1, 127, -128, 65};
+    EXPECT_EQ(written(bytes, 3, 6), (streamed<int8_t, int>(bytes, 3, 6)));
+}
+
+TEST(TensorTextWriter, RowsAndBufferFlushes)
+{
+    const std::vector<int32_t> v{1, 2, 3, 4, 5, 6, 7};
+    EXPECT_EQ(written(v, 3, 6), std::string("1 2 3\n4 5 6\n7"));
+    EXPECT_EQ(written(std::vector<int32_t>(v.begin(), v.begin() + 6), 3, 6), std::string("1 2 3\n4 5 6\n"));
+    EXPECT_EQ(written(std::vector<int32_t>(v.begin(), v.begin() + 3), 1, 6), std::string("1\n2\n3"));
+    EXPECT_EQ(written(std::vector<int32_t>(), 3, 6), std::string(""));
+
+    // A buffer far smaller than the output is flushed many times without losing or reordering anything.
+    const std::vector<float> values = interestingFloats();
+    EXPECT_TRUE(written(values, 7, 6, 64) == written(values, 7, 6));
+
+    std::ostringstream os;
+    TensorTextWriter writer(os);
+    writer.writeString("[2, 2]\n");
+    writer.write(v.data(), 4, 2);
+    writer.flush();
+    EXPECT_EQ(os.str(), std::string("[2, 2]\n1 2\n3 4\n"));
+}
+
+TEST(TensorTextWriter, ParseRoundTrip)
+{
+    std::vector<float> values;
+    for (float x : interestingFloats())
+    {
+        if (std::isfinite(x))
+            values.push_back(x);
+    }
+    const std::string text = "[" + std::to_string(values.size()) + "]\n" + written(values, 16, 9);
+    std::vector<double> parsed;
+    std::string error;
+    ASSERT_TRUE(parseTensorText(text.data(), text.size(), parsed, error));
+    ASSERT_EQ(parsed.size(), values.size());
+    bool exact{true};
+    for (size_t i = 0; i < values.size(); i++)
+        exact = exact && static_cast<float>(parsed[i]) == values[i];
+    // 9 significant digits identify every float.
+    EXPECT_TRUE(exact);
+
+    const std::string bad = "1 2 x 3";
+    EXPECT_FALSE(parseTensorText(bad.data(), bad.size(), parsed, error));
+    EXPECT_TRUE(error.find("'x' after 2 values") != std::string::npos);
+    EXPECT_TRUE(parseTensorText("", 0, parsed, error));
+    EXPECT_TRUE(parsed.empty());
+}
+
+TEST(TensorFile, NpyHeader)
+{
+    for (const auto& shape : std::vector<std::vector<int64_t>>{{}, {5}, {2, 3, 4}, {1000000, 3, 224, 224}})
+    {
+        const std::string header = npyHeader(nvinfer1::DataType::kFLOAT, shape);
+        EXPECT_EQ(header.size() % 64, 0u);
+        EXPECT_EQ(header.back(), '\n');
+        EXPECT_TRUE(isNpyFile(header.data(), header.size()));
+
+        int64_t volume = 1;
+        for (int64_t d : shape)
+            volume *= d;
+        // Parse the header with enough room behind it for a small tensor only.
+        std::string file = header + std::string(shape.size() < 4 ? volume * 4 : 0, '\0');
+        TensorFileInfo info;
+        std::string error;
+        if (shape.size() < 4)
+        {
+            ASSERT_TRUE(parseNpyHeader(file.data(), file.size(), info, error));
+            EXPECT_TRUE(info.isNpy);
+            EXPECT_TRUE(info.shape == shape);
+            EXPECT_EQ(info.dataOffset, header.size());
+            EXPECT_EQ(info.dataSize, static_cast<size_t>(volume * 4));
+        }
+        else
+        {
+            EXPECT_FALSE(parseNpyHeader(file.data(), file.size(), info, error));
+        }
+    }
+    EXPECT_TRUE(npyHeader(nvinfer1::DataType::kINT8, {7}).find("'descr': '|i1'") != std::string::npos);
+    EXPECT_TRUE(npyHeader(nvinfer1::DataType::kHALF, {7}).find("(7,)") != std::string::npos);
+}
+
+TEST(TensorFile, WriteAndReadBack)
+{
+    samplesTest::TempDir dir;
+    std::vector<float> data(6 * 4);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<float>(i);
+    nvinfer1::Dims dims;
+    dims.nbDims = 2;
+    dims.d[0] = 2;
+    dims.d[1] = 2;
+
+    for (bool npy : {false, true})
+    {
+        const std::string name = dir.path(npy ? "t.npy" : "t.bin");
+        std::string error;
+        ASSERT_TRUE(writeTensorFile(name, data.data(), data.size() * sizeof(float), nvinfer1::DataType::kFLOAT, {6, 2, 2}, npy, error));
+        TensorDataset dataset;
+        ASSERT_TRUE(dataset.open(name, nvinfer1::DataType::kFLOAT, dims, error));
+        EXPECT_EQ(dataset.getNbSamples(), 6);
+        EXPECT_EQ(dataset.getInfo().isNpy, npy);
+        EXPECT_EQ(dataset.getNbBatches(4), 3);
+
+        // Batch 1 of 4 samples is samples 4, 5, 0, 1.
+        std::vector<float> batch(4 * 4);
+        dataset.copyBatch(1, 4, batch.data());
+        EXPECT_EQ(batch[0], 16.0f);
+        EXPECT_EQ(batch[7], 23.0f);
+        EXPECT_EQ(batch[8], 0.0f);
+        EXPECT_EQ(batch[15], 7.0f);
+    }
+
+    std::string error;
+    TensorDataset dataset;
+    ASSERT_TRUE(writeTensorFile(dir.path("i.npy"), data.data(), 16, nvinfer1::DataType::kINT32, {4}, true, error));
+    EXPECT_FALSE(dataset.open(dir.path("i.npy"), nvinfer1::DataType::kFLOAT, dims, error));
+    EXPECT_TRUE(error.find("dtype") != std::string::npos);
+    ASSERT_TRUE(writeTensorFile(dir.path("odd.bin"), data.data(), 20, nvinfer1::DataType::kFLOAT, {}, false, error));
+    EXPECT_FALSE(dataset.open(dir.path("odd.bin"), nvinfer1::DataType::kFLOAT, dims, error));
+    EXPECT_TRUE(error.find("not a multiple") != std::string::npos);
+    EXPECT_FALSE(writeTensorFile(dir.path("missing/dir.bin"), data.data(), 4, nvinfer1::DataType::kFLOAT, {}, false, error));
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include "tensorView.h"
+#include "testing.h"
+#include <numeric>
+
+using namespace samplesCommon;
+
+namespace
+{
+
+std::vector<float> iota(size_t n)
+{
+    std::vector<float> v(n);
+    std::iota(v.begin(), v.end(), 0.0f);
+    return v;
+}
+
+//! Compare every element of two 4D views through operator(), independently of the copy loops.
+template <typename A, typename B>
+bool equal4(const TensorView<A>& a, const TensorView<B>& b)
+{
+    if (!a.sameShape(b) || a.getNbDims() != 4)
+        return false;
+    for (int64_t i = 0; i < a.dim(0); i++)
+        for (int64_t j = 0; j < a.dim(1); j++)
+            for (int64_t k = 0; k < a.dim(2); k++)
+                for (int64_t l = 0; l < a.dim(3); l++)
+                {
+                    if (a(i, j, k, l) != b(i, j, k, l))
+                        return false;
+                }
+    return true;
+}
+
+} // namespace
+
+TEST(TensorView, ShapeAndStrides)
+{
+    std::vector<float> data = iota(2 * 3 * 4 * 5);
+    TensorView<float> view(data.data(), {2, 3, 4, 5});
+    EXPECT_EQ(view.getNbDims(), 4);
+    EXPECT_EQ(view.volume(), 120);
+    EXPECT_EQ(view.stride(0), 60);
+    EXPECT_EQ(view.stride(3), 1);
+    EXPECT_TRUE(view.isContiguous());
+    EXPECT_EQ(view(1, 2, 3, 4), 119.0f);
+    EXPECT_EQ(view[1][2](3, 4), 119.0f);
+    EXPECT_FALSE(TensorView<float>().valid());
+
+    TensorView<const float> readOnly = view;
+    EXPECT_TRUE(readOnly.sameShape(view));
+    EXPECT_EQ(readOnly(1, 0, 0, 0), 60.0f);
+}
+
+TEST(TensorView, SliceAndNarrow)
+{
+    std::vector<float> data = iota(4 * 3 * 2);
+    TensorView<float> view(data.data(), {4, 3, 2});
+    TensorView<float> batch = view.slice(1, 3);
+    EXPECT_EQ(batch.dim(0), 2);
+    EXPECT_TRUE(batch.isContiguous());
+    EXPECT_EQ(batch(0, 0, 0), 6.0f);
+
+    TensorView<float> channel = view.narrow(1, 2, 3);
+    EXPECT_EQ(channel.dim(1), 1);
+    EXPECT_FALSE(channel.isContiguous());
+    EXPECT_EQ(channel(3, 0, 1), 23.0f);
+    EXPECT_EQ(view.narrow(2, 1, 1).volume(), 0);
+}
+
+TEST(TensorView, PermuteCopiesHwcToChw)
+{
+    const int64_t N = 2, H = 5, W = 7, C = 3;
+    std::vector<float> nhwc = iota(N * H * W * C);
+    std::vector<float> nchw(nhwc.size(), -1);
+    TensorView<const float> src = TensorView<const float>(nhwc.data(), {N, H, W, C}).permute({0, 3, 1, 2});
+    TensorView<float> dst(nchw.data(), {N, C, H, W});
+    EXPECT_EQ(src.dim(1), C);
+    EXPECT_EQ(src.stride(1), 1);
+    ASSERT_TRUE(copyTensor(src, dst));
+    EXPECT_TRUE(equal4(src, dst));
+    EXPECT_EQ(dst(1, 2, 4, 6), nhwc[((1 * H + 4) * W + 6) * C + 2]);
+
+    // And back, through the transposed destination.
+    std::vector<float> back(nhwc.size(), -1);
+    ASSERT_TRUE(copyTensor(TensorView<const float>(dst), TensorView<float>(back.data(), {N, H, W, C}).permute({0, 3, 1, 2})));
+    EXPECT_TRUE(back == nhwc);
+}
+
+TEST(TensorView, FlipReversesChannels)
+{
+    // One RGB image in HWC layout, copied as BGR in CHW layout.
+    const int64_t H = 3, W = 4, C = 3;
+    std::vector<uint8_t> rgb(H * W * C);
+    for (size_t i = 0; i < rgb.size(); i++)
+        rgb[i] = static_cast<uint8_t>(i);
+    std::vector<uint8_t> bgr(rgb.size());
+    TensorView<const uint8_t> src
+        = TensorView<const uint8_t>(rgb.data(), {1, H, W, C}).permute({0, 3, 1, 2}).flip(1);
+    EXPECT_EQ(src.stride(1), -1);
+    TensorView<uint8_t> dst(bgr.data(), {1, C, H, W});
+    ASSERT_TRUE(copyTensor(src, dst));
+    for (int64_t h = 0; h < H; h++)
+        for (int64_t w = 0; w < W; w++)
+            for (int64_t c = 0; c < C; c++)
+                EXPECT_EQ(dst(0, c, h, w), rgb[(h * W + w) * C + (C - 1 - c)]);
+
+    // Flipping twice is the identity.
+    std::vector<float> data = iota(6);
+    TensorView<float> view(data.data(), {2, 3});
+    EXPECT_EQ(view.flip(1).flip(1)(1, 2), 5.0f);
+    EXPECT_EQ(view.flip(0)(0, 0), 3.0f);
+}
+
+TEST(TensorView, ConvertScalesAndShifts)
+{
+    // Lengths around the 16-element SSE blocks, so both the vector loop and the tail run.
+    for (int64_t n : {1, 15, 16, 37})
+    {
+        std::vector<uint8_t> bytes(n);
+        for (int64_t i = 0; i < n; i++)
+            bytes[i] = static_cast<uint8_t>(255 - i * 7 % 256);
+        std::vector<float> out(n);
+        ASSERT_TRUE(convertTensor(TensorView<const uint8_t>(bytes.data(), {n}), TensorView<float>(out.data(), {n}),
+            2.0f / 255, -1.0f));
+        for (int64_t i = 0; i < n; i++)
+            EXPECT_NEAR(out[i], bytes[i] * 2.0f / 255 - 1.0f, 1e-6);
+
+        std::vector<float> plain(n);
+        ASSERT_TRUE(copyTensor(TensorView<const uint8_t>(bytes.data(), {n}), TensorView<float>(plain.data(), {n})));
+        for (int64_t i = 0; i < n; i++)
+            EXPECT_EQ(plain[i], static_cast<float>(bytes[i]));
+
+        std::vector<float> scaled(n);
+        ASSERT_TRUE(convertTensor(TensorView<const float>(plain.data(), {n}), TensorView<float>(scaled.data(), {n}), 0.5f, 1.0f));
+        for (int64_t i = 0; i < n; i++)
+            EXPECT_EQ(scaled[i], plain[i] * 0.5f + 1.0f);
+    }
+
+    // Conversion to a narrower type truncates like a cast.
+    std::vector<float> values{1.75f, -2.5f, 300.0f};
+    std::vector<int32_t> ints(3);
+    ASSERT_TRUE(copyTensor(TensorView<const float>(values.data(), {3}), TensorView<int32_t>(ints.data(), {3})));
+    EXPECT_TRUE((ints == std::vector<int32_t>{1, -2, 300}));
+}
+
+TEST(TensorView, ShapeMismatchAndEmpty)
+{
+    std::vector<float> a(6), b(6);
+    EXPECT_FALSE(copyTensor(TensorView<const float>(a.data(), {2, 3}), TensorView<float>(b.data(), {3, 2})));
+    EXPECT_FALSE(copyTensor(TensorView<const float>(a.data(), {6}), TensorView<float>(b.data(), {2, 3})));
+    EXPECT_FALSE(copyTensor(TensorView<const float>(), TensorView<float>(b.data(), {})));
+    // Empty tensors need no data.
+    EXPECT_TRUE(copyTensor(TensorView<const float>(nullptr, {0, 3}), TensorView<float>(nullptr, {0, 3})));
+    // A scalar view has no dimensions and one element.
+    float x = 4, y = 0;
+    EXPECT_TRUE(copyTensor(TensorView<const float>(&x, {}), TensorView<float>(&y, {})));
+    EXPECT_EQ(y, 4.0f);
+}
+
+TEST(TensorView, CopyLayoutMergesAndTiles)
+{
+    std::vector<float> a(2 * 3 * 4 * 5), b(a.size());
+    TensorView<float> contiguous(a.data(), {2, 3, 4, 5});
+    detail::CopyLayout layout = detail::makeCopyLayout(contiguous, TensorView<float>(b.data(), {2, 3, 4, 5}));
+    EXPECT_EQ(layout.nbDims, 1);
+    EXPECT_EQ(layout.dims[0], 120);
+
+    // NHWC -> NCHW: the channel dimension, contiguous in the source, goes right before the last one.
+    TensorView<float> nhwc = TensorView<float>(a.data(), {2, 4, 5, 3}).permute({0, 3, 1, 2});
+    layout = detail::makeCopyLayout(nhwc, TensorView<float>(b.data(), {2, 3, 4, 5}));
+    EXPECT_EQ(layout.nbDims, 3);
+    EXPECT_EQ(layout.src[1], 1);
+    EXPECT_EQ(layout.dst[2], 1);
+}
+
+TEST(TensorView, ThreadedCopiesMatchTheSingleThreadedOne)
+{
+    // Above kPARALLEL_COPY_ELEMENTS, so nbThreads = 0 splits the copy as well.
+    const int64_t N = 3, H = 300, W = 400, C = 3;
+    ASSERT_TRUE(N * H * W * C > detail::kPARALLEL_COPY_ELEMENTS);
+    std::vector<uint8_t> nhwc(N * H * W * C);
+    for (size_t i = 0; i < nhwc.size(); i++)
+        nhwc[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+    TensorView<const uint8_t> src
+        = TensorView<const uint8_t>(nhwc.data(), {N, H, W, C}).permute({0, 3, 1, 2}).flip(1);
+
+    std::vector<float> reference(nhwc.size());
+    ASSERT_TRUE(convertTensor(src, TensorView<float>(reference.data(), {N, C, H, W}), 1.0f / 255, 0.0f, 1));
+    TensorView<const float> expected(reference.data(), {N, C, H, W});
+    for (int64_t c = 0; c < C; c++)
+        EXPECT_NEAR(expected(2, c, 299, 399), src(2, c, 299, 399) / 255.0f, 1e-6);
+
+    for (int nbThreads : {0, 2, 3, 7})
+    {
+        std::vector<float> out(nhwc.size(), -1);
+        TensorView<float> dst(out.data(), {N, C, H, W});
+        ASSERT_TRUE(convertTensor(src, dst, 1.0f / 255, 0.0f, nbThreads));
+        EXPECT_TRUE(out == reference);
+    }
+
+    // More threads than the largest dimension are capped to it.
+    std::vector<float> small = iota(6), out(6);
+    ASSERT_TRUE(copyTensor(TensorView<const float>(small.data(), {2, 3}), TensorView<float>(out.data(), {2, 3}), 16));
+    EXPECT_TRUE(out == small);
+}
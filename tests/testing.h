@@ -0,0 +1,238 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#ifndef TENSORRT_TESTING_H
+#define TENSORRT_TESTING_H
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+//!
+//! \file testing.h
+//! \brief Minimal test harness of the host tests: no dependency beyond the standard library.
+//!
+//! \details TEST(suite, name) defines a test case and registers it; EXPECT_* record a failure and carry on, ASSERT_*
+//!          also return from the test case. main() runs every test whose name contains the first argument.
+//!
+namespace samplesTest
+{
+
+struct TestCase
+{
+    std::string name;
+    void (*function)();
+};
+
+inline std::vector<TestCase>& registry()
+{
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+//! Failed expectations of the test case being run.
+inline int& failures()
+{
+    static int count{0};
+    return count;
+}
+
+struct Registrar
+{
+    Registrar(const char* name, void (*function)())
+    {
+        registry().push_back({name, function});
+    }
+};
+
+inline bool expect(bool ok, const char* file, int line, const std::string& what)
+{
+    if (!ok)
+    {
+        ++failures();
+        std::cerr << file << ":" << line << ": expected " << what << std::endl;
+    }
+    return ok;
+}
+
+template <typename A, typename B>
+bool expectEqual(const A& a, const B& b, const char* expression, const char* file, int line)
+{
+    if (a == b)
+        return true;
+    std::ostringstream what;
+    what << expression << ", got " << a << " and " << b;
+    return expect(false, file, line, what.str());
+}
+
+inline bool expectNear(double a, double b, double tolerance, const char* expression, const char* file, int line)
+{
+    if (std::fabs(a - b) <= tolerance)
+        return true;
+    std::ostringstream what;
+    what.precision(17);
+    what << expression << ", got " << a << " and " << b;
+    return expect(false, file, line, what.str());
+}
+
+//!
+//! \brief Run the registered test cases whose name contains filter, and return the exit status of the run.
+//!
+inline int runAll(const char* filter)
+{
+    int failed{0};
+    int run{0};
+    for (const TestCase& test : registry())
+    {
+        if (filter && test.name.find(filter) == std::string::npos)
+            continue;
+        ++run;
+        failures() = 0;
+        std::cout << "[ RUN      ] " << test.name << std::endl;
+        try
+        {
+            test.function();
+        }
+        catch (const std::exception& e)
+        {
+            expect(false, test.name.c_str(), 0, std::string("no exception, got ") + e.what());
+        }
+        std::cout << (failures() ? "[  FAILED  ] " : "[       OK ] ") << test.name << std::endl;
+        failed += failures() != 0;
+    }
+    std::cout << run - failed << " of " << run << " tests passed" << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//!
+//! \class TempDir
+//! \brief A directory under $TMPDIR or /tmp for the files of one test case, removed with its content at the end.
+//!
+class TempDir
+{
+public:
+    TempDir()
+    {
+        const char* tmp = getenv("TMPDIR");
+        std::string pattern = std::string(tmp && *tmp ? tmp : "/tmp") + "/trt_tests_XXXXXX";
+        std::vector<char> buffer(pattern.begin(), pattern.end());
+        buffer.push_back('\0');
+        if (mkdtemp(buffer.data()))
+            mPath = buffer.data();
+    }
+
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+
+    ~TempDir()
+    {
+        for (const std::string& file : mFiles)
+            unlink(file.c_str());
+        if (!mPath.empty())
+            rmdir(mPath.c_str());
+    }
+
+    //! Returns the path of fileName in the directory; the file is removed with the directory.
+    std::string path(const std::string& fileName)
+    {
+        mFiles.push_back(mPath + "/" + fileName);
+        return mFiles.back();
+    }
+
+    //! Write content to fileName and return its path.
+    std::string write(const std::string& fileName, const std::string& content)
+    {
+        std::string filePath = path(fileName);
+        std::ofstream(filePath, std::ios::binary) << content;
+        return filePath;
+    }
+
+private:
+    std::string mPath;
+    std::vector<std::string> mFiles;
+};
+
+//! Returns the whole content of fileName.
+inline std::string readFile(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+} // namespace samplesTest
+
+#define TEST(suite, name)                                                                                              \
+    static void suite##_##name();                                                                                      \
+    static samplesTest::Registrar suite##_##name##Registrar(#suite "." #name, suite##_##name);                         \
+    static void suite##_##name()
+
+#define EXPECT_TRUE(condition) samplesTest::expect((condition), __FILE__, __LINE__, #condition)
+#define EXPECT_FALSE(condition) samplesTest::expect(!(condition), __FILE__, __LINE__, "!(" #condition ")")
+#define EXPECT_EQ(a, b) samplesTest::expectEqual((a), (b), #a " == " #b, __FILE__, __LINE__)
+#define EXPECT_NEAR(a, b, tolerance)                                                                                   \
+    samplesTest::expectNear((a), (b), (tolerance), #a " ~= " #b, __FILE__, __LINE__)
+
+#define ASSERT_TRUE(condition)                                                                                         \
+    if (!EXPECT_TRUE(condition))                                                                                       \
+    return
+#define ASSERT_EQ(a, b)                                                                                                \
+    if (!EXPECT_EQ(a, b))                                                                                              \
+    return
+
+#endif // TENSORRT_TESTING_H
@@ -0,0 +1,186 @@
+/*
+ * Copyright 1993-2019 NVIDIA Corporation.  All rights reserved.
+ *
+ * NOTICE TO LICENSEE:
+ *
+ * This source code and/or documentation ("Licensed Deliverables") are
+ * subject to NVIDIA intellectual property rights under U.S. and
+ * international Copyright laws.
+ *
+ * These Licensed Deliverables contained herein is PROPRIETARY and
+ * CONFIDENTIAL to NVIDIA and is being provided under the terms and
+ * conditions of a form of NVIDIA software license agreement by and
+ * between NVIDIA and Licensee ("License Agreement") or electronically
+ * accepted by Licensee.  Notwithstanding any terms or conditions to
+ * the contrary in the License Agreement, reproduction or disclosure
+ * of the Licensed Deliverables to any third party without the express
+ * written consent of NVIDIA is prohibited.
+ *
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, NVIDIA MAKES NO REPRESENTATION ABOUT THE
+ * SUITABILITY OF THESE LICENSED DELIVERABLES FOR ANY PURPOSE.  IT IS
+ * PROVIDED "AS IS" WITHOUT EXPRESS OR IMPLIED WARRANTY OF ANY KIND.
+ * NVIDIA DISCLAIMS ALL WARRANTIES WITH REGARD TO THESE LICENSED
+ * DELIVERABLES, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY,
+ * NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE.
+ * NOTWITHSTANDING ANY TERMS OR CONDITIONS TO THE CONTRARY IN THE
+ * LICENSE AGREEMENT, IN NO EVENT SHALL NVIDIA BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+ * WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS
+ * ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THESE LICENSED DELIVERABLES.
+ *
+ * U.S. Government End Users.  These Licensed Deliverables are a
+ * "commercial item" as that term is defined at 48 C.F.R. 2.101 (OCT
+ * 1995), consisting of "commercial computer software" and "commercial
+ * computer software documentation" as such terms are used in 48
+ * C.F.R. 12.212 (SEPT 1995) and is provided to the U.S. Government
+ * only as a commercial end item.  Consistent with 48 C.F.R.12.212 and
+ * 48 C.F.R. 227.7202-1 through 227.7202-4 (JUNE 1995), all
+ * U.S. Government End Users acquire the Licensed Deliverables with
+ * only those rights set forth herein.
+ *
+ * Any use of the Licensed Deliverables in individual and commercial
+ * software must include, in the user documentation and internal
+ * comments to the code, the above Disclaimer and U.S. Government End
+ * Users Notice.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "benchmarkCompare.h"
+#include "logger.h"
+
+const std::string gSampleName = "TensorRT.trtcompare";
+
+struct Params
+{
+    std::string baseline{};
+    std::string candidate{};
+    float threshold{5};
+    float confidence{95};
+    int resamples{2000};
+    bool help{false};
+} gParams;
+
+static void printUsage()
+{
+    printf("\n");
+    printf("Usage: ./trtcompare <baseline> <candidate> <optional params>\n");
+    printf("\n");
+    printf("Compares two result files written by --exportTimes (JSON Lines or CSV) and fails if the candidate regressed.\n");
+    printf("Latencies (ms) are compared by p50 and p99, throughputs (per second) by their mean.\n");
+    printf("\nOptional params:\n");
+    printf("  --threshold=P           Smallest change in percent that counts as a regression (default = %.1f)\n", gParams.threshold);
+    printf("  --confidence=C          Confidence level in percent of the bootstrap intervals (default = %.1f)\n", gParams.confidence);
+    printf("  --resamples=N           Bootstrap resamples per statistic (default = %d)\n", gParams.resamples);
+    printf("  -h, --help              Print usage\n");
+    fflush(stdout);
+}
+
+bool parseArgs(int argc, char* argv[])
+{
+    std::vector<std::string> files;
+    for (int j = 1; j < argc; j++)
+    {
+        const char* arg = argv[j];
+        if (!strcmp(arg, "-h") || !strcmp(arg, "--help"))
+        {
+            gParams.help = true;
+            return true;
+        }
+        if (!strncmp(arg, "--threshold=", 12))
+        {
+            gParams.threshold = atof(arg + 12);
+        }
+        else if (!strncmp(arg, "--confidence=", 13))
+        {
+            gParams.confidence = atof(arg + 13);
+        }
+        else if (!strncmp(arg, "--resamples=", 12))
+        {
+            gParams.resamples = atoi(arg + 12);
+        }
+        else if (arg[0] == '-')
+        {
+            gLogError << "Unknown argument: " << arg << std::endl;
+            return false;
+        }
+        else
+        {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.size() != 2)
+    {
+        gLogError << "ERROR: Exactly one baseline and one candidate file must be given." << std::endl;
+        return false;
+    }
+    gParams.baseline = files[0];
+    gParams.candidate = files[1];
+    if (gParams.threshold < 0 || gParams.confidence <= 0 || gParams.confidence >= 100 || gParams.resamples < 100)
+    {
+        gLogError << "ERROR: --threshold must not be negative, --confidence must be between 0 and 100 and --resamples must be at least 100." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    auto sampleTest = gLogger.defineTest(gSampleName, argc, const_cast<const char**>(argv));
+
+    gLogger.reportTestStart(sampleTest);
+
+    if (!parseArgs(argc, argv))
+    {
+        printUsage();
+        return gLogger.reportFail(sampleTest);
+    }
+    if (gParams.help)
+    {
+        printUsage();
+        return gLogger.reportPass(sampleTest);
+    }
+
+    samplesCommon::MetricMap baseline, candidate;
+    std::string error;
+    if (!samplesCommon::loadBenchmarkResults(gParams.baseline, baseline, error)
+        || !samplesCommon::loadBenchmarkResults(gParams.candidate, candidate, error))
+    {
+        gLogError << error << std::endl;
+        return gLogger.reportFail(sampleTest);
+    }
+
+    samplesCommon::CompareOptions options;
+    options.threshold = gParams.threshold / 100.0;
+    options.confidence = gParams.confidence / 100.0;
+    options.resamples = gParams.resamples;
+    std::vector<samplesCommon::MetricComparison> comparisons
+        = samplesCommon::compareBenchmarkResults(baseline, candidate, options);
+    if (comparisons.empty())
+    {
+        gLogError << "The files have no latency or throughput metrics in common." << std::endl;
+        return gLogger.reportFail(sampleTest);
+    }
+
+    gLogInfo << gParams.candidate << " against " << gParams.baseline << " (threshold " << gParams.threshold << "%, "
+             << gParams.confidence << "% intervals):" << std::endl;
+    samplesCommon::writeComparisonTable(gLogInfo, comparisons);
+
+    using Verdict = samplesCommon::MetricComparison::Verdict;
+    const int regressions = samplesCommon::countVerdicts(comparisons, Verdict::kREGRESSED);
+    const int improvements = samplesCommon::countVerdicts(comparisons, Verdict::kIMPROVED);
+    gLogInfo << comparisons.size() << " statistics compared: " << regressions << " regressed, " << improvements
+             << " improved." << std::endl;
+    if (regressions)
+    {
+        gLogError << regressions << " statistics regressed by more than " << gParams.threshold << "%." << std::endl;
+    }
+    return gLogger.reportTest(sampleTest, regressions == 0);
+}
@@ -48,19 +48,24 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cuda_runtime_api.h>
 #include <fstream>
 #include <functional>
+#include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <map>
 #include <random>
 #include <sstream>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <thread>
 #include <time.h>
+#include <unistd.h>
 #include <vector>
 
 #include "NvOnnxParser.h"
@@ -69,9 +74,24 @@
 #include "NvInferPlugin.h"
 #include "NvUffParser.h"
 
+#include "batchSweep.h"
+#include "benchmarkResults.h"
 #include "buffers.h"
+#include "calibrationReader.h"
 #include "common.h"
+#include "hashUtils.h"
+#include "hostTimers.h"
+#include "latencyHistogram.h"
+#include "loadGenerator.h"
 #include "logger.h"
+#include "mappedFile.h"
+#include "multiProcess.h"
+#include "outputValidator.h"
+#include "runManifest.h"
+#include "soakMonitor.h"
+#include "steadyStateDetector.h"
+#include "streamRunner.h"
+#include "tensorFile.h"
 
 
 using namespace nvinfer1;
@@ -88,17 +108,51 @@ struct Params
     std::string engine{};
     std::string saveEngine{};
     std::string loadEngine{};
+    std::string engineCache{};
+    std::string mapHint{"none"};
     std::string calibrationCache{"CalibrationTable"};
+    std::string calibData{};
     std::string uffFile{};
     std::string onnxModelFile{};
+    std::string exportTimes{};
+    std::string exportProfile{};
     std::vector<std::string> inputs{};
     std::vector<std::string> outputs{};
     std::vector<std::pair<std::string, Dims3>> uffInputs{};
+    std::vector<std::pair<std::string, std::string>> loadInputs{};
+    std::vector<std::pair<std::string, std::string>> refOutputs{};
+    std::vector<double> qps{};
+    std::vector<int> batchSweep{};
+    std::string exportSweep{};
+    std::string manifest{};
+    std::string arrival{"poisson"};
+    std::string hostMemory{"pageable"};
+    std::string dumpFormat{"text"};
+    std::string dumpDir{};
     int device{0};
     int batchSize{1};
     int workspaceSize{16};
     int iterations{10};
     int avgRuns{10};
+    int streams{1};
+    int queueDepth{64};
+    int engineCacheSize{4096};
+    int warmUp{200};
+    int calibBatch{0};
+    int calibBatches{0};
+    float steadyState{0};
+    float absTol{1e-5f};
+    float relTol{1e-3f};
+    int ulpTol{0};
+    int maxMismatches{10};
+    int processes{1};
+    int duration{0};
+    int reportInterval{10};
+    int soakWindow{60};
+    int leakWindow{6};
+    int leakThreshold{16};
+    int steadyWindow{50};
+    int steadyBudget{10000};
     int useDLACore{-1};
     bool safeMode{false};
     bool fp16{false};
@@ -108,9 +162,15 @@ struct Params
     float pct{99};
     bool useSpinWait{false};
     bool dumpOutput{false};
+    bool endToEnd{false};
+    bool pinned{false};
+    bool hostOverhead{false};
     bool help{false};
 } gParams;
 
+//! Structured copy of the reported timings, only allocated when --exportTimes is given.
+std::unique_ptr<samplesCommon::BenchmarkResults> gResults;
+
 inline int volume(Dims dims)
 {
     return std::accumulate(dims.d, dims.d + dims.nbDims, 1, std::multiplies<int>());
@@ -118,6 +178,9 @@ inline int volume(Dims dims)
 
 std::map<std::string, Dims3> gInputDimensions;
 
+//! Memory-mapped input data given with --loadInputs, by binding index. Shared read-only by all streams.
+std::map<int, std::unique_ptr<samplesCommon::TensorDataset>> gInputDatasets;
+
 std::vector<std::string> split(const std::string& s, char delim)
 {
     std::vector<std::string> res;
@@ -131,16 +194,19 @@ std::vector<std::string> split(const std::string& s, char delim)
     return res;
 }
 
-float percentile(float percentage, std::vector<float>& times)
+//!
+//! \brief Read the calibration cache file into cache and return it, or nullptr if there is none.
+//!
+const void* readCalibrationCacheFile(const std::string& cacheFile, std::vector<char>& cache, size_t& length)
 {
-    int all = static_cast<int>(times.size());
-    int exclude = static_cast<int>((1 - percentage / 100) * all);
-    if (0 <= exclude && exclude <= all)
-    {
-        std::sort(times.begin(), times.end());
-        return times[all == exclude ? 0 : all - 1 - exclude];
-    }
-    return std::numeric_limits<float>::infinity();
+    cache.clear();
+    std::ifstream input(cacheFile, std::ios::binary);
+    input >> std::noskipws;
+    if (input.good())
+        std::copy(std::istream_iterator<char>(input), std::istream_iterator<char>(), std::back_inserter(cache));
+
+    length = cache.size();
+    return length ? &cache[0] : nullptr;
 }
 
 class RndInt8Calibrator : public IInt8EntropyCalibrator2
@@ -194,16 +260,10 @@ public:
 
     const void* readCalibrationCache(size_t& length) override
     {
-        mCalibrationCache.clear();
-        std::ifstream input(mCacheFile, std::ios::binary);
-        input >> std::noskipws;
-        if (input.good())
-            std::copy(std::istream_iterator<char>(input), std::istream_iterator<char>(), std::back_inserter(mCalibrationCache));
-
-        length = mCalibrationCache.size();
-        return length ? &mCalibrationCache[0] : nullptr;
+        return readCalibrationCacheFile(mCacheFile, mCalibrationCache, length);
     }
 
+    //! Scales computed from random data are meaningless, so they are never written over a real cache.
     virtual void writeCalibrationCache(const void*, size_t) override
     {
     }
@@ -216,7 +276,124 @@ private:
     std::vector<char> mCalibrationCache;
 };
 
-void configureBuilder(IBuilder* builder, RndInt8Calibrator& calibrator)
+//!
+//! \brief Calibrates on real data given with --calibData, streamed from disk by a CalibrationBatchReader.
+//!
+//! \details The resulting scales are written back to the calibration cache, so later builds skip calibration.
+//!
+class DataInt8Calibrator : public IInt8EntropyCalibrator2
+{
+public:
+    DataInt8Calibrator(std::unique_ptr<samplesCommon::CalibrationBatchReader> reader, std::string cacheFile)
+        : mReader(std::move(reader))
+        , mCacheFile(cacheFile)
+    {
+        const auto& inputs = mReader->getInputs();
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            void* data;
+            CHECK(cudaMalloc(&data, mReader->getBatchBytes(static_cast<int>(i))));
+            mInputDeviceBuffers.insert(std::make_pair(inputs[i].name, data));
+        }
+    }
+
+    ~DataInt8Calibrator()
+    {
+        for (auto& elem : mInputDeviceBuffers)
+            CHECK(cudaFree(elem.second));
+    }
+
+    int getBatchSize() const override
+    {
+        return mReader->getBatchSize();
+    }
+
+    bool getBatch(void* bindings[], const char* names[], int nbBindings) override
+    {
+        if (!mReader->next(mBatch))
+        {
+            std::string error = mReader->getError();
+            if (!error.empty())
+                gLogError << "--calibData: " << error << std::endl;
+            gLogInfo << "Calibrated on " << mReader->getNbBatchesRead() << " batches of " << mReader->getBatchSize() << std::endl;
+            return false;
+        }
+
+        const auto& inputs = mReader->getInputs();
+        for (size_t i = 0; i < inputs.size(); i++)
+            CHECK(cudaMemcpy(mInputDeviceBuffers[inputs[i].name], mBatch[i].data(), mBatch[i].size(), cudaMemcpyHostToDevice));
+        for (int i = 0; i < nbBindings; ++i)
+            bindings[i] = mInputDeviceBuffers[names[i]];
+        return true;
+    }
+
+    const void* readCalibrationCache(size_t& length) override
+    {
+        return readCalibrationCacheFile(mCacheFile, mCalibrationCache, length);
+    }
+
+    void writeCalibrationCache(const void* cache, size_t length) override
+    {
+        std::ofstream output(mCacheFile, std::ios::binary);
+        output.write(reinterpret_cast<const char*>(cache), length);
+        if (!output)
+            gLogWarning << "Could not write the calibration cache to " << mCacheFile << std::endl;
+        else
+            gLogInfo << "Calibration cache has been written to " << mCacheFile << std::endl;
+    }
+
+private:
+    std::unique_ptr<samplesCommon::CalibrationBatchReader> mReader;
+    samplesCommon::CalibrationBatchReader::Batch mBatch;
+    std::string mCacheFile;
+    std::map<std::string, void*> mInputDeviceBuffers;
+    std::vector<char> mCalibrationCache;
+};
+
+//!
+//! \brief Create the INT8 calibrator of the network inputs in gInputDimensions; none unless --int8 is given.
+//!
+//! \details With --calibData, a single-input network reads every file of the given directory or list. A network with
+//!          several inputs reads the files of each input from the subdirectory or list named after it.
+//!
+bool createCalibrator(std::unique_ptr<IInt8Calibrator>& calibrator)
+{
+    calibrator.reset();
+    if (!gParams.int8)
+    {
+        return true;
+    }
+    if (gParams.calibData.empty())
+    {
+        calibrator.reset(new RndInt8Calibrator(1, gParams.calibrationCache));
+        return true;
+    }
+
+    std::vector<samplesCommon::CalibrationInput> inputs;
+    for (const auto& elem : gInputDimensions)
+    {
+        samplesCommon::CalibrationInput input;
+        input.name = elem.first;
+        input.dims = elem.second;
+        std::string path = gInputDimensions.size() == 1 ? gParams.calibData : gParams.calibData + "/" + elem.first;
+        std::string error;
+        if (!samplesCommon::listCalibrationFiles(path, input.files, error))
+        {
+            gLogError << "--calibData: " << error << std::endl;
+            return false;
+        }
+        gLogInfo << "Calibration input \"" << input.name << "\": " << input.files.size() << " files in " << path << std::endl;
+        inputs.push_back(input);
+    }
+
+    int batchSize = gParams.calibBatch > 0 ? gParams.calibBatch : gParams.batchSize;
+    std::unique_ptr<samplesCommon::CalibrationBatchReader> reader{
+        new samplesCommon::CalibrationBatchReader(inputs, batchSize, gParams.calibBatches)};
+    calibrator.reset(new DataInt8Calibrator(std::move(reader), gParams.calibrationCache));
+    return true;
+}
+
+void configureBuilder(IBuilder* builder, IInt8Calibrator* calibrator)
 {
     builder->setMaxBatchSize(gParams.batchSize);
     builder->setMaxWorkspaceSize(static_cast<size_t>(gParams.workspaceSize) << 20);
@@ -225,7 +402,7 @@ void configureBuilder(IBuilder* builder, RndInt8Calibrator& calibrator)
     if (gParams.int8)
     {
         builder->setInt8Mode(true);
-        builder->setInt8Calibrator(&calibrator);
+        builder->setInt8Calibrator(calibrator);
     }
 
     if (gParams.safeMode)
@@ -283,8 +460,12 @@ ICudaEngine* caffeToTRTModel()
     }
 
     // Build the engine
-    RndInt8Calibrator calibrator(1, gParams.calibrationCache);
-    configureBuilder(builder, calibrator);
+    std::unique_ptr<IInt8Calibrator> calibrator;
+    if (!createCalibrator(calibrator))
+    {
+        return nullptr;
+    }
+    configureBuilder(builder, calibrator.get());
 
     samplesCommon::enableDLA(builder, gParams.useDLACore, gParams.allowGPUFallback);
 
@@ -344,8 +525,12 @@ ICudaEngine* uffToTRTModel()
     }
 
     // Build the engine
-    RndInt8Calibrator calibrator(1, gParams.calibrationCache);
-    configureBuilder(builder, calibrator);
+    std::unique_ptr<IInt8Calibrator> calibrator;
+    if (!createCalibrator(calibrator))
+    {
+        return nullptr;
+    }
+    configureBuilder(builder, calibrator.get());
 
     samplesCommon::enableDLA(builder, gParams.useDLACore);
 
@@ -384,8 +569,12 @@ ICudaEngine* onnxToTRTModel()
     }
 
     // Build the engine
-    RndInt8Calibrator calibrator(1, gParams.calibrationCache);
-    configureBuilder(builder, calibrator);
+    std::unique_ptr<IInt8Calibrator> calibrator;
+    if (!createCalibrator(calibrator))
+    {
+        return nullptr;
+    }
+    configureBuilder(builder, calibrator.get());
 
     samplesCommon::enableDLA(builder, gParams.useDLACore);
 
@@ -402,364 +591,2067 @@ ICudaEngine* onnxToTRTModel()
     return engine;
 }
 
-void doInference(ICudaEngine& engine)
+static samplesCommon::HostMemoryType hostMemoryType()
+{
+    using samplesCommon::HostMemoryType;
+    return gParams.pinned || gParams.hostMemory == "pinned" ? HostMemoryType::kPINNED
+        : gParams.hostMemory == "aligned" ? HostMemoryType::kALIGNED
+        : gParams.hostMemory == "hugepage" ? HostMemoryType::kHUGE_PAGE
+        : gParams.hostMemory == "pooled" ? HostMemoryType::kPOOLED : HostMemoryType::kPAGEABLE;
+}
+
+//!
+//! \brief One execution context together with its own buffers, CUDA stream and timing events.
+//!
+class TrtInferenceStream : public samplesCommon::IInferenceStream
 {
-    IExecutionContext* context = engine.createExecutionContext();
+public:
+    TrtInferenceStream(ICudaEngine& engine)
+        : mContext(engine.createExecutionContext())
+    {
+        // Use an aliasing shared_ptr since we don't want engine to be deleted when bufferManager goes out of scope.
+        std::shared_ptr<ICudaEngine> emptyPtr{};
+        std::shared_ptr<ICudaEngine> aliasPtr(emptyPtr, &engine);
+        // Host buffers are only touched by --endToEnd, --loadInputs, validation and dumps, so allocate them on demand,
+        // except when the timed loop copies them, where a first-use allocation would skew the first iteration.
+        mBufferManager.reset(new samplesCommon::BufferManager(aliasPtr, gParams.batchSize, hostMemoryType(), nullptr,
+                                                              samplesCommon::AllocationPolicy::kLAZY));
+        if (gParams.endToEnd)
+        {
+            mBufferManager->allocate();
+        }
+        mBindings = mBufferManager->getDeviceBindings();
 
-    // Use an aliasing shared_ptr since we don't want engine to be deleted when bufferManager goes out of scope.
-    std::shared_ptr<ICudaEngine> emptyPtr{};
-    std::shared_ptr<ICudaEngine> aliasPtr(emptyPtr, &engine);
-    samplesCommon::BufferManager bufferManager(aliasPtr, gParams.batchSize);
-    std::vector<void*> buffers = bufferManager.getDeviceBindings();
+        CHECK(cudaStreamCreate(&mStream));
+        unsigned int cudaEventFlags = gParams.useSpinWait ? cudaEventDefault : cudaEventBlockingSync;
+        CHECK(cudaEventCreateWithFlags(&mStart, cudaEventFlags));
+        CHECK(cudaEventCreateWithFlags(&mEnd, cudaEventFlags));
+        CHECK(cudaEventCreateWithFlags(&mH2DStart, cudaEventFlags));
+        CHECK(cudaEventCreateWithFlags(&mD2HEnd, cudaEventFlags));
 
-    cudaStream_t stream;
-    CHECK(cudaStreamCreate(&stream));
-    cudaEvent_t start, end;
-    unsigned int cudaEventFlags = gParams.useSpinWait ? cudaEventDefault : cudaEventBlockingSync;
-    CHECK(cudaEventCreateWithFlags(&start, cudaEventFlags));
-    CHECK(cudaEventCreateWithFlags(&end, cudaEventFlags));
+        // Inputs that never change between iterations are uploaded once; the others rotate through their dataset.
+        for (const auto& input : gInputDatasets)
+        {
+            mRotateInputs = mRotateInputs || input.second->getNbBatches(gParams.batchSize) > 1;
+        }
+        if (!gInputDatasets.empty() && !mRotateInputs)
+        {
+            loadInputs();
+            mBufferManager->copyInputToDevice();
+        }
+    }
 
-    std::vector<float> times(gParams.avgRuns);
-    for (int j = 0; j < gParams.iterations; j++)
+    ~TrtInferenceStream()
     {
-        float totalGpu{0}, totalHost{0}; // GPU and Host timers
-        for (int i = 0; i < gParams.avgRuns; i++)
-        {
-            auto tStart = std::chrono::high_resolution_clock::now();
-            cudaEventRecord(start, stream);
-            context->enqueue(gParams.batchSize, &buffers[0], stream, nullptr);
-            cudaEventRecord(end, stream);
-            cudaEventSynchronize(end);
+        cudaStreamDestroy(mStream);
+        cudaEventDestroy(mStart);
+        cudaEventDestroy(mEnd);
+        cudaEventDestroy(mH2DStart);
+        cudaEventDestroy(mD2HEnd);
+        mContext->destroy();
+    }
 
-            auto tEnd = std::chrono::high_resolution_clock::now();
-            totalHost += std::chrono::duration<float, std::milli>(tEnd - tStart).count();
-            float ms;
-            cudaEventElapsedTime(&ms, start, end);
-            times[i] = ms;
-            totalGpu += ms;
+    //!
+    //! \brief Make --device current on the calling thread, which the runners call on each of their threads.
+    //!
+    void bindThread() override
+    {
+        CHECK(cudaSetDevice(gParams.device));
+    }
+
+    //!
+    //! \brief When --loadInputs rotates through its data, copy the next batch into the host buffers and, unless the
+    //!        copy to the device is timed by --endToEnd, start that copy too.
+    //!
+    //! \details The callers of infer() that time it call this first, so that staging the inputs adds neither to the
+    //!          host latency nor to the throughput they report.
+    //!
+    void prepare() override
+    {
+        if (!mRotateInputs || mPrepared)
+        {
+            return;
         }
-        totalGpu /= gParams.avgRuns;
-        totalHost /= gParams.avgRuns;
-        gLogInfo << "Average over " << gParams.avgRuns << " runs is " << totalGpu << " ms (host walltime is " << totalHost
-                 << " ms, " << static_cast<int>(gParams.pct) << "\% percentile time is " << percentile(gParams.pct, times) << ")." << std::endl;
+        loadInputs();
+        if (!gParams.endToEnd)
+        {
+            mBufferManager->copyInputToDeviceAsync(mProfiling ? 0 : mStream);
+        }
+        mPrepared = true;
     }
 
-    if (gParams.dumpOutput)
+    //!
+    //! \brief Run one inference and return the GPU compute time in gpuMs.
+    //!
+    //! \details With --endToEnd, the inputs are copied to the device before and the outputs back to the host after
+    //!          the compute, all on the same stream, and the time of each phase is recorded in getPhaseStats().
+    //!          Inputs that were not staged by prepare() are staged here.
+    //!
+    bool infer(float& gpuMs) override
     {
-        bufferManager.copyOutputToHost();
-        int nbBindings = engine.getNbBindings();
-        for (int i = 0; i < nbBindings; i++)
+        // Per-layer times are only reported by the synchronous execute(), which runs on the default stream.
+        cudaStream_t stream = mProfiling ? 0 : mStream;
+        prepare();
+        mPrepared = false;
+        if (gParams.endToEnd)
         {
-            if (!engine.bindingIsInput(i))
-            {
-                const char* tensorName = engine.getBindingName(i);
-                gLogInfo << "Dumping output tensor " << tensorName << ":" << std::endl;
-                bufferManager.dumpBuffer(gLogInfo, tensorName);
-            }
+            recordEvent(mH2DStart, stream);
+            mBufferManager->copyInputToDeviceAsync(stream);
         }
+        recordEvent(mStart, stream);
+        bool status;
+        {
+            samplesCommon::ScopedTimer timer(hostTimer(mHostOverhead.enqueue));
+            status = mProfiling ? mContext->execute(gParams.batchSize, &mBindings[0])
+                                : mContext->enqueue(gParams.batchSize, &mBindings[0], mStream, nullptr);
+        }
+        recordEvent(mEnd, stream);
+        if (gParams.endToEnd)
+        {
+            mBufferManager->copyOutputToHostAsync(stream);
+            recordEvent(mD2HEnd, stream);
+            synchronize(mD2HEnd);
+
+            float h2dMs, d2hMs, totalMs;
+            cudaEventElapsedTime(&h2dMs, mH2DStart, mStart);
+            cudaEventElapsedTime(&gpuMs, mStart, mEnd);
+            cudaEventElapsedTime(&d2hMs, mEnd, mD2HEnd);
+            cudaEventElapsedTime(&totalMs, mH2DStart, mD2HEnd);
+            mPhaseStats.h2d.record(h2dMs);
+            mPhaseStats.compute.record(gpuMs);
+            mPhaseStats.d2h.record(d2hMs);
+            mPhaseStats.total.record(totalMs);
+            return status;
+        }
+        synchronize(mEnd);
+        cudaEventElapsedTime(&gpuMs, mStart, mEnd);
+        return status;
     }
 
-    cudaStreamDestroy(stream);
-    cudaEventDestroy(start);
-    cudaEventDestroy(end);
-    context->destroy();
-}
+    //! Per-phase GPU times of an --endToEnd inference.
+    struct PhaseStats
+    {
+        samplesCommon::LatencyHistogram h2d, compute, d2h, total;
+    };
 
-static void printUsage()
-{
-    printf("\n");
-    printf("Mandatory params:\n");
-    printf("  --deploy=<file>          Caffe deploy file\n");
-    printf("  OR --uff=<file>          UFF file\n");
-    printf("  OR --onnx=<file>         ONNX Model file\n");
-    printf("  OR --loadEngine=<file>   Load a saved engine\n");
+    const PhaseStats& getPhaseStats() const { return mPhaseStats; }
 
-    printf("\nMandatory params for UFF:\n");
-    printf("  --uffInput=<name>,C,H,W Input blob name and its dimensions for UFF parser (can be specified multiple times)\n");
-    printf("  --output=<name>      Output blob name (can be specified multiple times)\n");
+    //! Host time spent in each CUDA or TensorRT call of an inference, recorded with --hostOverhead.
+    struct HostOverheadStats
+    {
+        samplesCommon::LatencyHistogram enqueue, eventRecord, sync;
+    };
 
-    printf("\nMandatory params for Caffe:\n");
-    printf("  --output=<name>      Output blob name (can be specified multiple times)\n");
+    const HostOverheadStats& getHostOverhead() const { return mHostOverhead; }
 
-    printf("\nOptional params:\n");
-    printf("  --model=<file>          Caffe model file (default = no model, random weights used)\n");
-    printf("  --batch=N               Set batch size (default = %d)\n", gParams.batchSize);
-    printf("  --device=N              Set cuda device to N (default = %d)\n", gParams.device);
-    printf("  --iterations=N          Run N iterations (default = %d)\n", gParams.iterations);
-    printf("  --avgRuns=N             Set avgRuns to N - perf is measured as an average of avgRuns (default=%d)\n", gParams.avgRuns);
-    printf("  --percentile=P          For each iteration, report the percentile time at P percentage (0<=P<=100, with 0 representing min, and 100 representing max; default = %.1f%%)\n", gParams.pct);
-    printf("  --workspace=N           Set workspace size in megabytes (default = %d)\n", gParams.workspaceSize);
-    printf("  --safe                  Only test the functionality available in safety restricted flows.\n");
-    printf("  --fp16                  Run in fp16 mode (default = false). Permits 16-bit kernels\n");
-    printf("  --int8                  Run in int8 mode (default = false). Currently no support for ONNX model.\n");
-    printf("  --verbose               Use verbose logging (default = false)\n");
-    printf("  --saveEngine=<file>     Save a serialized engine to file.\n");
-    printf("  --loadEngine=<file>     Load a serialized engine from file.\n");
-    printf("  --calib=<file>          Read INT8 calibration cache file.  Currently no support for ONNX model.\n");
-    printf("  --useDLACore=N          Specify a DLA engine for layers that support DLA. Value can range from 0 to n-1, where n is the number of DLA engines on the platform.\n");
-    printf("  --allowGPUFallback      If --useDLACore flag is present and if a layer can't run on DLA, then run on GPU. \n");
-    printf("  --useSpinWait           Actively wait for work completion. This option may decrease multi-process synchronization time at the cost of additional CPU usage. (default = false)\n");
-    printf("  --dumpOutput            Dump outputs at end of test. \n");
-    printf("  -h, --help              Print usage\n");
-    fflush(stdout);
-}
+    //! Discard the phase and host overhead statistics, e.g. those of the warm-up.
+    void resetStats()
+    {
+        mPhaseStats = PhaseStats();
+        mHostOverhead = HostOverheadStats();
+    }
 
-bool parseString(const char* arg, const char* name, std::string& value)
-{
-    size_t n = strlen(name);
-    bool match = arg[0] == '-' && arg[1] == '-' && !strncmp(arg + 2, name, n) && arg[n + 2] == '=';
-    if (match)
+    samplesCommon::BufferManager& getBufferManager() { return *mBufferManager; }
+
+    //!
+    //! \brief Run one synchronous inference on the first batch of the --loadInputs data and copy its outputs to the
+    //!        host, so that they can be checked against references of that batch.
+    //!
+    bool inferFirstBatch()
     {
-        value = arg + n + 3;
-        gLogInfo << name << ": " << value << std::endl;
+        mBatchIndex = 0;
+        mPrepared = false;
+        if (!gInputDatasets.empty())
+        {
+            loadInputs();
+            mBufferManager->copyInputToDevice();
+        }
+        bool status = mContext->execute(gParams.batchSize, &mBindings[0]);
+        mBufferManager->copyOutputToHost();
+        return status;
     }
-    return match;
-}
 
-template<typename T>
-bool parseAtoi(const char* arg, const char* name, T& value)
-{
-    size_t n = strlen(name);
-    bool match = arg[0] == '-' && arg[1] == '-' && !strncmp(arg + 2, name, n) && arg[n + 2] == '=';
-    if (match)
+    //! Attach a per-layer profiler, or detach it with nullptr.
+    void setProfiler(IProfiler* profiler)
     {
-        value = static_cast<T>(atoi(arg + n + 3));
-        gLogInfo << name << ": " << value << std::endl;
+        mContext->setProfiler(profiler);
+        mProfiling = profiler != nullptr;
     }
-    return match;
-}
 
-bool parseInt(const char* arg, const char* name, int& value)
-{
-    return parseAtoi<int>(arg, name, value);
-}
+private:
+    samplesCommon::LatencyHistogram* hostTimer(samplesCommon::LatencyHistogram& histogram)
+    {
+        return gParams.hostOverhead ? &histogram : nullptr;
+    }
 
-bool parseUnsigned(const char* arg, const char* name, unsigned int& value)
-{
-    return parseAtoi<unsigned int>(arg, name, value);
-}
+    void recordEvent(cudaEvent_t event, cudaStream_t stream)
+    {
+        samplesCommon::ScopedTimer timer(hostTimer(mHostOverhead.eventRecord));
+        cudaEventRecord(event, stream);
+    }
 
-// parse a boolean option of the form --name, or optionally, -letter.
-bool parseBool(const char* arg, const char* name, bool& value, char letter = '\0')
-{
-    bool match = arg[0] == '-' && ((arg[1] == '-' && !strcmp(arg + 2, name)) || (letter && arg[1] == letter && !arg[2]));
-    if (match)
+    void synchronize(cudaEvent_t event)
     {
-        // Always report the long form of the option.
-        gLogInfo << name << std::endl;
-        value = true;
+        samplesCommon::ScopedTimer timer(hostTimer(mHostOverhead.sync));
+        cudaEventSynchronize(event);
     }
-    return match;
-}
 
-bool parseFloat(const char* arg, const char* name, float& value)
-{
-    size_t n = strlen(name);
-    bool match = arg[0] == '-' && arg[1] == '-' && !strncmp(arg + 2, name, n) && arg[n + 2] == '=';
-    if (match)
+    //! Copy the next batch of every --loadInputs dataset from its mapping into the host buffers.
+    void loadInputs()
     {
-        value = atof(arg + n + 3);
-        gLogInfo << name << ": " << value << std::endl;
+        const ICudaEngine& engine = mContext->getEngine();
+        for (const auto& input : gInputDatasets)
+        {
+            void* host = mBufferManager->getHostBuffer(engine.getBindingName(input.first));
+            input.second->copyBatch(mBatchIndex, gParams.batchSize, host);
+        }
+        ++mBatchIndex;
     }
-    return match;
-}
 
-bool validateArgs()
+    IExecutionContext* mContext;
+    std::unique_ptr<samplesCommon::BufferManager> mBufferManager;
+    std::vector<void*> mBindings;
+    cudaStream_t mStream;
+    cudaEvent_t mStart, mEnd;
+    cudaEvent_t mH2DStart, mD2HEnd;
+    PhaseStats mPhaseStats;
+    HostOverheadStats mHostOverhead;
+    bool mRotateInputs{false};
+    bool mPrepared{false}; //!< Whether prepare() has staged the inputs of the next infer()
+    bool mProfiling{false};
+    int64_t mBatchIndex{0};
+};
+
+//!
+//! \brief Run untimed inferences until --warmUp milliseconds have passed and, if --steadyState is set, until the
+//!        GPU time has settled or --steadyBudget milliseconds have passed.
+//!
+bool warmUp(samplesCommon::IInferenceStream& stream)
 {
-    // UFF and Caffe files require output nodes to be specified.
-    if ((!gParams.uffFile.empty() || !gParams.deployFile.empty()) && gParams.outputs.empty())
+    samplesCommon::WarmUpController controller(gParams.warmUp, gParams.steadyState, gParams.steadyWindow, gParams.steadyBudget);
+    auto tStart = std::chrono::high_resolution_clock::now();
+    auto elapsedMs = [&tStart]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+    };
+    int runs{0};
+    samplesCommon::WarmUpStatus status;
+    while ((status = controller.status(elapsedMs())) == samplesCommon::WarmUpStatus::kRUNNING)
     {
-        gLogError << "ERROR: At least one output must be specified." << std::endl;
-        return false;
+        float ms;
+        if (!stream.infer(ms))
+        {
+            gLogError << "Inference failed during warm-up" << std::endl;
+            return false;
+        }
+        controller.add(ms);
+        ++runs;
     }
-    if (!gParams.uffFile.empty() && gParams.uffInputs.empty())
+
+    const double cv = controller.getDetector().cv();
+    if (status == samplesCommon::WarmUpStatus::kSTEADY)
     {
-        gLogError << "ERROR: At least one UFF input must be specified to run UFF models." << std::endl;
-        return false;
+        gLogInfo << "Reached steady state after " << runs << " warm-up runs (window CV = " << cv << ")." << std::endl;
     }
-    if (!gParams.loadEngine.empty() && !gParams.saveEngine.empty())
+    else if (status == samplesCommon::WarmUpStatus::kBUDGET_EXPIRED)
     {
-        gLogError << "ERROR: --saveEngine and --loadEngine cannot be specified at the same time." << std::endl;
-        return false;
+        gLogWarning << "No steady state within " << gParams.steadyBudget << " ms (" << runs << " runs, window CV = "
+                    << cv << "); measuring anyway." << std::endl;
+    }
+    else
+    {
+        gLogVerbose << "Warm-up: " << runs << " runs." << std::endl;
     }
     return true;
 }
 
-bool parseArgs(int argc, char* argv[])
+//!
+//! \brief Latency and throughput of a closed-loop run, as needed by --batchSweep.
+//!
+struct RunSummary
 {
-    if (argc < 2)
-    {
-        printUsage();
-        return false;
-    }
+    samplesCommon::LatencyHistogram latency; //!< Host walltime of each inference
+    double inferencesPerSecond{0};
+};
 
-    for (int j = 1; j < argc; j++)
+bool runSingleStream(TrtInferenceStream& stream, RunSummary* summary)
+{
+    // Whole-run histograms for the final report, and a per-iteration one for the running percentile.
+    samplesCommon::LatencyHistogram gpuTimes, hostTimes, iterationTimes;
+    for (int j = 0; j < gParams.iterations; j++)
     {
-        if (parseString(argv[j], "model", gParams.modelFile)
-            || parseString(argv[j], "deploy", gParams.deployFile))
+        float totalGpu{0}, totalHost{0}; // GPU and Host timers
+        iterationTimes.reset();
+        for (int i = 0; i < gParams.avgRuns; i++)
         {
-            continue;
+            stream.prepare();
+            auto tStart = std::chrono::high_resolution_clock::now();
+            float ms;
+            if (!stream.infer(ms))
+            {
+                gLogError << "Inference failed" << std::endl;
+                return false;
+            }
+
+            auto tEnd = std::chrono::high_resolution_clock::now();
+            float host = std::chrono::duration<float, std::milli>(tEnd - tStart).count();
+            totalHost += host;
+            hostTimes.record(host);
+            iterationTimes.record(ms);
+            gpuTimes.record(ms);
+            totalGpu += ms;
+            if (gResults)
+            {
+                gResults->addSample("gpuCompute", "ms", ms);
+                gResults->addSample("hostWalltime", "ms", host);
+            }
+        }
+        totalGpu /= gParams.avgRuns;
+        totalHost /= gParams.avgRuns;
+        gLogInfo << "Average over " << gParams.avgRuns << " runs is " << totalGpu << " ms (host walltime is " << totalHost
+                 << " ms, " << static_cast<int>(gParams.pct) << "\% percentile time is " << iterationTimes.percentile(gParams.pct) << ")." << std::endl;
+    }
+    gLogInfo << "GPU compute: " << gpuTimes << std::endl;
+    gLogInfo << "Host walltime: " << hostTimes << std::endl;
+    if (gResults)
+    {
+        gResults->addSummary("gpuCompute", gpuTimes);
+        gResults->addSummary("hostWalltime", hostTimes);
+    }
+    if (summary)
+    {
+        summary->latency = hostTimes;
+        summary->inferencesPerSecond = hostTimes.count() * 1000.0 / hostTimes.sum();
+    }
+    return true;
+}
+
+bool runMultiStream(const std::vector<std::unique_ptr<TrtInferenceStream>>& streams, RunSummary* summary)
+{
+    std::vector<samplesCommon::IInferenceStream*> inferenceStreams;
+    for (const auto& s : streams)
+        inferenceStreams.push_back(s.get());
+    samplesCommon::MultiStreamRunner runner(inferenceStreams);
+
+    for (int j = 0; j < gParams.iterations; j++)
+    {
+        uint64_t inferencesBefore = runner.getAggregateStats().inferences;
+        double wallBefore = runner.getWallMs();
+        if (!runner.run(gParams.avgRuns))
+        {
+            gLogError << "Inference failed" << std::endl;
+            return false;
+        }
+        double wallMs = runner.getWallMs() - wallBefore;
+        uint64_t inferences = runner.getAggregateStats().inferences - inferencesBefore;
+        gLogInfo << inferences << " inferences on " << streams.size() << " streams in " << wallMs << " ms ("
+                 << inferences * 1000.0 / wallMs << " inferences/s)." << std::endl;
+        if (gResults)
+        {
+            gResults->addSample("throughput", "inferences/s", inferences * 1000.0 / wallMs);
+        }
+    }
+
+    const auto& perStream = runner.getStreamStats();
+    for (size_t s = 0; s < perStream.size(); s++)
+    {
+        gLogInfo << "Stream " << s << " GPU compute: " << perStream[s].gpu << std::endl;
+        gLogInfo << "Stream " << s << " host walltime: " << perStream[s].host << std::endl;
+        if (gResults)
+        {
+            gResults->addSummary("stream" + std::to_string(s) + ".gpuCompute", perStream[s].gpu);
+            gResults->addSummary("stream" + std::to_string(s) + ".hostWalltime", perStream[s].host);
+        }
+    }
+    samplesCommon::StreamStats total = runner.getAggregateStats();
+    gLogInfo << "All streams GPU compute: " << total.gpu << std::endl;
+    gLogInfo << "All streams host walltime: " << total.host << std::endl;
+    gLogInfo << "Throughput: " << runner.getInferencesPerSecond() << " inferences/s, "
+             << runner.getInferencesPerSecond() * gParams.batchSize << " images/s over " << streams.size() << " streams." << std::endl;
+    if (gResults)
+    {
+        gResults->addSummary("gpuCompute", total.gpu);
+        gResults->addSummary("hostWalltime", total.host);
+        gResults->addSample("images/s", "images/s", runner.getInferencesPerSecond() * gParams.batchSize);
+    }
+    if (summary)
+    {
+        summary->latency = total.host;
+        summary->inferencesPerSecond = runner.getInferencesPerSecond();
+    }
+    return true;
+}
+
+bool runOpenLoop(const std::vector<std::unique_ptr<TrtInferenceStream>>& streams)
+{
+    std::vector<samplesCommon::IInferenceStream*> inferenceStreams;
+    for (const auto& s : streams)
+        inferenceStreams.push_back(s.get());
+    samplesCommon::ArrivalProcess process = gParams.arrival == "uniform" ? samplesCommon::ArrivalProcess::kUNIFORM
+                                                                          : samplesCommon::ArrivalProcess::kPOISSON;
+    samplesCommon::OpenLoopRunner runner(inferenceStreams, gParams.queueDepth, process);
+
+    const int nbRequests = gParams.iterations * gParams.avgRuns;
+    std::vector<samplesCommon::LoadPointStats> sweep(gParams.qps.size());
+    for (size_t i = 0; i < gParams.qps.size(); i++)
+    {
+        gLogInfo << "Offering " << nbRequests << " requests at " << gParams.qps[i] << " qps (" << gParams.arrival << " arrivals)" << std::endl;
+        if (!runner.run(gParams.qps[i], nbRequests, sweep[i]))
+        {
+            gLogError << "Inference failed" << std::endl;
+            return false;
+        }
+        gLogInfo << "Queueing delay: " << sweep[i].queueing << std::endl;
+        gLogInfo << "Service time: " << sweep[i].service << std::endl;
+        gLogInfo << "End-to-end latency: " << sweep[i].total << std::endl;
+        if (gResults)
+        {
+            std::ostringstream prefix;
+            prefix << "qps" << gParams.qps[i] << ".";
+            gResults->addSample(prefix.str() + "achievedQps", "requests/s", sweep[i].achievedQps);
+            gResults->addSample(prefix.str() + "dropped", "requests", static_cast<double>(sweep[i].dropped));
+            gResults->addSummary(prefix.str() + "queueing", sweep[i].queueing);
+            gResults->addSummary(prefix.str() + "service", sweep[i].service);
+            gResults->addSummary(prefix.str() + "total", sweep[i].total);
+        }
+    }
+
+    gLogInfo << "Latency vs. offered load (ms):" << std::endl;
+    gLogInfo << std::setw(12) << "offered qps" << std::setw(14) << "achieved qps" << std::setw(10) << "dropped"
+             << std::setw(12) << "queue p50" << std::setw(12) << "queue p99" << std::setw(12) << "service p50"
+             << std::setw(12) << "service p99" << std::setw(12) << "total p50" << std::setw(12) << "total p99" << std::endl;
+    for (const auto& point : sweep)
+    {
+        gLogInfo << std::setw(12) << point.offeredQps << std::setw(14) << point.achievedQps << std::setw(10) << point.dropped
+                 << std::setw(12) << point.queueing.percentile(50) << std::setw(12) << point.queueing.percentile(99)
+                 << std::setw(12) << point.service.percentile(50) << std::setw(12) << point.service.percentile(99)
+                 << std::setw(12) << point.total.percentile(50) << std::setw(12) << point.total.percentile(99) << std::endl;
+    }
+    return true;
+}
+
+//!
+//! \brief Run every stream back to back for --duration seconds, reporting the throughput and latency of the last
+//!        --soakWindow seconds and the host and device memory usage every --reportInterval seconds.
+//!
+//! \details Memory that has not shrunk over --leakWindow consecutive reports, grew in both halves of them and by at
+//!          least --leakThreshold MB overall is reported as a probable leak. Device memory is the usage of the whole
+//!          device as seen by cudaMemGetInfo, so other processes on the same GPU affect it.
+//!
+bool runSoak(const std::vector<std::unique_ptr<TrtInferenceStream>>& streams)
+{
+    samplesCommon::RollingWindow window(gParams.soakWindow * 1000.0);
+    const int64_t leakBytes = static_cast<int64_t>(gParams.leakThreshold) << 20;
+    samplesCommon::MemoryGrowthDetector hostGrowth(gParams.leakWindow, leakBytes);
+    samplesCommon::MemoryGrowthDetector deviceGrowth(gParams.leakWindow, leakBytes);
+    std::vector<samplesCommon::StreamStats> stats(streams.size());
+    std::atomic<bool> stop{false};
+    std::atomic<bool> failed{false};
+
+    const auto tStart = std::chrono::high_resolution_clock::now();
+    auto elapsedMs = [&tStart]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+    };
+    std::vector<std::thread> threads;
+    for (size_t s = 0; s < streams.size(); s++)
+    {
+        threads.emplace_back([&, s]() {
+            streams[s]->bindThread();
+            while (!stop && !failed)
+            {
+                float gpuMs;
+                streams[s]->prepare();
+                const double begin = elapsedMs();
+                if (!streams[s]->infer(gpuMs))
+                {
+                    failed = true;
+                    return;
+                }
+                const double end = elapsedMs();
+                window.record(end, end - begin);
+                stats[s].host.record(end - begin);
+                stats[s].gpu.record(gpuMs);
+                ++stats[s].inferences;
+            }
+        });
+    }
+
+    bool hostLeak{false}, deviceLeak{false};
+    const double durationMs = gParams.duration * 1000.0;
+    for (double nextReport = gParams.reportInterval * 1000.0; !failed; nextReport += gParams.reportInterval * 1000.0)
+    {
+        const double reportAt = std::min(nextReport, durationMs);
+        while (!failed && elapsedMs() < reportAt)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::max(1, static_cast<int>(std::min(reportAt - elapsedMs(), 100.0)))));
+        }
+        if (failed)
+        {
+            break;
+        }
+
+        const double now = elapsedMs();
+        const samplesCommon::LatencyHistogram latency = window.latency(now);
+        const double throughput = window.throughput(now);
+        const int64_t rss = samplesCommon::residentSetBytes();
+        size_t freeBytes{0}, totalBytes{0};
+        cudaMemGetInfo(&freeBytes, &totalBytes);
+        const int64_t deviceUsed = static_cast<int64_t>(totalBytes - freeBytes);
+        std::ostringstream report;
+        report << std::fixed << std::setprecision(1) << "[" << now / 1000.0 << " s] " << throughput << " inferences/s, "
+               << throughput * gParams.batchSize << " images/s, latency p50 = " << std::setprecision(5)
+               << latency.percentile(50) << " ms, p99 = " << latency.percentile(99) << " ms over the last "
+               << std::setprecision(0) << std::min(now, window.getWindowMs()) / 1000.0 << " s; host RSS = "
+               << (rss >> 20) << " MB, device memory used = " << (deviceUsed >> 20) << " MB";
+        gLogInfo << report.str() << std::endl;
+        if (gResults)
+        {
+            gResults->addSample("soak.throughput", "inferences/s", throughput);
+            gResults->addSample("soak.latency.p50", "ms", latency.percentile(50));
+            gResults->addSample("soak.latency.p99", "ms", latency.percentile(99));
+            gResults->addSample("soak.hostRss", "bytes", static_cast<double>(rss));
+            gResults->addSample("soak.deviceUsed", "bytes", static_cast<double>(deviceUsed));
+        }
+
+        if (rss >= 0 && hostGrowth.add(now, rss) && !hostLeak)
+        {
+            gLogWarning << "Host RSS has not shrunk over the last " << hostGrowth.getWindowSize() << " reports and grew by "
+                        << (hostGrowth.growth() >> 20) << " MB (" << hostGrowth.slope() * 60 / (1 << 20) << " MB/min)" << std::endl;
+        }
+        hostLeak = hostLeak || hostGrowth.isGrowing();
+        if (deviceGrowth.add(now, deviceUsed) && !deviceLeak)
+        {
+            gLogWarning << "Device memory has not shrunk over the last " << deviceGrowth.getWindowSize() << " reports and grew by "
+                        << (deviceGrowth.growth() >> 20) << " MB (" << deviceGrowth.slope() * 60 / (1 << 20) << " MB/min)" << std::endl;
+        }
+        deviceLeak = deviceLeak || deviceGrowth.isGrowing();
+
+        if (reportAt >= durationMs)
+        {
+            break;
+        }
+    }
+    stop = true;
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    if (failed)
+    {
+        gLogError << "Inference failed" << std::endl;
+        return false;
+    }
+
+    samplesCommon::StreamStats total;
+    for (const auto& s : stats)
+    {
+        total.gpu.merge(s.gpu);
+        total.host.merge(s.host);
+        total.inferences += s.inferences;
+    }
+    const double wallMs = elapsedMs();
+    gLogInfo << "Soak test: " << total.inferences << " inferences on " << streams.size() << " streams in " << wallMs / 1000.0
+             << " s (" << total.inferences * 1000.0 / wallMs << " inferences/s)" << std::endl;
+    gLogInfo << "GPU compute: " << total.gpu << std::endl;
+    gLogInfo << "Host walltime: " << total.host << std::endl;
+    if (!hostLeak && !deviceLeak)
+    {
+        gLogInfo << "No steady memory growth detected." << std::endl;
+    }
+    if (gResults)
+    {
+        gResults->addSummary("gpuCompute", total.gpu);
+        gResults->addSummary("hostWalltime", total.host);
+        gResults->addSample("throughput", "inferences/s", total.inferences * 1000.0 / wallMs);
+        gResults->addSample("soak.hostLeak", "flag", hostLeak ? 1 : 0);
+        gResults->addSample("soak.deviceLeak", "flag", deviceLeak ? 1 : 0);
+    }
+    return true;
+}
+
+//!
+//! \brief Report the --endToEnd phase times merged over all streams.
+//!
+void reportPhases(const std::vector<std::unique_ptr<TrtInferenceStream>>& streams)
+{
+    TrtInferenceStream::PhaseStats merged;
+    for (const auto& stream : streams)
+    {
+        const TrtInferenceStream::PhaseStats& phases = stream->getPhaseStats();
+        merged.h2d.merge(phases.h2d);
+        merged.compute.merge(phases.compute);
+        merged.d2h.merge(phases.d2h);
+        merged.total.merge(phases.total);
+    }
+    gLogInfo << "Phase H2D copy: " << merged.h2d << std::endl;
+    gLogInfo << "Phase compute: " << merged.compute << std::endl;
+    gLogInfo << "Phase D2H copy: " << merged.d2h << std::endl;
+    gLogInfo << "End-to-end GPU: " << merged.total << std::endl;
+    if (gResults)
+    {
+        gResults->addSummary("h2d", merged.h2d);
+        gResults->addSummary("d2h", merged.d2h);
+        gResults->addSummary("endToEnd", merged.total);
+    }
+}
+
+//!
+//! \brief Report where the host time of an inference goes, merged over all streams, and the CPU use of the run.
+//!
+void reportHostOverhead(const std::vector<std::unique_ptr<TrtInferenceStream>>& streams, const samplesCommon::CpuUsage& cpuUsage)
+{
+    TrtInferenceStream::HostOverheadStats merged;
+    for (const auto& stream : streams)
+    {
+        const TrtInferenceStream::HostOverheadStats& overhead = stream->getHostOverhead();
+        merged.enqueue.merge(overhead.enqueue);
+        merged.eventRecord.merge(overhead.eventRecord);
+        merged.sync.merge(overhead.sync);
+    }
+    gLogInfo << "Host enqueue: " << merged.enqueue << std::endl;
+    gLogInfo << "Host cudaEventRecord: " << merged.eventRecord << std::endl;
+    gLogInfo << "Host cudaEventSynchronize: " << merged.sync << std::endl;
+    gLogInfo << "Host CPU utilization: " << cpuUsage << std::endl;
+    if (gResults)
+    {
+        gResults->addSummary("hostEnqueue", merged.enqueue);
+        gResults->addSummary("hostEventRecord", merged.eventRecord);
+        gResults->addSummary("hostSync", merged.sync);
+        gResults->addSample("cpuUtilization", "cores", cpuUsage.utilization());
+        gResults->addSample("cpuUser", "ms", cpuUsage.userMs());
+        gResults->addSample("cpuSystem", "ms", cpuUsage.systemMs());
+    }
+}
+
+bool loadInputDatasets(const ICudaEngine& engine)
+{
+    for (const auto& input : gParams.loadInputs)
+    {
+        int index = engine.getBindingIndex(input.first.c_str());
+        if (index < 0 || !engine.bindingIsInput(index))
+        {
+            gLogError << "--loadInputs: " << input.first << " is not an input of the engine" << std::endl;
+            return false;
+        }
+
+        std::unique_ptr<samplesCommon::TensorDataset> dataset{new samplesCommon::TensorDataset};
+        std::string error;
+        if (!dataset->open(input.second, engine.getBindingDataType(index), engine.getBindingDimensions(index), error))
+        {
+            gLogError << "--loadInputs: " << error << std::endl;
+            return false;
+        }
+        gLogInfo << "Input \"" << input.first << "\": " << dataset->getNbSamples() << " samples mapped from " << input.second << std::endl;
+        gInputDatasets[index] = std::move(dataset);
+    }
+    return true;
+}
+
+//!
+//! \brief Check the outputs of the first batch against the --refOutputs files.
+//!
+//! \details A reference holds the expected values of the first one or more samples of the batch. Every output is
+//!          checked and reported, and false is returned if any of them is out of tolerance.
+//!
+bool validateOutputs(const ICudaEngine& engine, TrtInferenceStream& stream)
+{
+    if (gParams.loadInputs.empty())
+    {
+        gLogWarning << "--refOutputs without --loadInputs checks the outputs of uninitialized inputs" << std::endl;
+    }
+    stream.setProfiler(nullptr);
+    if (!stream.inferFirstBatch())
+    {
+        gLogError << "Validation inference failed" << std::endl;
+        return false;
+    }
+
+    samplesCommon::ValidationTolerance tolerance;
+    tolerance.absTol = gParams.absTol;
+    tolerance.relTol = gParams.relTol;
+    tolerance.ulpTol = gParams.ulpTol;
+    bool passed{true};
+    for (const auto& ref : gParams.refOutputs)
+    {
+        int index = engine.getBindingIndex(ref.first.c_str());
+        if (index < 0 || engine.bindingIsInput(index))
+        {
+            gLogError << "--refOutputs: " << ref.first << " is not an output of the engine" << std::endl;
+            return false;
+        }
+
+        samplesCommon::ReferenceTensor reference;
+        std::string error;
+        DataType type = engine.getBindingDataType(index);
+        if (!reference.open(ref.second, type, error))
+        {
+            gLogError << "--refOutputs: " << error << std::endl;
+            return false;
+        }
+        const size_t sampleVolume = volume(engine.getBindingDimensions(index));
+        const size_t count = reference.getNbElements();
+        if (count % sampleVolume != 0 || count / sampleVolume > static_cast<size_t>(gParams.batchSize))
+        {
+            gLogError << "--refOutputs: " << ref.second << " holds " << count << " elements, which is not a whole number of "
+                      << ref.first << " samples of " << sampleVolume << " elements up to the batch size" << std::endl;
+            return false;
+        }
+
+        const void* output = stream.getBufferManager().getHostBuffer(ref.first);
+        auto tStart = std::chrono::high_resolution_clock::now();
+        samplesCommon::ValidationReport report = samplesCommon::validateTensor(
+            output, type, reference.data(), reference.getType(), count, tolerance, gParams.maxMismatches);
+        float ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+
+        if (report.passed())
+        {
+            gLogInfo << "Output \"" << ref.first << "\" matches " << ref.second << " (checked in " << ms << " ms): " << report << std::endl;
+        }
+        else
+        {
+            gLogError << "Output \"" << ref.first << "\" does not match " << ref.second << ": " << report << std::endl;
+        }
+        if (gResults)
+        {
+            gResults->addSample(ref.first + ".maxAbsError", "abs", report.maxAbsError);
+            gResults->addSample(ref.first + ".meanAbsError", "abs", report.meanAbsError);
+            gResults->addSample(ref.first + ".mismatches", "elements", static_cast<double>(report.nbMismatches));
+        }
+        passed = passed && report.passed();
+    }
+    return passed;
+}
+
+//!
+//! \brief Write output tensorName to --dumpDir in the --dumpFormat, so that it can be inspected offline or replayed
+//!        with --loadInputs.
+//!
+bool dumpOutputFile(samplesCommon::BufferManager& bufferManager, const std::string& tensorName)
+{
+    samplesCommon::DumpFormat format = gParams.dumpFormat == "raw" ? samplesCommon::DumpFormat::kRAW
+        : gParams.dumpFormat == "npy" ? samplesCommon::DumpFormat::kNPY : samplesCommon::DumpFormat::kTEXT;
+    std::string fileName = tensorName;
+    std::replace(fileName.begin(), fileName.end(), '/', '_');
+    fileName = gParams.dumpDir + "/" + fileName + (format == samplesCommon::DumpFormat::kRAW ? ".bin"
+        : format == samplesCommon::DumpFormat::kNPY ? ".npy" : ".txt");
+
+    std::string error;
+    if (!bufferManager.dumpBuffer(tensorName, fileName, format, error))
+    {
+        gLogError << "Could not dump output tensor " << tensorName << ": " << error << std::endl;
+        return false;
+    }
+    gLogInfo << "Dumped output tensor " << tensorName << " to " << fileName << std::endl;
+    return true;
+}
+
+//!
+//! \brief Write the per-layer profile to --exportProfile and its Chrome trace next to it, e.g. profile.json and
+//!        profile.trace.json.
+//!
+bool exportProfile(const SimpleProfiler& profiler)
+{
+    gLogInfo << profiler;
+
+    const std::string ext = ".json";
+    std::string traceFile = gParams.exportProfile;
+    if (traceFile.size() > ext.size() && traceFile.compare(traceFile.size() - ext.size(), ext.size(), ext) == 0)
+    {
+        traceFile.erase(traceFile.size() - ext.size());
+    }
+    traceFile += ".trace.json";
+
+    if (!profiler.exportJson(gParams.exportProfile) || !profiler.exportTrace(traceFile))
+    {
+        gLogError << "Could not write the layer profile to " << gParams.exportProfile << " and " << traceFile << std::endl;
+        return false;
+    }
+    gLogInfo << "Layer profile has been exported to " << gParams.exportProfile << " and " << traceFile << std::endl;
+    return true;
+}
+
+bool doInference(ICudaEngine& engine, RunSummary* summary = nullptr)
+{
+    std::vector<std::unique_ptr<TrtInferenceStream>> streams;
+    for (int s = 0; s < gParams.streams; s++)
+    {
+        streams.emplace_back(new TrtInferenceStream(engine));
+    }
+
+    for (auto& stream : streams)
+    {
+        if (!warmUp(*stream))
+        {
+            return false;
+        }
+        stream->resetStats();
+    }
+
+    // Attached after the warm-up so that the profile only holds measured iterations.
+    std::unique_ptr<SimpleProfiler> profiler;
+    if (!gParams.exportProfile.empty())
+    {
+        profiler.reset(new SimpleProfiler("trtexec"));
+        streams[0]->setProfiler(profiler.get());
+    }
+
+    samplesCommon::CpuUsage cpuUsage;
+    cpuUsage.start();
+    bool status{false};
+    if (gParams.duration > 0)
+    {
+        status = runSoak(streams);
+    }
+    else if (!gParams.qps.empty())
+    {
+        status = runOpenLoop(streams);
+    }
+    else
+    {
+        status = gParams.streams == 1 ? runSingleStream(*streams[0], summary) : runMultiStream(streams, summary);
+    }
+    cpuUsage.stop();
+    if (!status)
+    {
+        return false;
+    }
+
+    if (gParams.endToEnd)
+    {
+        reportPhases(streams);
+    }
+
+    if (gParams.hostOverhead)
+    {
+        reportHostOverhead(streams, cpuUsage);
+    }
+
+    if (profiler && !exportProfile(*profiler))
+    {
+        return false;
+    }
+
+    if (!gParams.refOutputs.empty() && !validateOutputs(engine, *streams[0]))
+    {
+        return false;
+    }
+
+    if (gParams.dumpOutput || !gParams.dumpDir.empty())
+    {
+        samplesCommon::BufferManager& bufferManager = streams[0]->getBufferManager();
+        bufferManager.copyOutputToHost();
+        int nbBindings = engine.getNbBindings();
+        for (int i = 0; i < nbBindings; i++)
+        {
+            if (!engine.bindingIsInput(i))
+            {
+                const char* tensorName = engine.getBindingName(i);
+                if (gParams.dumpDir.empty())
+                {
+                    gLogInfo << "Dumping output tensor " << tensorName << ":" << std::endl;
+                    bufferManager.dumpBuffer(gLogInfo, tensorName);
+                    continue;
+                }
+                if (!dumpOutputFile(bufferManager, tensorName))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static void printUsage()
+{
+    printf("\n");
+    printf("Mandatory params:\n");
+    printf("  --deploy=<file>          Caffe deploy file\n");
+    printf("  OR --uff=<file>          UFF file\n");
+    printf("  OR --onnx=<file>         ONNX Model file\n");
+    printf("  OR --loadEngine=<file>   Load a saved engine\n");
+
+    printf("\nMandatory params for UFF:\n");
+    printf("  --uffInput=<name>,C,H,W Input blob name and its dimensions for UFF parser (can be specified multiple times)\n");
+    printf("  --output=<name>      Output blob name (can be specified multiple times)\n");
+
+    printf("\nMandatory params for Caffe:\n");
+    printf("  --output=<name>      Output blob name (can be specified multiple times)\n");
+
+    printf("\nOptional params:\n");
+    printf("  --model=<file>          Caffe model file (default = no model, random weights used)\n");
+    printf("  --batch=N               Set batch size (default = %d)\n", gParams.batchSize);
+    printf("  --batchSweep=N,N,...    Build and benchmark one engine per batch size and report images/s against p50/p99 latency, marking the Pareto-optimal batch sizes\n");
+    printf("  --exportSweep=<file>    Write the --batchSweep results to <file> as JSON\n");
+    printf("  --manifest=<file>       Run every benchmark listed in a JSON or INI manifest in this process, reusing engines between runs, and report them together. Options on the command line apply to all runs\n");
+    printf("  --device=N              Set cuda device to N (default = %d)\n", gParams.device);
+    printf("  --iterations=N          Run N iterations (default = %d)\n", gParams.iterations);
+    printf("  --avgRuns=N             Set avgRuns to N - perf is measured as an average of avgRuns (default=%d)\n", gParams.avgRuns);
+    printf("  --warmUp=N              Run untimed inferences for N ms before measuring (default = %d)\n", gParams.warmUp);
+    printf("  --steadyState=CV        After warm-up, keep running untimed until the coefficient of variation of the last steadyWindow GPU times is at most CV (default = 0, disabled)\n");
+    printf("  --steadyWindow=N        Number of runs in the --steadyState window (default = %d)\n", gParams.steadyWindow);
+    printf("  --steadyBudget=N        Stop waiting for a steady state after N ms (default = %d)\n", gParams.steadyBudget);
+    printf("  --streams=N             Run N execution contexts concurrently, each with its own stream and host thread (default = %d)\n", gParams.streams);
+    printf("  --processes=N           Run the engine in N processes at once, each with --streams contexts, and merge their statistics. The engine is built once and shared with the processes through shared memory (default = %d)\n", gParams.processes);
+    printf("  --qps=R[,R...]          Open-loop mode: offer iterations*avgRuns requests at R requests per second instead of running back to back. A list sweeps the offered load\n");
+    printf("  --arrival=<process>     Arrival process for --qps: poisson or uniform (default = %s)\n", gParams.arrival.c_str());
+    printf("  --queueDepth=N          Requests that may wait for a free stream in open-loop mode; further arrivals are dropped (default = %d)\n", gParams.queueDepth);
+    printf("  --duration=S            Soak test: run back to back for S seconds instead of --iterations, and report throughput, latency and memory usage periodically (default = 0, disabled)\n");
+    printf("  --reportInterval=S      Seconds between --duration reports (default = %d)\n", gParams.reportInterval);
+    printf("  --soakWindow=S          Throughput and latency of the --duration reports are taken over the last S seconds (default = %d)\n", gParams.soakWindow);
+    printf("  --leakWindow=N          Flag host or device memory that kept growing over N consecutive --duration reports, at least 3 (default = %d)\n", gParams.leakWindow);
+    printf("  --leakThreshold=N       Minimum growth in MB over --leakWindow reports for memory to be flagged (default = %d)\n", gParams.leakThreshold);
+    printf("  --percentile=P          For each iteration, report the percentile time at P percentage (0<=P<=100, with 0 representing min, and 100 representing max; default = %.1f%%)\n", gParams.pct);
+    printf("  --workspace=N           Set workspace size in megabytes (default = %d)\n", gParams.workspaceSize);
+    printf("  --safe                  Only test the functionality available in safety restricted flows.\n");
+    printf("  --fp16                  Run in fp16 mode (default = false). Permits 16-bit kernels\n");
+    printf("  --int8                  Run in int8 mode (default = false). Currently no support for ONNX model.\n");
+    printf("  --verbose               Use verbose logging (default = false)\n");
+    printf("  --saveEngine=<file>     Save a serialized engine to file.\n");
+    printf("  --loadEngine=<file>     Load a serialized engine from file.\n");
+    printf("  --mapHint=H             How --loadEngine and --engineCache plans are paged in: none, populate (read all while mapping), willneed (read ahead in the background) or sequential (default = %s)\n", gParams.mapHint.c_str());
+    printf("  --engineCache=<dir>     Reuse engines built earlier with the same model, settings and calibration cache, and store new ones in <dir>\n");
+    printf("  --engineCacheSize=N     Evict the least recently used engines from --engineCache beyond N MB (default = %d)\n", gParams.engineCacheSize);
+    printf("  --calib=<file>          Read INT8 calibration cache file.  Currently no support for ONNX model.\n");
+    printf("  --calibData=<dir|list>  Calibrate INT8 on raw float32 or .npy files from a directory or a list file instead of random data, and write the scales to the --calib cache. With several inputs, <dir|list>/<input name> is read for each\n");
+    printf("  --calibBatch=N          Batch size used for calibration (default = --batch)\n");
+    printf("  --calibBatches=N        Calibrate on at most N batches (default = 0, all complete batches)\n");
+    printf("  --useDLACore=N          Specify a DLA engine for layers that support DLA. Value can range from 0 to n-1, where n is the number of DLA engines on the platform.\n");
+    printf("  --allowGPUFallback      If --useDLACore flag is present and if a layer can't run on DLA, then run on GPU. \n");
+    printf("  --useSpinWait           Actively wait for work completion. This option may decrease multi-process synchronization time at the cost of additional CPU usage. (default = false)\n");
+    printf("  --loadInputs=<name>:<file>[,...] Memory-map raw or .npy tensor files as input data instead of leaving inputs uninitialized. A file may hold several samples; iterations rotate through them\n");
+    printf("  --endToEnd              Copy the inputs to the device and the outputs back to the host in every inference, and report the time of each phase\n");
+    printf("  --pinned                Use page-locked host buffers, so that --endToEnd copies run at full bandwidth. Same as --hostMemory=pinned\n");
+    printf("  --hostMemory=T          Host buffer allocator: pageable (malloc), pinned (cudaMallocHost), aligned (64-byte aligned), hugepage (transparent huge pages) or pooled (aligned blocks reused across engines and streams) (default = %s)\n", gParams.hostMemory.c_str());
+    printf("  --hostOverhead          Time the host side of every enqueue, cudaEventRecord and cudaEventSynchronize call, and report the CPU utilization of the run\n");
+    printf("  --refOutputs=<name>:<file>[,...] After the run, check the outputs of the first batch against raw or .npy reference files, and fail if any element is out of tolerance. A reference may hold fewer samples than the batch\n");
+    printf("  --absTol=E              Absolute tolerance of --refOutputs (default = %g)\n", gParams.absTol);
+    printf("  --relTol=E              Relative tolerance of --refOutputs; an element matches if |output - reference| <= absTol + relTol * |reference| (default = %g)\n", gParams.relTol);
+    printf("  --ulpTol=N              Also accept elements at most N units in the last place of the output type from the reference (default = %d)\n", gParams.ulpTol);
+    printf("  --maxMismatches=N       Number of mismatching elements listed per output (default = %d)\n", gParams.maxMismatches);
+    printf("  --dumpOutput            Dump outputs at end of test. \n");
+    printf("  --dumpDir=<dir>         Dump outputs at end of test into <dir>/<output name>.txt, .bin or .npy instead of the log. They can be replayed with --loadInputs\n");
+    printf("  --dumpFormat=F          Format of --dumpDir files: text, raw (the bytes of the buffer) or npy (default = %s)\n", gParams.dumpFormat.c_str());
+    printf("  --exportTimes=<file>    Write the measured timings with the build parameters and engine hash to <file>, as CSV if it ends in .csv and as JSON Lines otherwise\n");
+    printf("  --exportProfile=<file>  Profile every layer of the measured iterations and write the statistics to <file> as JSON and a Chrome trace to <file>.trace.json. Layers are timed synchronously, which adds overhead to the reported totals\n");
+    printf("  -h, --help              Print usage\n");
+    fflush(stdout);
+}
+
+bool parseString(const char* arg, const char* name, std::string& value)
+{
+    size_t n = strlen(name);
+    bool match = arg[0] == '-' && arg[1] == '-' && !strncmp(arg + 2, name, n) && arg[n + 2] == '=';
+    if (match)
+    {
+        value = arg + n + 3;
+        gLogInfo << name << ": " << value << std::endl;
+    }
+    return match;
+}
+
+template<typename T>
+bool parseAtoi(const char* arg, const char* name, T& value)
+{
+    size_t n = strlen(name);
+    bool match = arg[0] == '-' && arg[1] == '-' && !strncmp(arg + 2, name, n) && arg[n + 2] == '=';
+    if (match)
+    {
+        value = static_cast<T>(atoi(arg + n + 3));
+        gLogInfo << name << ": " << value << std::endl;
+    }
+    return match;
+}
+
+bool parseInt(const char* arg, const char* name, int& value)
+{
+    return parseAtoi<int>(arg, name, value);
+}
+
+bool parseUnsigned(const char* arg, const char* name, unsigned int& value)
+{
+    return parseAtoi<unsigned int>(arg, name, value);
+}
+
+// parse a boolean option of the form --name, or optionally, -letter.
+bool parseBool(const char* arg, const char* name, bool& value, char letter = '\0')
+{
+    bool match = arg[0] == '-' && ((arg[1] == '-' && !strcmp(arg + 2, name)) || (letter && arg[1] == letter && !arg[2]));
+    if (match)
+    {
+        // Always report the long form of the option.
+        gLogInfo << name << std::endl;
+        value = true;
+    }
+    return match;
+}
+
+bool parseFloat(const char* arg, const char* name, float& value)
+{
+    size_t n = strlen(name);
+    bool match = arg[0] == '-' && arg[1] == '-' && !strncmp(arg + 2, name, n) && arg[n + 2] == '=';
+    if (match)
+    {
+        value = atof(arg + n + 3);
+        gLogInfo << name << ": " << value << std::endl;
+    }
+    return match;
+}
+
+//!
+//! \brief Parse a list of <tensor name>:<file> pairs given to option name.
+//!
+bool parseTensorFiles(const std::string& list, const char* name, std::vector<std::pair<std::string, std::string>>& files)
+{
+    for (const auto& spec : split(list, ','))
+    {
+        // Tensor names may contain ':' themselves, so the file name starts after the last one.
+        size_t colon = spec.rfind(':');
+        if (colon == std::string::npos || colon == 0 || colon + 1 == spec.size())
+        {
+            gLogError << "Invalid " << name << " entry: " << spec << std::endl;
+            return false;
+        }
+        files.emplace_back(spec.substr(0, colon), spec.substr(colon + 1));
+    }
+    return true;
+}
+
+bool validateArgs()
+{
+    // UFF and Caffe files require output nodes to be specified.
+    if ((!gParams.uffFile.empty() || !gParams.deployFile.empty()) && gParams.outputs.empty())
+    {
+        gLogError << "ERROR: At least one output must be specified." << std::endl;
+        return false;
+    }
+    if (!gParams.uffFile.empty() && gParams.uffInputs.empty())
+    {
+        gLogError << "ERROR: At least one UFF input must be specified to run UFF models." << std::endl;
+        return false;
+    }
+    if (!gParams.loadEngine.empty() && !gParams.saveEngine.empty())
+    {
+        gLogError << "ERROR: --saveEngine and --loadEngine cannot be specified at the same time." << std::endl;
+        return false;
+    }
+    if (gParams.streams < 1)
+    {
+        gLogError << "ERROR: --streams must be at least 1." << std::endl;
+        return false;
+    }
+    for (double rate : gParams.qps)
+    {
+        if (rate <= 0)
+        {
+            gLogError << "ERROR: --qps rates must be positive." << std::endl;
+            return false;
+        }
+    }
+    if (gParams.absTol < 0 || gParams.relTol < 0 || gParams.ulpTol < 0 || gParams.maxMismatches < 0)
+    {
+        gLogError << "ERROR: --absTol, --relTol, --ulpTol and --maxMismatches must not be negative." << std::endl;
+        return false;
+    }
+    if (gParams.arrival != "poisson" && gParams.arrival != "uniform")
+    {
+        gLogError << "ERROR: --arrival must be poisson or uniform." << std::endl;
+        return false;
+    }
+    if (gParams.warmUp < 0 || gParams.steadyState < 0 || gParams.steadyWindow < 2 || gParams.steadyBudget < 0)
+    {
+        gLogError << "ERROR: --warmUp, --steadyState and --steadyBudget must not be negative, and --steadyWindow must be at least 2." << std::endl;
+        return false;
+    }
+    if (!gParams.exportProfile.empty() && (gParams.streams > 1 || !gParams.qps.empty()))
+    {
+        gLogError << "ERROR: --exportProfile runs layers synchronously and cannot be combined with --streams or --qps." << std::endl;
+        return false;
+    }
+    if (gParams.mapHint != "none" && gParams.mapHint != "populate" && gParams.mapHint != "willneed" && gParams.mapHint != "sequential")
+    {
+        gLogError << "ERROR: --mapHint must be none, populate, willneed or sequential." << std::endl;
+        return false;
+    }
+    if (gParams.hostMemory != "pageable" && gParams.hostMemory != "pinned" && gParams.hostMemory != "aligned"
+        && gParams.hostMemory != "hugepage" && gParams.hostMemory != "pooled")
+    {
+        gLogError << "ERROR: --hostMemory must be pageable, pinned, aligned, hugepage or pooled." << std::endl;
+        return false;
+    }
+    if (gParams.dumpFormat != "text" && gParams.dumpFormat != "raw" && gParams.dumpFormat != "npy")
+    {
+        gLogError << "ERROR: --dumpFormat must be text, raw or npy." << std::endl;
+        return false;
+    }
+    if (gParams.dumpFormat != "text" && gParams.dumpDir.empty())
+    {
+        gLogError << "ERROR: --dumpFormat=" << gParams.dumpFormat << " writes files and needs --dumpDir." << std::endl;
+        return false;
+    }
+    if (gParams.pinned && gParams.hostMemory != "pageable" && gParams.hostMemory != "pinned")
+    {
+        gLogError << "ERROR: --pinned cannot be combined with --hostMemory=" << gParams.hostMemory << "." << std::endl;
+        return false;
+    }
+    for (int batch : gParams.batchSweep)
+    {
+        if (batch <= 0)
+        {
+            gLogError << "ERROR: --batchSweep batch sizes must be positive." << std::endl;
+            return false;
+        }
+    }
+    if (gParams.duration < 0 || gParams.reportInterval < 1 || gParams.soakWindow < 1 || gParams.leakWindow < 3 || gParams.leakThreshold < 0)
+    {
+        gLogError << "ERROR: --duration and --leakThreshold must not be negative, --reportInterval and --soakWindow must be at least 1 and --leakWindow at least 3." << std::endl;
+        return false;
+    }
+    if (gParams.duration > 0 && (!gParams.qps.empty() || !gParams.batchSweep.empty() || !gParams.exportProfile.empty()))
+    {
+        gLogError << "ERROR: --duration cannot be combined with --qps, --batchSweep or --exportProfile." << std::endl;
+        return false;
+    }
+    if (gParams.processes < 1)
+    {
+        gLogError << "ERROR: --processes must be at least 1." << std::endl;
+        return false;
+    }
+    if (gParams.processes > 1
+        && (!gParams.manifest.empty() || !gParams.batchSweep.empty() || !gParams.qps.empty() || gParams.duration > 0
+            || !gParams.exportProfile.empty() || !gParams.refOutputs.empty() || gParams.dumpOutput || !gParams.dumpDir.empty() || gParams.endToEnd || gParams.hostOverhead))
+    {
+        gLogError << "ERROR: --processes cannot be combined with --manifest, --batchSweep, --qps, --duration, --exportProfile, --refOutputs, --dumpOutput, --dumpDir, --endToEnd or --hostOverhead." << std::endl;
+        return false;
+    }
+    if (!gParams.manifest.empty() && !gParams.batchSweep.empty())
+    {
+        gLogError << "ERROR: --manifest cannot be combined with --batchSweep." << std::endl;
+        return false;
+    }
+    if (!gParams.batchSweep.empty() && (!gParams.loadEngine.empty() || !gParams.qps.empty()))
+    {
+        gLogError << "ERROR: --batchSweep builds its own engines and cannot be combined with --loadEngine or --qps." << std::endl;
+        return false;
+    }
+    if (gParams.calibBatch < 0 || gParams.calibBatches < 0)
+    {
+        gLogError << "ERROR: --calibBatch and --calibBatches must not be negative." << std::endl;
+        return false;
+    }
+    if (gParams.engineCacheSize < 0)
+    {
+        gLogError << "ERROR: --engineCacheSize must not be negative." << std::endl;
+        return false;
+    }
+    if (gParams.queueDepth < 1)
+    {
+        gLogError << "ERROR: --queueDepth must be at least 1." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool parseArgs(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        printUsage();
+        return false;
+    }
+
+    for (int j = 1; j < argc; j++)
+    {
+        if (parseString(argv[j], "model", gParams.modelFile)
+            || parseString(argv[j], "deploy", gParams.deployFile))
+        {
+            continue;
         }
         if (parseString(argv[j], "saveEngine", gParams.saveEngine))
         {
-            continue;
+            continue;
+        }
+        if (parseString(argv[j], "engineCache", gParams.engineCache)
+            || parseString(argv[j], "mapHint", gParams.mapHint))
+        {
+            continue;
+        }
+        if (parseString(argv[j], "loadEngine", gParams.loadEngine))
+        {
+            continue;
+        }
+        if (parseString(argv[j], "engine", gParams.engine))
+        {
+            gLogError << "--engine has been deprecated. Please use --saveEngine and --loadEngine instead." << std::endl;
+            return false;
+        }
+        if (parseString(argv[j], "uff", gParams.uffFile))
+        {
+            continue;
+        }
+
+        if (parseString(argv[j], "onnx", gParams.onnxModelFile))
+        {
+            continue;
+        }
+
+        if (parseString(argv[j], "calib", gParams.calibrationCache)
+            || parseString(argv[j], "calibData", gParams.calibData))
+            continue;
+
+        if (parseString(argv[j], "exportTimes", gParams.exportTimes))
+            continue;
+
+        if (parseString(argv[j], "exportProfile", gParams.exportProfile))
+            continue;
+
+        std::string input;
+        if (parseString(argv[j], "input", input))
+        {
+            gLogWarning << "--input has been deprecated and ignored." << std::endl;
+            continue;
+        }
+
+        std::string output;
+        if (parseString(argv[j], "output", output))
+        {
+            gParams.outputs.push_back(output);
+            continue;
+        }
+
+        std::string tensorFiles;
+        if (parseString(argv[j], "loadInputs", tensorFiles))
+        {
+            if (!parseTensorFiles(tensorFiles, "loadInputs", gParams.loadInputs))
+                return false;
+            continue;
+        }
+        if (parseString(argv[j], "refOutputs", tensorFiles))
+        {
+            if (!parseTensorFiles(tensorFiles, "refOutputs", gParams.refOutputs))
+                return false;
+            continue;
+        }
+
+        std::string batchSweep;
+        if (parseString(argv[j], "batchSweep", batchSweep))
+        {
+            for (const auto& batch : split(batchSweep, ','))
+            {
+                gParams.batchSweep.push_back(atoi(batch.c_str()));
+            }
+            continue;
+        }
+
+        if (parseString(argv[j], "manifest", gParams.manifest))
+        {
+            continue;
+        }
+
+        if (parseString(argv[j], "exportSweep", gParams.exportSweep))
+        {
+            continue;
+        }
+
+        std::string qps;
+        if (parseString(argv[j], "qps", qps))
+        {
+            for (const auto& rate : split(qps, ','))
+            {
+                gParams.qps.push_back(atof(rate.c_str()));
+            }
+            continue;
+        }
+
+        if (parseString(argv[j], "arrival", gParams.arrival)
+            || parseString(argv[j], "hostMemory", gParams.hostMemory)
+            || parseString(argv[j], "dumpFormat", gParams.dumpFormat)
+            || parseString(argv[j], "dumpDir", gParams.dumpDir))
+        {
+            continue;
+        }
+
+        std::string uffInput;
+        if (parseString(argv[j], "uffInput", uffInput))
+        {
+            std::vector<std::string> uffInputStrs = split(uffInput, ',');
+            if (uffInputStrs.size() != 4)
+            {
+                gLogError << "Invalid uffInput: " << uffInput << std::endl;
+                return false;
+            }
+
+            gParams.uffInputs.push_back(std::make_pair(uffInputStrs[0], Dims3(atoi(uffInputStrs[1].c_str()), atoi(uffInputStrs[2].c_str()), atoi(uffInputStrs[3].c_str()))));
+            continue;
+        }
+
+        if (parseInt(argv[j], "batch", gParams.batchSize)
+            || parseInt(argv[j], "iterations", gParams.iterations)
+            || parseInt(argv[j], "avgRuns", gParams.avgRuns)
+            || parseInt(argv[j], "streams", gParams.streams)
+            || parseInt(argv[j], "queueDepth", gParams.queueDepth)
+            || parseInt(argv[j], "engineCacheSize", gParams.engineCacheSize)
+            || parseInt(argv[j], "warmUp", gParams.warmUp)
+            || parseInt(argv[j], "calibBatch", gParams.calibBatch)
+            || parseInt(argv[j], "calibBatches", gParams.calibBatches)
+            || parseInt(argv[j], "steadyWindow", gParams.steadyWindow)
+            || parseInt(argv[j], "steadyBudget", gParams.steadyBudget)
+            || parseInt(argv[j], "device", gParams.device)
+            || parseInt(argv[j], "workspace", gParams.workspaceSize)
+            || parseInt(argv[j], "ulpTol", gParams.ulpTol)
+            || parseInt(argv[j], "maxMismatches", gParams.maxMismatches)
+            || parseInt(argv[j], "processes", gParams.processes)
+            || parseInt(argv[j], "duration", gParams.duration)
+            || parseInt(argv[j], "reportInterval", gParams.reportInterval)
+            || parseInt(argv[j], "soakWindow", gParams.soakWindow)
+            || parseInt(argv[j], "leakWindow", gParams.leakWindow)
+            || parseInt(argv[j], "leakThreshold", gParams.leakThreshold)
+            || parseInt(argv[j], "useDLACore", gParams.useDLACore))
+            continue;
+
+        if (parseFloat(argv[j], "percentile", gParams.pct)
+            || parseFloat(argv[j], "steadyState", gParams.steadyState)
+            || parseFloat(argv[j], "absTol", gParams.absTol)
+            || parseFloat(argv[j], "relTol", gParams.relTol))
+            continue;
+
+        if (parseBool(argv[j], "safe", gParams.safeMode)
+            || parseBool(argv[j], "fp16", gParams.fp16)
+            || parseBool(argv[j], "int8", gParams.int8)
+            || parseBool(argv[j], "verbose", gParams.verbose)
+            || parseBool(argv[j], "allowGPUFallback", gParams.allowGPUFallback)
+            || parseBool(argv[j], "useSpinWait", gParams.useSpinWait)
+            || parseBool(argv[j], "dumpOutput", gParams.dumpOutput)
+            || parseBool(argv[j], "endToEnd", gParams.endToEnd)
+            || parseBool(argv[j], "pinned", gParams.pinned)
+            || parseBool(argv[j], "hostOverhead", gParams.hostOverhead)
+            || parseBool(argv[j], "help", gParams.help, 'h'))
+            continue;
+
+        gLogError << "Unknown argument: " << argv[j] << std::endl;
+        return false;
+    }
+
+    return validateArgs();
+}
+
+static samplesCommon::MappedFile::AccessHint mapHint()
+{
+    using AccessHint = samplesCommon::MappedFile::AccessHint;
+    return gParams.mapHint == "populate" ? AccessHint::kPOPULATE
+        : gParams.mapHint == "willneed" ? AccessHint::kWILLNEED
+        : gParams.mapHint == "sequential" ? AccessHint::kSEQUENTIAL : AccessHint::kNONE;
+}
+
+//!
+//! \brief Deserialize a plan held in memory and log how long mapping and deserialization took.
+//!
+static ICudaEngine* deserializeEngine(const void* data, size_t size, float mapMs)
+{
+    auto tStart = std::chrono::high_resolution_clock::now();
+    IRuntime* infer = createInferRuntime(gLogger.getTRTLogger());
+    if (gParams.useDLACore >= 0)
+    {
+        infer->setDLACore(gParams.useDLACore);
+    }
+
+    ICudaEngine* engine = infer->deserializeCudaEngine(data, size, nullptr);
+    infer->destroy();
+    float deserializeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+    gLogInfo << "Engine load time: " << mapMs + deserializeMs << " ms (map " << mapMs << " ms, deserialize "
+             << deserializeMs << " ms, " << (size >> 20) << " MB)" << std::endl;
+    return engine;
+}
+
+//!
+//! \brief Deserialize a mapped plan in place.
+//!
+static ICudaEngine* deserializeEngine(const samplesCommon::MappedFile& plan, float mapMs)
+{
+    return deserializeEngine(plan.data(), plan.size(), mapMs);
+}
+
+//!
+//! \brief Returns the --engineCache key of the engine described by the command line.
+//!
+//! \details With --int8 the key covers the current contents of the --calib cache, which a build may write; the key
+//!          of a newly built engine is therefore computed again after the build.
+//!
+static std::string engineCacheKey()
+{
+    samplesCommon::EngineCacheKey key = samplesCommon::createEngineCacheKey();
+    key.addFile(gParams.deployFile).addFile(gParams.modelFile).addFile(gParams.uffFile).addFile(gParams.onnxModelFile);
+    for (const auto& s : gParams.uffInputs)
+    {
+        key.addSetting("uffInput", s.first).addSetting("C", s.second.d[0]).addSetting("H", s.second.d[1]).addSetting("W", s.second.d[2]);
+    }
+    for (const auto& s : gParams.outputs)
+    {
+        key.addSetting("output", s);
+    }
+    key.addSetting("batch", gParams.batchSize)
+        .addSetting("workspace", gParams.workspaceSize)
+        .addSetting("fp16", gParams.fp16)
+        .addSetting("int8", gParams.int8)
+        .addSetting("useDLACore", gParams.useDLACore)
+        .addSetting("allowGPUFallback", gParams.allowGPUFallback)
+        .addSetting("safeMode", gParams.safeMode);
+    if (gParams.int8)
+    {
+        key.addFile(gParams.calibrationCache)
+            .addSetting("calibData", gParams.calibData)
+            .addSetting("calibBatch", gParams.calibBatch)
+            .addSetting("calibBatches", gParams.calibBatches);
+    }
+    return key.str();
+}
+
+static ICudaEngine* createEngine()
+{
+    ICudaEngine* engine;
+    // load directly from serialized engine file if deploy not specified
+    if (!gParams.loadEngine.empty())
+    {
+        // The plan is deserialized straight from the page cache instead of being copied into a buffer first.
+        auto tStart = std::chrono::high_resolution_clock::now();
+        samplesCommon::MappedFile plan;
+        if (!plan.open(gParams.loadEngine, mapHint()))
+        {
+            gLogError << "Could not map " << gParams.loadEngine << ": " << strerror(errno) << std::endl;
+            return nullptr;
+        }
+        float mapMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+
+        engine = deserializeEngine(plan, mapMs);
+        if (engine)
+        {
+            gLogInfo << gParams.loadEngine << " has been successfully loaded." << std::endl;
+        }
+        return engine;
+    }
+
+    if ((!gParams.deployFile.empty()) || (!gParams.uffFile.empty()) || (!gParams.onnxModelFile.empty()))
+    {
+        samplesCommon::EngineCache cache(gParams.engineCache, static_cast<uint64_t>(gParams.engineCacheSize) << 20);
+        std::string cacheKey;
+        bool cacheHit{false};
+        engine = nullptr;
+        if (cache.isEnabled())
+        {
+            cacheKey = engineCacheKey();
+            auto tStart = std::chrono::high_resolution_clock::now();
+            samplesCommon::MappedFile plan;
+            if (cache.load(cacheKey, plan, mapHint()))
+            {
+                float mapMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+                engine = deserializeEngine(plan, mapMs);
+                cacheHit = engine != nullptr;
+                if (cacheHit)
+                {
+                    gLogInfo << "Engine has been loaded from " << cache.getPath(cacheKey) << std::endl;
+                }
+                else
+                {
+                    gLogWarning << "Could not deserialize " << cache.getPath(cacheKey) << ", rebuilding it" << std::endl;
+                }
+            }
+        }
+
+        if (!cacheHit)
+        {
+            if (!gParams.uffFile.empty())
+            {
+                engine = uffToTRTModel();
+            }
+            else if (!gParams.onnxModelFile.empty())
+            {
+                engine = onnxToTRTModel();
+            }
+            else
+            {
+                engine = caffeToTRTModel();
+            }
+        }
+
+        if (!engine)
+        {
+            gLogError << "Engine could not be created" << std::endl;
+            return nullptr;
+        }
+
+        const bool storeInCache = cache.isEnabled() && !cacheHit;
+        if (gParams.saveEngine.empty() && !storeInCache)
+        {
+            return engine;
+        }
+
+        IHostMemory* ptr = engine->serialize();
+        if (ptr == nullptr)
+        {
+            gLogError << "could not serialize engine." << std::endl;
+            return nullptr;
+        }
+        if (!gParams.saveEngine.empty())
+        {
+            std::ofstream p(gParams.saveEngine, std::ios::binary);
+            if (!p)
+            {
+                gLogError << "could not open plan output file" << std::endl;
+                ptr->destroy();
+                return nullptr;
+            }
+            p.write(reinterpret_cast<const char*>(ptr->data()), ptr->size());
+            gLogInfo << "Engine has been successfully saved to " << gParams.saveEngine << std::endl;
+        }
+        if (storeInCache)
+        {
+            if (gParams.int8)
+            {
+                // Calibration may have just written the --calib cache that the key computed before the build saw
+                // missing; later runs find it written, so the engine is stored under the key that covers it.
+                cacheKey = engineCacheKey();
+            }
+            if (cache.store(cacheKey, ptr->data(), ptr->size()))
+            {
+                gLogInfo << "Engine has been cached as " << cache.getPath(cacheKey) << std::endl;
+            }
+            else
+            {
+                gLogWarning << "Could not write " << cache.getPath(cacheKey) << ": " << strerror(errno) << std::endl;
+            }
         }
-        if (parseString(argv[j], "loadEngine", gParams.loadEngine))
+        ptr->destroy();
+        return engine;
+    }
+
+    // complain about empty deploy file
+    gLogError << "Deploy file not specified" << std::endl;
+    return nullptr;
+}
+
+//!
+//! \brief Record the parameters of the run in gResults, with their names prefixed by prefix.
+//!
+static void setResultParameters(ICudaEngine& engine, const std::string& prefix)
+{
+    std::string model = !gParams.loadEngine.empty() ? gParams.loadEngine
+                      : !gParams.onnxModelFile.empty() ? gParams.onnxModelFile
+                      : !gParams.uffFile.empty() ? gParams.uffFile : gParams.deployFile;
+    std::ostringstream version;
+    version << NV_TENSORRT_MAJOR << "." << NV_TENSORRT_MINOR << "." << NV_TENSORRT_PATCH << "." << NV_TENSORRT_BUILD;
+
+    gResults->setParameter(prefix + "model", model);
+    gResults->setParameter("tensorrt", version.str());
+    gResults->setParameter(prefix + "batch", gParams.batchSize);
+    gResults->setParameter(prefix + "workspace", gParams.workspaceSize);
+    gResults->setParameter(prefix + "fp16", gParams.fp16);
+    gResults->setParameter(prefix + "int8", gParams.int8);
+    gResults->setParameter(prefix + "useDLACore", gParams.useDLACore);
+    gResults->setParameter(prefix + "iterations", gParams.iterations);
+    gResults->setParameter(prefix + "avgRuns", gParams.avgRuns);
+    gResults->setParameter(prefix + "streams", gParams.streams);
+    gResults->setParameter(prefix + "warmUp", gParams.warmUp);
+    gResults->setParameter(prefix + "steadyState", gParams.steadyState);
+    gResults->setParameter(prefix + "endToEnd", gParams.endToEnd);
+    gResults->setParameter(prefix + "pinned", gParams.pinned);
+    gResults->setParameter(prefix + "hostMemory", gParams.hostMemory);
+    gResults->setParameter(prefix + "hostOverhead", gParams.hostOverhead);
+
+    IHostMemory* plan = engine.serialize();
+    if (plan)
+    {
+        gResults->setEngineHash(samplesCommon::hashBytes(plan->data(), plan->size()));
+        plan->destroy();
+    }
+}
+
+//!
+//! \brief Map the --loadInputs files for engine and benchmark it. The result parameters are recorded with their
+//!        names prefixed by parameterPrefix.
+//!
+static bool benchmarkEngine(ICudaEngine& engine, RunSummary* summary = nullptr, const std::string& parameterPrefix = "")
+{
+    gInputDatasets.clear();
+    if (!loadInputDatasets(engine))
+    {
+        return false;
+    }
+    if (gResults)
+    {
+        setResultParameters(engine, parameterPrefix);
+    }
+    return doInference(engine, summary);
+}
+
+//!
+//! \brief Build (or load from --engineCache) and benchmark one engine per --batchSweep batch size, then report
+//!        images/s against latency with the Pareto-optimal batch sizes marked.
+//!
+//! \details The exported metrics and parameters of each batch size are prefixed by "batch<N>.", and each batch size
+//!          writes its own --exportProfile, e.g. profile.batch8.json.
+//!
+static bool runBatchSweep()
+{
+    const std::string profileFile = gParams.exportProfile;
+    samplesCommon::BatchSweep sweep(gParams.batchSweep);
+    bool pass = sweep.run([&profileFile](int batchSize, samplesCommon::BatchSweepPoint& point) {
+        gLogInfo << "Batch size " << batchSize << ":" << std::endl;
+        const std::string prefix = "batch" + std::to_string(batchSize) + ".";
+        gParams.batchSize = batchSize;
+        if (gResults)
         {
-            continue;
+            gResults->setMetricPrefix(prefix);
         }
-        if (parseString(argv[j], "engine", gParams.engine))
+        if (!profileFile.empty())
         {
-            gLogError << "--engine has been deprecated. Please use --saveEngine and --loadEngine instead." << std::endl;
+            const std::string ext = ".json";
+            const bool hasExt = profileFile.size() > ext.size()
+                && profileFile.compare(profileFile.size() - ext.size(), ext.size(), ext) == 0;
+            gParams.exportProfile = profileFile.substr(0, profileFile.size() - (hasExt ? ext.size() : 0)) + "." + prefix + "json";
+        }
+
+        ICudaEngine* engine = createEngine();
+        if (!engine)
+        {
+            gLogError << "Engine could not be created" << std::endl;
             return false;
         }
-        if (parseString(argv[j], "uff", gParams.uffFile))
+        RunSummary summary;
+        bool status = benchmarkEngine(*engine, &summary, prefix);
+        engine->destroy();
+
+        point.imagesPerSecond = summary.inferencesPerSecond * batchSize;
+        point.p50Ms = summary.latency.percentile(50);
+        point.p99Ms = summary.latency.percentile(99);
+        return status;
+    });
+    gParams.exportProfile = profileFile;
+
+    gLogInfo << "Throughput vs. latency per batch (* = Pareto-optimal):" << std::endl;
+    sweep.writeTable(gLogInfo);
+    if (!gParams.exportSweep.empty())
+    {
+        std::ofstream out(gParams.exportSweep);
+        sweep.writeJson(out);
+        if (!out)
         {
-            continue;
+            gLogError << "Could not write the batch sweep to " << gParams.exportSweep << std::endl;
+            return false;
         }
+        gLogInfo << "Batch sweep has been exported to " << gParams.exportSweep << std::endl;
+    }
+    return pass;
+}
 
-        if (parseString(argv[j], "onnx", gParams.onnxModelFile))
+//!
+//! \brief Models parsed by a process, which decide how protobuf is shut down.
+//!
+struct ParsersUsed
+{
+    bool caffe{false};
+    bool uff{false};
+    bool onnx{false};
+
+    void add(const Params& params)
+    {
+        caffe = caffe || !params.deployFile.empty();
+        uff = uff || !params.uffFile.empty();
+        onnx = onnx || !params.onnxModelFile.empty();
+    }
+};
+
+//!
+//! \brief Returns a key that is equal for runs that can share an engine within this process.
+//!
+static std::string engineReuseKey()
+{
+    if (!gParams.loadEngine.empty())
+    {
+        return "plan:" + gParams.loadEngine + ":" + std::to_string(gParams.useDLACore);
+    }
+    // A run that saves its engine gets one of its own, so that the plan is written.
+    return engineCacheKey() + (gParams.saveEngine.empty() ? "" : ":" + gParams.saveEngine);
+}
+
+//!
+//! \brief Benchmark every run of the --manifest file in this process and print a combined summary.
+//!
+//! \details The options of a run are applied on top of those of the command line. All runs are parsed and validated
+//!          before the first one starts. Runs that describe the same engine share it: it is built or loaded once and
+//!          destroyed after its last run. Metrics and parameters of each run are exported with the run name as prefix.
+//!          A failed run does not stop the following ones, but fails the test.
+//!
+static bool runManifest(ParsersUsed& parsers)
+{
+    std::vector<samplesCommon::ManifestRun> runs;
+    std::string error;
+    if (!samplesCommon::loadRunManifest(gParams.manifest, runs, error))
+    {
+        gLogError << "--manifest: " << error << std::endl;
+        return false;
+    }
+
+    const Params baseline = gParams;
+    const char* perProcessOptions[] = {"manifest", "exportTimes", "device", "verbose", "help", "batchSweep", "exportSweep", "processes"};
+    std::vector<Params> params;
+    std::vector<std::string> keys;
+    for (const auto& run : runs)
+    {
+        gParams = baseline;
+        gParams.manifest.clear();
+        std::vector<char*> argv{const_cast<char*>(gSampleName.c_str())};
+        for (const auto& arg : run.args)
         {
-            continue;
+            for (const char* option : perProcessOptions)
+            {
+                const size_t n = strlen(option);
+                if (!arg.compare(2, n, option) && (arg.size() == n + 2 || arg[n + 2] == '='))
+                {
+                    gLogError << "--manifest: run " << run.name << ": --" << option << " applies to the whole process and can only be given on the command line" << std::endl;
+                    return false;
+                }
+            }
+            argv.push_back(const_cast<char*>(arg.c_str()));
         }
+        gLogInfo << "Run " << run.name << ":" << std::endl;
+        if (!parseArgs(static_cast<int>(argv.size()), argv.data()))
+        {
+            gLogError << "--manifest: invalid options in run " << run.name << std::endl;
+            return false;
+        }
+        if (gParams.loadEngine.empty() && gParams.deployFile.empty() && gParams.uffFile.empty() && gParams.onnxModelFile.empty())
+        {
+            gLogError << "--manifest: run " << run.name << " has no model or engine" << std::endl;
+            return false;
+        }
+        params.push_back(gParams);
+        keys.push_back(engineReuseKey());
+        parsers.add(gParams);
+    }
 
-        if (parseString(argv[j], "calib", gParams.calibrationCache))
-            continue;
-
-        std::string input;
-        if (parseString(argv[j], "input", input))
+    struct RunResult
+    {
+        bool pass{false};
+        bool reused{false};
+        RunSummary summary;
+    };
+    std::vector<RunResult> results(runs.size());
+    std::map<std::string, ICudaEngine*> engines;
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        gLogInfo << "Starting run " << runs[i].name << " (" << i + 1 << " of " << runs.size() << ")" << std::endl;
+        gParams = params[i];
+        gInputDimensions.clear();
+        if (gResults)
         {
-            gLogWarning << "--input has been deprecated and ignored." << std::endl;
-            continue;
+            gResults->setMetricPrefix(runs[i].name + ".");
         }
 
-        std::string output;
-        if (parseString(argv[j], "output", output))
+        ICudaEngine*& engine = engines[keys[i]];
+        results[i].reused = engine != nullptr;
+        if (results[i].reused)
         {
-            gParams.outputs.push_back(output);
-            continue;
+            gLogInfo << "Reusing the engine of an earlier run" << std::endl;
+        }
+        else
+        {
+            engine = createEngine();
+        }
+        if (engine)
+        {
+            results[i].pass = benchmarkEngine(*engine, &results[i].summary, runs[i].name + ".");
+        }
+        else
+        {
+            gLogError << "Engine could not be created" << std::endl;
         }
 
-        std::string uffInput;
-        if (parseString(argv[j], "uffInput", uffInput))
+        if (engine && std::find(keys.begin() + i + 1, keys.end(), keys[i]) == keys.end())
         {
-            std::vector<std::string> uffInputStrs = split(uffInput, ',');
-            if (uffInputStrs.size() != 4)
-            {
-                gLogError << "Invalid uffInput: " << uffInput << std::endl;
-                return false;
-            }
+            engine->destroy();
+            engine = nullptr;
+        }
+    }
+    gParams = baseline;
+    if (gResults)
+    {
+        gResults->setMetricPrefix("");
+    }
 
-            gParams.uffInputs.push_back(std::make_pair(uffInputStrs[0], Dims3(atoi(uffInputStrs[1].c_str()), atoi(uffInputStrs[2].c_str()), atoi(uffInputStrs[3].c_str()))));
-            continue;
+    gLogInfo << "Manifest summary (host walltime; - where the run mode reports no closed-loop summary):" << std::endl;
+    gLogInfo << std::left << std::setw(24) << "run" << std::right << std::setw(8) << "status" << std::setw(8) << "engine"
+             << std::setw(12) << "p50 (ms)" << std::setw(12) << "p99 (ms)" << std::setw(14) << "images/s" << std::endl;
+    bool pass{true};
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        const RunSummary& summary = results[i].summary;
+        std::ostringstream line;
+        line << std::left << std::setw(24) << runs[i].name << std::right << std::setw(8) << (results[i].pass ? "pass" : "FAIL")
+             << std::setw(8) << (results[i].reused ? "reused" : "new");
+        if (summary.latency.count() > 0)
+        {
+            line << std::setw(12) << summary.latency.percentile(50) << std::setw(12) << summary.latency.percentile(99)
+                 << std::setw(14) << summary.inferencesPerSecond * params[i].batchSize;
+        }
+        else
+        {
+            line << std::setw(12) << "-" << std::setw(12) << "-" << std::setw(14) << "-";
         }
+        gLogInfo << line.str() << std::endl;
+        pass = pass && results[i].pass;
+    }
+    return pass;
+}
 
-        if (parseInt(argv[j], "batch", gParams.batchSize)
-            || parseInt(argv[j], "iterations", gParams.iterations)
-            || parseInt(argv[j], "avgRuns", gParams.avgRuns)
-            || parseInt(argv[j], "device", gParams.device)
-            || parseInt(argv[j], "workspace", gParams.workspaceSize)
-            || parseInt(argv[j], "useDLACore", gParams.useDLACore))
-            continue;
+//!
+//! \brief Shut protobuf down once no parser is needed any more. It is left running when an ONNX model was parsed.
+//!
+static void shutdownParsers(const ParsersUsed& parsers)
+{
+    if (!parsers.uff && !parsers.onnx)
+    {
+        nvcaffeparser1::shutdownProtobufLibrary();
+    }
+    else if (!parsers.caffe && !parsers.onnx)
+    {
+        nvuffparser::shutdownProtobufLibrary();
+    }
+}
 
-        if (parseFloat(argv[j], "percentile", gParams.pct))
-            continue;
+static void initDevice()
+{
+    cudaSetDevice(gParams.device);
 
-        if (parseBool(argv[j], "safe", gParams.safeMode)
-            || parseBool(argv[j], "fp16", gParams.fp16)
-            || parseBool(argv[j], "int8", gParams.int8)
-            || parseBool(argv[j], "verbose", gParams.verbose)
-            || parseBool(argv[j], "allowGPUFallback", gParams.allowGPUFallback)
-            || parseBool(argv[j], "useSpinWait", gParams.useSpinWait)
-            || parseBool(argv[j], "dumpOutput", gParams.dumpOutput)
-            || parseBool(argv[j], "help", gParams.help, 'h'))
-            continue;
+    initLibNvInferPlugins(&gLogger.getTRTLogger(), "");
+}
 
-        gLogError << "Unknown argument: " << argv[j] << std::endl;
-        return false;
+//!
+//! \brief Semaphores, plan and results shared by the parent and the children of a --processes run.
+//!
+struct ProcessShared
+{
+    ProcessShared(int nbProcesses)
+        : tag(std::to_string(getpid()))
+        , engineReady("/trtexec.engine." + tag)
+        , childReady("/trtexec.ready." + tag)
+        , start("/trtexec.start." + tag)
+        , plan("/trtexec.plan." + tag)
+        , results(nbProcesses)
+        , planSize(1)
+    {
+        engineReady.open();
+        childReady.open();
+        start.open();
     }
 
-    return validateArgs();
-}
+    std::string tag;
+    samplesCommon::Semaphore engineReady; //!< Posted once per child when the plan is published, or the build failed
+    samplesCommon::Semaphore childReady;  //!< Posted by each child when it is warmed up or has failed
+    samplesCommon::Semaphore start;       //!< Posted once per child to start the measurement in all of them at once
+    samplesCommon::SharedMemory plan;
+    samplesCommon::SharedArray<samplesCommon::ProcessResult> results;
+    samplesCommon::SharedArray<size_t> planSize; //!< 0 if the parent could not build the engine
+};
 
-static ICudaEngine* createEngine()
+//!
+//! \brief Body of --processes child index: load the published plan, warm up, run the measured inferences when the
+//!        parent says so and report the statistics in the shared results.
+//!
+static bool runChildProcess(ProcessShared& shared, int index)
 {
-    ICudaEngine* engine;
-    // load directly from serialized engine file if deploy not specified
-    if (!gParams.loadEngine.empty())
+    samplesCommon::ProcessResult& result = shared.results[index];
+    auto fail = [&]() {
+        result.state = samplesCommon::ProcessResult::kFAILED;
+        shared.childReady.post();
+        return false;
+    };
+
+    shared.engineReady.wait();
+    const size_t planSize = shared.planSize[0];
+    if (planSize == 0)
+    {
+        return fail();
+    }
+    initDevice();
+
+    auto tStart = std::chrono::high_resolution_clock::now();
+    void* plan{MAP_FAILED};
+    try
+    {
+        int fd = shared.plan.open_ro();
+        plan = mmap(nullptr, planSize, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+    }
+    catch (const std::runtime_error& e)
+    {
+        gLogError << e.what() << std::endl;
+    }
+    if (plan == MAP_FAILED)
+    {
+        gLogError << "Process " << index << " could not map the engine" << std::endl;
+        return fail();
+    }
+    float mapMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+    ICudaEngine* engine = deserializeEngine(plan, planSize, mapMs);
+    munmap(plan, planSize);
+    if (!engine || !loadInputDatasets(*engine))
+    {
+        gLogError << "Process " << index << " could not load the engine" << std::endl;
+        return fail();
+    }
+
+    bool pass{true};
     {
-        std::vector<char> trtModelStream;
-        size_t size{0};
-        std::ifstream file(gParams.loadEngine, std::ios::binary);
-        if (file.good())
+        // The contexts have to be destroyed before the engine.
+        std::vector<std::unique_ptr<TrtInferenceStream>> streams;
+        std::vector<samplesCommon::IInferenceStream*> inferenceStreams;
+        for (int s = 0; s < gParams.streams; s++)
         {
-            file.seekg(0, file.end);
-            size = file.tellg();
-            file.seekg(0, file.beg);
-            trtModelStream.resize(size);
-            file.read(trtModelStream.data(), size);
-            file.close();
+            streams.emplace_back(new TrtInferenceStream(*engine));
+            inferenceStreams.push_back(streams.back().get());
         }
-
-        IRuntime* infer = createInferRuntime(gLogger.getTRTLogger());
-        if (gParams.useDLACore >= 0)
+        for (auto& stream : streams)
         {
-            infer->setDLACore(gParams.useDLACore);
+            pass = pass && warmUp(*stream);
         }
 
-        engine = infer->deserializeCudaEngine(trtModelStream.data(), size, nullptr);
-        gLogInfo << gParams.loadEngine << " has been successfully loaded." << std::endl;
-
-        infer->destroy();
-        return engine;
+        if (pass)
+        {
+            result.state = samplesCommon::ProcessResult::kREADY;
+            shared.childReady.post();
+            shared.start.wait();
+
+            samplesCommon::MultiStreamRunner runner(inferenceStreams);
+            pass = runner.run(gParams.iterations * gParams.avgRuns);
+            result.stats = runner.getAggregateStats();
+            result.wallMs = runner.getWallMs();
+            result.state = pass ? samplesCommon::ProcessResult::kDONE : samplesCommon::ProcessResult::kFAILED;
+        }
     }
+    engine->destroy();
+    return pass || fail();
+}
 
-    if ((!gParams.deployFile.empty()) || (!gParams.uffFile.empty()) || (!gParams.onnxModelFile.empty()))
+//!
+//! \brief Fork --processes children that each run the engine, built once by the parent and published through shared
+//!        memory, and report their latency histograms back through a shared results area to be merged.
+//!
+//! \details The children are forked before this process initializes CUDA, since a CUDA context does not survive
+//!          fork(). All children warm up first and then measure iterations * avgRuns inferences per stream together,
+//!          so that the numbers reflect the GPU shared by every process.
+//!
+static bool runProcesses()
+{
+    const int nbProcesses = gParams.processes;
+    // The named semaphores and shared memory may be unavailable, e.g. without a writable /dev/shm.
+    std::unique_ptr<ProcessShared> sharedPtr;
+    try
     {
-
-        if (!gParams.uffFile.empty())
+        sharedPtr.reset(new ProcessShared(nbProcesses));
+    }
+    catch (const std::runtime_error& e)
+    {
+        gLogError << "--processes: " << e.what() << std::endl;
+        return false;
+    }
+    ProcessShared& shared = *sharedPtr;
+    samplesCommon::ProcessGroup children;
+    const bool forked = children.spawn(nbProcesses, [&shared](int index) { return runChildProcess(shared, index); });
+    const int nbChildren = static_cast<int>(children.size());
+
+    initDevice();
+    ICudaEngine* engine = forked ? createEngine() : nullptr;
+    IHostMemory* plan = engine ? engine->serialize() : nullptr;
+    if (plan)
+    {
+        void* data{MAP_FAILED};
+        try
         {
-            engine = uffToTRTModel();
+            int fd = shared.plan.open_rw();
+            data = ftruncate(fd, plan->size()) == 0 ? mmap(nullptr, plan->size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+            close(fd);
         }
-        else if (!gParams.onnxModelFile.empty())
+        catch (const std::runtime_error& e)
         {
-            engine = onnxToTRTModel();
+            // The children are still released below and fail on the empty plan.
+            gLogError << e.what() << std::endl;
         }
-        else
+        if (data != MAP_FAILED)
         {
-            engine = caffeToTRTModel();
+            std::memcpy(data, plan->data(), plan->size());
+            munmap(data, plan->size());
+            shared.planSize[0] = plan->size();
         }
+        plan->destroy();
+    }
+    if (shared.planSize[0] == 0)
+    {
+        gLogError << (forked ? "Engine could not be created or published" : "Could not fork the benchmark processes") << std::endl;
+    }
+    if (engine && gResults)
+    {
+        setResultParameters(*engine, "");
+        gResults->setParameter("processes", nbProcesses);
+    }
+    if (engine)
+    {
+        engine->destroy();
+    }
+    for (int i = 0; i < nbChildren; i++)
+    {
+        shared.engineReady.post();
+    }
 
-        if (!engine)
+    // Wait until every child is warmed up, has failed or has died, then start them together.
+    auto settled = [&]() {
+        children.poll();
+        for (int i = 0; i < nbChildren; i++)
         {
-            gLogError << "Engine could not be created" << std::endl;
-            return nullptr;
+            if (shared.results[i].state == samplesCommon::ProcessResult::kSTARTING && children.isRunning(i))
+                return false;
         }
+        return true;
+    };
+    while (!settled())
+    {
+        shared.childReady.waitFor(100);
+    }
+    for (int i = 0; i < nbChildren; i++)
+    {
+        shared.start.post();
+    }
+    const int failed = children.waitAll();
 
-        if (!gParams.saveEngine.empty())
+    samplesCommon::StreamStats total;
+    double inferencesPerSecond{0};
+    const int done = samplesCommon::mergeProcessResults(shared.results, total, inferencesPerSecond);
+    for (int i = 0; i < nbChildren; i++)
+    {
+        const samplesCommon::ProcessResult& r = shared.results[i];
+        if (r.state != samplesCommon::ProcessResult::kDONE)
         {
-            std::ofstream p(gParams.saveEngine, std::ios::binary);
-            if (!p)
-            {
-                gLogError << "could not open plan output file" << std::endl;
-                return nullptr;
-            }
-            IHostMemory* ptr = engine->serialize();
-            if (ptr == nullptr)
-            {
-                gLogError << "could not serialize engine." << std::endl;
-                return nullptr;
-            }
-            p.write(reinterpret_cast<const char*>(ptr->data()), ptr->size());
-            ptr->destroy();
-            gLogInfo << "Engine has been successfully saved to " << gParams.saveEngine << std::endl;
+            gLogError << "Process " << i << " failed" << std::endl;
+            continue;
+        }
+        gLogInfo << "Process " << i << ": " << r.stats.inferences << " inferences in " << r.wallMs << " ms ("
+                 << r.stats.inferences * 1000.0 / r.wallMs << " inferences/s), host walltime p50 = "
+                 << r.stats.host.percentile(50) << " ms, p99 = " << r.stats.host.percentile(99) << " ms" << std::endl;
+        if (gResults)
+        {
+            gResults->addSummary("process" + std::to_string(i) + ".gpuCompute", r.stats.gpu);
+            gResults->addSummary("process" + std::to_string(i) + ".hostWalltime", r.stats.host);
         }
-        return engine;
     }
-
-    // complain about empty deploy file
-    gLogError << "Deploy file not specified" << std::endl;
-    return nullptr;
+    gLogInfo << "All processes GPU compute: " << total.gpu << std::endl;
+    gLogInfo << "All processes host walltime: " << total.host << std::endl;
+    gLogInfo << "Throughput: " << inferencesPerSecond << " inferences/s, " << inferencesPerSecond * gParams.batchSize
+             << " images/s over " << done << " processes with " << gParams.streams << " streams each." << std::endl;
+    if (gResults)
+    {
+        gResults->addSummary("gpuCompute", total.gpu);
+        gResults->addSummary("hostWalltime", total.host);
+        gResults->addSample("images/s", "images/s", inferencesPerSecond * gParams.batchSize);
+    }
+    return forked && failed == 0 && done == nbProcesses;
 }
 
 int main(int argc, char** argv)
@@ -786,28 +2678,57 @@ int main(int argc, char** argv)
         setReportableSeverity(Severity::kVERBOSE);
     }
 
-    cudaSetDevice(gParams.device);
-
-    initLibNvInferPlugins(&gLogger.getTRTLogger(), "");
-
-    ICudaEngine* engine = createEngine();
-    if (!engine)
+    if (!gParams.exportTimes.empty())
     {
-        gLogError << "Engine could not be created" << std::endl;
-        return gLogger.reportFail(sampleTest);
+        gResults.reset(new samplesCommon::BenchmarkResults(gSampleName));
     }
 
-    if (gParams.uffFile.empty() && gParams.onnxModelFile.empty())
+    bool pass{false};
+    ParsersUsed parsers;
+    parsers.add(gParams);
+    if (gParams.processes > 1)
     {
-        nvcaffeparser1::shutdownProtobufLibrary();
+        // Forks before CUDA is initialized and initializes it in each process.
+        pass = runProcesses();
     }
-    else if (gParams.deployFile.empty() && gParams.onnxModelFile.empty())
+    else if (!gParams.manifest.empty())
     {
-        nvuffparser::shutdownProtobufLibrary();
+        initDevice();
+        pass = runManifest(parsers);
+    }
+    else if (!gParams.batchSweep.empty())
+    {
+        initDevice();
+        pass = runBatchSweep();
+    }
+    else
+    {
+        initDevice();
+        ICudaEngine* engine = createEngine();
+        if (!engine)
+        {
+            gLogError << "Engine could not be created" << std::endl;
+            return gLogger.reportFail(sampleTest);
+        }
+        pass = benchmarkEngine(*engine);
+        engine->destroy();
     }
 
-    doInference(*engine);
-    engine->destroy();
+    // The parsers cannot be used again once protobuf is shut down, so this waits until every engine is built.
+    shutdownParsers(parsers);
+    if (hostMemoryType() == samplesCommon::HostMemoryType::kPOOLED)
+    {
+        gLogVerbose << "Host buffer pool: " << samplesCommon::HostMemoryPool::instance().getStats() << std::endl;
+    }
+
+    if (pass && gResults)
+    {
+        pass = gResults->write(gParams.exportTimes);
+        if (pass)
+            gLogInfo << "Timings have been exported to " << gParams.exportTimes << std::endl;
+        else
+            gLogError << "Could not write timings to " << gParams.exportTimes << std::endl;
+    }
 
-    return gLogger.reportPass(sampleTest);
+    return gLogger.reportTest(sampleTest, pass);
 }